@@ -3,5 +3,7 @@
 
 #include "roll_vec.h"
 #include "roll_mat.h"
+#include "roll_kernel.h"
+#include "roll_state.h"
 
 #endif
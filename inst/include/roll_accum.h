@@ -0,0 +1,187 @@
+#ifndef ROLL_ACCUM_H
+#define ROLL_ACCUM_H
+
+#include <RcppArmadillo.h>
+
+namespace roll {
+
+// exact weighted sums of the window from 'begin_row' to 'end_row' (inclusive)
+// of 'x' and 'y' (i.e., the same column for univariate statistics), where the
+// weight of each row is by age, 'any_na' is null if there are no missing rows,
+// and the sums of squares are about the means if 'center' (otherwise zero),
+// i.e., to re-anchor the running sums of an online algorithm in O(width)
+struct RollReanchor {
+  
+  int n_obs;
+  long double sum_w;
+  long double sum_x;
+  long double sum_y;
+  long double sumsq_w;
+  long double sumsq_x;
+  long double sumsq_y;
+  long double sumsq_xy;
+  long double mean_x;
+  long double mean_y;
+  
+  RollReanchor(const double* x, const double* y,
+               const arma::uword* any_na, const int begin_row,
+               const int end_row, const int n,
+               const arma::vec& arma_weights, const bool center)
+    : n_obs(0), sum_w(0), sum_x(0), sum_y(0),
+      sumsq_w(0), sumsq_x(0), sumsq_y(0), sumsq_xy(0),
+      mean_x(0), mean_y(0) {
+    
+    for (int i = begin_row; i <= end_row; i++) {
+      
+      if (((any_na == NULL) || (any_na[i] == 0)) &&
+          !std::isnan(x[i]) && !std::isnan(y[i])) {
+        
+        long double w = arma_weights[n - 1 - (end_row - i)];
+        
+        n_obs += 1;
+        sum_w += w;
+        sum_x += w * x[i];
+        sum_y += w * y[i];
+        sumsq_w += w * w;
+        
+      }
+      
+    }
+    
+    if (center && (n_obs > 0)) {
+      
+      mean_x = sum_x / sum_w;
+      mean_y = sum_y / sum_w;
+      
+    }
+    
+    // compute the sum of squares about the means (i.e., two passes)
+    for (int i = begin_row; i <= end_row; i++) {
+      
+      if (((any_na == NULL) || (any_na[i] == 0)) &&
+          !std::isnan(x[i]) && !std::isnan(y[i])) {
+        
+        long double w = arma_weights[n - 1 - (end_row - i)];
+        
+        sumsq_x += w * (x[i] - mean_x) * (x[i] - mean_x);
+        sumsq_y += w * (y[i] - mean_y) * (y[i] - mean_y);
+        sumsq_xy += w * (x[i] - mean_x) * (y[i] - mean_y);
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// accumulators of the running sums by the 'precision' argument, i.e., the
+// extended precision of 'long double' (x87 arithmetic on x86-64), 'double'
+// with the compensation of each addition (see Neumaier, 1974) and of each
+// scale by a fused multiply-add, or 'double' only, where 'value_type' is the
+// type of the weights and observations in the recurrences
+struct RollAccumLongDouble {
+  
+  typedef long double value_type;
+  
+  long double sum;
+  
+  RollAccumLongDouble() : sum(0) { }
+  
+  void set(const long double value) {
+    sum = value;
+  }
+  
+  void scale(const value_type lambda) {
+    sum *= lambda;
+  }
+  
+  void add(const value_type value) {
+    sum += value;
+  }
+  
+  value_type value() const {
+    return sum;
+  }
+  
+};
+
+struct RollAccumCompensated {
+  
+  typedef double value_type;
+  
+  double sum;
+  double comp;
+  
+  RollAccumCompensated() : sum(0), comp(0) { }
+  
+  // the remainder of an exact sum is kept in the compensation
+  void set(const long double value) {
+    
+    sum = value;
+    comp = value - sum;
+    
+  }
+  
+  void scale(const value_type lambda) {
+    
+    if (lambda != 1) {
+      
+      double product = sum * lambda;
+      
+      comp = comp * lambda + std::fma(sum, lambda, -product);
+      sum = product;
+      
+    }
+    
+  }
+  
+  void add(const value_type value) {
+    
+    double total = sum + value;
+    
+    if (std::abs(sum) >= std::abs(value)) {
+      comp += (sum - total) + value;
+    } else {
+      comp += (value - total) + sum;
+    }
+    
+    sum = total;
+    
+  }
+  
+  value_type value() const {
+    return sum + comp;
+  }
+  
+};
+
+struct RollAccumDouble {
+  
+  typedef double value_type;
+  
+  double sum;
+  
+  RollAccumDouble() : sum(0) { }
+  
+  void set(const long double value) {
+    sum = value;
+  }
+  
+  void scale(const value_type lambda) {
+    sum *= lambda;
+  }
+  
+  void add(const value_type value) {
+    sum += value;
+  }
+  
+  value_type value() const {
+    return sum;
+  }
+  
+};
+
+}
+
+#endif
@@ -0,0 +1,835 @@
+#ifndef ROLL_KERNEL_H
+#define ROLL_KERNEL_H
+
+#define ARMA_WARN_LEVEL 0
+
+#include <RcppArmadillo.h>
+#include <RcppParallel.h>
+#include "roll_order.h"
+using namespace Rcpp;
+using namespace RcppParallel;
+
+// rolling and expanding statistics from a user-defined 'Kernel' that is
+// default constructible (i.e., an empty window) with the following members:
+//
+//   void add(const double x, const long double weight);
+//   void remove(const double x, const long double weight);
+//   void scale(const long double lambda);
+//   double value() const;
+//
+// where 'add' and 'remove' are for an observation that enters and leaves the
+// window, respectively, with its current weight and 'scale' multiplies all
+// weights in the window by 'lambda' (i.e., exponential decay 'weights'), then
+// 'roll::roll_kernel<Kernel>' has the same arguments and returns the same
+// matrix, vector, or xts object as 'roll_sum', for example:
+//
+//   struct SumKernel {
+//     long double sum_x = 0;
+//     void add(const double x, const long double weight) { sum_x += weight * x; }
+//     void remove(const double x, const long double weight) { sum_x -= weight * x; }
+//     void scale(const long double lambda) { sum_x *= lambda; }
+//     double value() const { return sum_x; }
+//   };
+//
+// otherwise, if 'Kernel' has no 'remove' and 'scale' (e.g., maximums), then
+// 'roll::roll_kernel_combine<Kernel>' uses a queue of two stacks instead with
+//
+//   static Kernel combine(const Kernel& a, const Kernel& b);
+//
+// that is an associative merge of the rows in 'a' followed by the rows in 'b'
+// (i.e., online for equal 'weights' only), and each window is recomputed from
+// 'add' and 'value' if 'online' is FALSE or 'weights' are arbitrary, where
+// exponential decay 'weights' are also recomputed for each window with a
+// warning if 'online' is TRUE
+namespace roll {
+
+inline void check_width(const int& width) {
+  
+  if (width < 1) {
+    stop("value of 'width' must be greater than zero");
+  }
+  
+}
+
+inline void check_weights_x(const int& n_rows_x, const int& width,
+                            const arma::vec& weights) {
+  
+  if ((int)weights.size() < std::min(width, n_rows_x)) {
+    stop("length of 'weights' must equal either the number of rows in 'x' or 'width'");
+  }
+  
+}
+
+// check if linear decay 'weights' (i.e., constant difference), where the
+// tolerance is relative to the largest weight for consistency with R's all.equal
+inline bool check_linear(const arma::vec& weights) {
+  
+  int n = weights.size();
+  bool status_lin = (n > 1) && !all(weights == weights[0]);
+  long double delta = 0;
+  long double tol = 0;
+  
+  if (status_lin) {
+    
+    delta = weights[n - 1] - weights[n - 2];
+    
+    for (int i = 0; i < n; i++) {
+      tol = std::max(tol, (long double)std::abs(weights[i]));
+    }
+    
+    tol *= sqrt(arma::datum::eps);
+    
+  }
+  
+  // check if constant difference
+  for (int i = 0; status_lin && (i <= (n - 2)); i++) {
+    
+    long double delta_i = weights[n - i - 1] - weights[n - i - 2];
+    
+    if (std::isnan(delta_i) || std::isinf(delta_i) ||
+        (std::abs(delta_i - delta) > tol)) {
+      
+      status_lin = false;
+      
+    }
+    
+  }
+  
+  return status_lin;
+  
+}
+
+// 'linear' is TRUE if the online algorithm also supports linear decay 'weights'
+inline bool check_lambda(const arma::vec& weights, const int& n_rows_x,
+                         const int& width, const bool& online,
+                         const bool& linear = false) {
+  
+  // check if equal-weights
+  bool status_eq = all(weights == weights[0]);
+  bool status_exp = true;
+  
+  // check if exponential-weights
+  if (!status_eq) {
+    
+    int i = 0;
+    int n = weights.size();
+    long double lambda = 0;
+    long double lambda_prev = 0;
+    
+    // check if constant ratio
+    while (status_exp && (i <= (n - 2))) {
+      
+      // ratio of weights
+      lambda_prev = lambda;
+      lambda = weights[n - i - 2] / weights[n - i - 1];
+      
+      // tolerance for consistency with R's all.equal
+      if (((i > 0) && (std::abs(lambda - lambda_prev) > sqrt(arma::datum::eps))) ||
+          ((weights[n - i - 2] > weights[n - i - 1]) && (width < n_rows_x)) ||
+          (std::isnan(lambda) || (std::isinf(lambda)))) {
+        
+        status_exp = false;
+        
+      }
+      
+      i += 1;
+      
+    }
+    
+  }
+  
+  // check if linear-weights
+  bool status_lin = !status_exp && linear && check_linear(weights);
+  
+  if (!status_exp && !status_lin && online && linear) {
+    warning("'online' is only supported for equal, exponential decay, or linear decay 'weights'");
+  } else if (!status_exp && !status_lin && online) {
+    warning("'online' is only supported for equal or exponential decay 'weights'");
+  }
+  
+  return status_exp || status_lin;
+  
+}
+
+inline void check_min_obs(const int& min_obs) {
+  
+  if (min_obs < 1) {
+    stop("value of 'min_obs' must be greater than zero");
+  }
+  
+}
+
+inline arma::uvec any_na_x(const NumericMatrix& x) {
+  
+  int n_rows_x = x.nrow();
+  int n_cols_x = x.ncol();
+  arma::uvec result(n_rows_x);
+  
+  for (int i = 0; i < n_rows_x; i++) {
+    
+    int any_na = 0;
+    int j = 0;
+    
+    while ((any_na == 0) && (j < n_cols_x)) {
+      if (std::isnan(x(i, j))) {
+        any_na = 1;
+      }
+      j += 1;
+    }
+    
+    result[i] = any_na;
+    
+  }
+  
+  return result;
+  
+}
+
+// 'Kernel' as the monoid of a queue of two stacks
+template <typename Kernel>
+struct RollKernelMonoid {
+  
+  typedef Kernel value_type;
+  
+  static value_type combine(const value_type& a, const value_type& b) {
+    return Kernel::combine(a, b);
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelOnlineMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const arma::uvec arma_any_na,
+                      const bool na_restore, arma::mat& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      long double lambda = 0;
+      Kernel kernel;
+      
+      if ((arma_weights[n - 1] == 0) || (width == 1)) {
+        lambda = 1;
+      } else {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        if (lambda != 1) {
+          kernel.scale(lambda);
+        }
+        
+        // rolling window
+        if (i >= width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+            
+            kernel.remove(x(i - width, j), lambda * arma_weights[n - width]);
+            n_obs -= 1;
+            
+          }
+          
+        }
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          kernel.add(x(i, j), arma_weights[n - 1]);
+          n_obs += 1;
+          
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (n_obs >= min_obs) {
+            arma_value(i, j) = kernel.value();
+          } else {
+            arma_value(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_value(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelStacksMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelStacksMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const arma::uvec arma_any_na,
+                      const bool na_restore, arma::mat& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      RollTwoStacks<RollKernelMonoid<Kernel> > stacks(std::min(width, n_rows_x));
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // rolling window
+        if ((i >= width) && !stacks.empty() && (stacks.row() <= i - width)) {
+          
+          stacks.pop_front();
+          n_obs -= 1;
+          
+        }
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          Kernel kernel;
+          kernel.add(x(i, j), arma_weights[n - 1]);
+          
+          stacks.push_back(kernel, i);
+          n_obs += 1;
+          
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (n_obs >= min_obs) {
+            arma_value(i, j) = stacks.query().value();
+          } else {
+            arma_value(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_value(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelOfflineMat(const NumericMatrix x, const int n,
+                       const int n_rows_x, const int n_cols_x,
+                       const int width, const arma::vec arma_weights,
+                       const int min_obs, const arma::uvec arma_any_na,
+                       const bool na_restore, arma::mat& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      int n_obs = 0;
+      Kernel kernel;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row, and
+        // the observations are added from the oldest to the newest
+        for (int count = std::min(width, i + 1) - 1; count >= 0; count--) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
+            
+            kernel.add(x(i - count, j), arma_weights[n - count - 1]);
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          arma_value(i, j) = kernel.value();
+        } else {
+          arma_value(i, j) = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_value(i, j) = x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelOnlineVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, arma::vec& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by row
+  void operator()() {
+    
+    int n_obs = 0;
+    long double lambda = 0;
+    Kernel kernel;
+    
+    if ((arma_weights[n - 1] == 0) || (width == 1)) {
+      lambda = 1;
+    } else {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      if (lambda != 1) {
+        kernel.scale(lambda);
+      }
+      
+      // rolling window
+      if (i >= width) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i - width])) {
+          
+          kernel.remove(x[i - width], lambda * arma_weights[n - width]);
+          n_obs -= 1;
+          
+        }
+        
+      }
+      
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        
+        kernel.add(x[i], arma_weights[n - 1]);
+        n_obs += 1;
+        
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (n_obs >= min_obs) {
+          arma_value[i] = kernel.value();
+        } else {
+          arma_value[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_value[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelStacksVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelStacksVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, arma::vec& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by row
+  void operator()() {
+    
+    int n_obs = 0;
+    RollTwoStacks<RollKernelMonoid<Kernel> > stacks(std::min(width, n_rows_x));
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // rolling window
+      if ((i >= width) && !stacks.empty() && (stacks.row() <= i - width)) {
+        
+        stacks.pop_front();
+        n_obs -= 1;
+        
+      }
+      
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        
+        Kernel kernel;
+        kernel.add(x[i], arma_weights[n - 1]);
+        
+        stacks.push_back(kernel, i);
+        n_obs += 1;
+        
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (n_obs >= min_obs) {
+          arma_value[i] = stacks.query().value();
+        } else {
+          arma_value[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_value[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+template <typename Kernel>
+struct RollKernelOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_value;        // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollKernelOfflineVec(const NumericVector x, const int n,
+                       const int n_rows_x, const int width,
+                       const arma::vec arma_weights, const int min_obs,
+                       const bool na_restore, arma::vec& arma_value)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), arma_value(arma_value) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t i = begin_index; i < end_index; i++) {
+      
+      int n_obs = 0;
+      Kernel kernel;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row, and
+        // the observations are added from the oldest to the newest
+        for (int count = std::min(width, (int)i + 1) - 1; count >= 0; count--) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i - count])) {
+            
+            kernel.add(x[i - count], arma_weights[n - count - 1]);
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          arma_value[i] = kernel.value();
+        } else {
+          arma_value[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_value[i] = x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// checks the arguments, allocates the output, and dispatches to 'OnlineMat'
+// or 'OnlineVec' if 'status', otherwise each window is recomputed
+template <typename Kernel, typename OnlineMat, typename OnlineVec>
+inline SEXP roll_kernel_z(const SEXP& x, const int& width,
+                          const arma::vec& weights, const int& min_obs,
+                          const bool& complete_obs, const bool& na_restore,
+                          const bool& online, const bool& status_eq) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    arma::mat arma_value(n_rows_x, n_cols_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // 'status_eq' is for kernels that are online for equal-weights only
+    if (status_eq && status && !all(weights == weights[0])) {
+      
+      if (online) {
+        warning("'online' is only supported for equal 'weights' of a combined kernel");
+      }
+      
+      status = false;
+      
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling statistics
+    if (status && online) {
+      
+      OnlineMat roll_kernel_online(xx, n, n_rows_x, n_cols_x, width,
+                                   weights, min_obs,
+                                   arma_any_na, na_restore,
+                                   arma_value);
+      parallelFor(0, n_cols_x, roll_kernel_online);
+      
+    } else {
+      
+      RollKernelOfflineMat<Kernel> roll_kernel_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                       weights, min_obs,
+                                                       arma_any_na, na_restore,
+                                                       arma_value);
+      parallelFor(0, n_rows_x * n_cols_x, roll_kernel_offline);
+      
+    }
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(wrap(arma_value));
+    List dimnames = xx.attr("dimnames");
+    result.attr("dimnames") = dimnames;
+    result.attr("index") = xx.attr("index");
+    result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+    result.attr(".indexTZ") = xx.attr(".indexTZ");
+    result.attr("tclass") = xx.attr("tclass");
+    result.attr("tzone") = xx.attr("tzone");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    arma::vec arma_value(n_rows_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // 'status_eq' is for kernels that are online for equal-weights only
+    if (status_eq && status && !all(weights == weights[0])) {
+      
+      if (online) {
+        warning("'online' is only supported for equal 'weights' of a combined kernel");
+      }
+      
+      status = false;
+      
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling statistics
+    if (status && online) {
+      
+      OnlineVec roll_kernel_online(xx, n, n_rows_x, width,
+                                   weights, min_obs,
+                                   na_restore,
+                                   arma_value);
+      roll_kernel_online();
+      
+    } else {
+      
+      RollKernelOfflineVec<Kernel> roll_kernel_offline(xx, n, n_rows_x, width,
+                                                       weights, min_obs,
+                                                       na_restore,
+                                                       arma_value);
+      parallelFor(0, n_rows_x, roll_kernel_offline);
+      
+    }
+    
+    // create and return a vector object
+    NumericVector result(wrap(arma_value));
+    result.attr("dim") = R_NilValue;
+    List names = xx.attr("names");
+    if (names.size() > 0) {
+      result.attr("names") = names;
+    }
+    result.attr("index") = xx.attr("index");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  }
+  
+}
+
+// rolling statistics from 'add', 'remove', 'scale', and 'value'
+template <typename Kernel>
+inline SEXP roll_kernel(const SEXP& x, const int& width,
+                        const arma::vec& weights, const int& min_obs,
+                        const bool& complete_obs, const bool& na_restore,
+                        const bool& online) {
+  
+  return roll_kernel_z<Kernel, RollKernelOnlineMat<Kernel>, RollKernelOnlineVec<Kernel> >
+    (x, width, weights, min_obs, complete_obs, na_restore, online, false);
+  
+}
+
+// rolling statistics from 'add', 'combine', and 'value'
+template <typename Kernel>
+inline SEXP roll_kernel_combine(const SEXP& x, const int& width,
+                                const arma::vec& weights, const int& min_obs,
+                                const bool& complete_obs, const bool& na_restore,
+                                const bool& online) {
+  
+  return roll_kernel_z<Kernel, RollKernelStacksMat<Kernel>, RollKernelStacksVec<Kernel> >
+    (x, width, weights, min_obs, complete_obs, na_restore, online, true);
+  
+}
+
+}
+
+#endif
@@ -5,6 +5,8 @@
 
 #include <RcppArmadillo.h>
 #include <RcppParallel.h>
+#include "roll_order.h"
+#include "roll_accum.h"
 using namespace Rcpp;
 using namespace RcppParallel;
 
@@ -425,42 +427,59 @@ struct RollAllOfflineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollSumOnlineMat : public Worker {
   
+  typedef typename Accum::value_type value_type;
+  
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
+  const int reanchor;
   arma::mat& arma_sum;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollSumOnlineMat(const NumericMatrix x, const int n,
                    const int n_rows_x, const int n_cols_x,
-                   const int width, const arma::vec arma_weights,
-                   const int min_obs, const arma::uvec arma_any_na,
-                   const bool na_restore, arma::mat& arma_sum)
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   const int reanchor, arma::mat& arma_sum,
+                   arma::vec& arma_reanchor)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_sum(arma_sum) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      reanchor(reanchor), arma_sum(arma_sum),
+      arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
       int n_obs = 0;
-      long double lambda = 0;
-      long double w_new = 0;
-      long double w_old = 0;
-      long double x_new = 0;
-      long double x_old = 0;
-      long double sum_x = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0;
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_x;
       
       if (arma_weights[n - 1] == 0) {
         lambda = 1;
@@ -470,7 +489,7 @@ struct RollSumOnlineMat : public Worker {
         lambda = arma_weights[n - 1];
       }
       
-      for (int i = 0; i < n_rows_x; i++) {
+      for (int i = offset; i < end_row; i++) {
         
         if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
           
@@ -485,7 +504,7 @@ struct RollSumOnlineMat : public Worker {
         }
         
         // expanding window
-        if (i < width) {
+        if (i < offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -494,15 +513,20 @@ struct RollSumOnlineMat : public Worker {
           }
           
           if (width > 1) {
-            sum_x = lambda * sum_x + w_new * x_new;
+            
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            
           } else {
-            sum_x = w_new * x_new;
+            
+            sum_x.set(w_new * x_new);
+            
           }
           
         }
         
         // rolling window
-        if (i >= width) {
+        if (i >= offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -531,18 +555,44 @@ struct RollSumOnlineMat : public Worker {
           }
           
           if (width > 1) {
-            sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
+            
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            
           } else {
-            sum_x = w_new * x_new;
+            
+            sum_x.set(w_new * x_new);
+            
+          }
+          
+        }
+        
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(&x(0, j), &x(0, j), arma_any_na.memptr(),
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, false);
+          
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sum_x.value() - exact.sum_x));
           }
           
+          sum_x.set(exact.sum_x);
+          
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            arma_sum(i, j) = sum_x;
+            arma_sum(i, j) = sum_x.value();
           } else {
             arma_sum(i, j) = NA_REAL;
           }
@@ -562,6 +612,7 @@ struct RollSumOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
+template <typename Accum>
 struct RollSumOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
@@ -597,7 +648,7 @@ struct RollSumOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      long double sum_x = 0;
+      Accum sum_x;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -611,7 +662,7 @@ struct RollSumOfflineMat : public Worker {
           if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
             // compute the sum
-            sum_x += arma_weights[n - count - 1] * x(i - count, j);
+            sum_x.add(arma_weights[n - count - 1] * x(i - count, j));
             n_obs += 1;
             
           }
@@ -621,7 +672,7 @@ struct RollSumOfflineMat : public Worker {
         }
         
         if (n_obs >= min_obs) {
-          arma_sum(i, j) = sum_x;
+          arma_sum(i, j) = sum_x.value();
         } else {
           arma_sum(i, j) = NA_REAL;
         }
@@ -638,200 +689,84 @@ struct RollSumOfflineMat : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollProdOnlineMat : public Worker {
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollSumPrefixMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  arma::mat& arma_prod;         // destination (pass by reference)
+  arma::mat& arma_sum;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollProdOnlineMat(const NumericMatrix x, const int n,
-                    const int n_rows_x, const int n_cols_x,
-                    const int width, const arma::vec arma_weights,
-                    const int min_obs, const arma::uvec arma_any_na,
-                    const bool na_restore, arma::mat& arma_prod)
+  RollSumPrefixMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   arma::mat& arma_sum)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_prod(arma_prod) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_sum(arma_sum) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
       
-      int n_obs = 0;
-      int n_zero = 0;
-      long double lambda = 0;
-      long double n_new = 0;
-      long double n_old = 0;
-      long double n_exp = 0;
-      long double w_new = 0;
-      long double w_old = 0;
-      long double x_new = 0;
-      long double x_old = 0;
-      long double prod_w = 1;
-      long double prod_x = 1;
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
-      if (arma_weights[n - 1] == 0) {
-        lambda = 1;
-      } else if (width > 1) {
-        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-      } else {
-        lambda = arma_weights[n - 1];
-      }
+      long double w = arma_weights[n - 1];
+      long double value[1];
+      long double sum[1];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 1, offset);
       
-      for (int i = 0; i < n_rows_x; i++) {
+      for (int i = offset; i < end_row; i++) {
         
-        // expanding window
-        if (i < width) {
-          
-          // don't include if missing value and 'any_na' argument is 1
-          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            n_obs += 1;
-          }
-          
-          if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
-            
-            n_new = n_obs;
-            w_new = 1;
-            x_new = 1;
-            
-          } else {
-            
-            n_new = n_obs - 1;
-            w_new = arma_weights[n - 1];
-            
-            if (x(i, j) == 0) {
-              
-              x_new = 1;
-              n_zero += 1;
-              
-            } else {
-              x_new = x(i, j);
-            }
-            
-          }
-          
-          if (n_new == 0) {
-            n_exp = 1;
-          } else if (n_new > n_old) {
-            n_exp = n_exp * lambda;
-          } else if (n_new < n_old) {
-            n_exp = n_exp / lambda;
-          }
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
           
-          n_old = n_new;
-          prod_w *= w_new * n_exp;
-          prod_x *= x_new;
+          value[0] = x(i, j);
+          prefix.push_back(i, value);
           
+        } else {
+          prefix.push_back(i, NULL);
         }
         
-        // rolling window
-        if (i >= width) {
-          
-          // don't include if missing value and 'any_na' argument is 1
-          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
-              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
-            
-            n_obs += 1;
-            
-          } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
-            (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
-            
-            n_obs -= 1;
-            
-          }
-          
-          if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
-            
-            n_new = n_obs;
-            w_new = 1;
-            x_new = 1;
-            
-          } else {
-            
-            n_new = n_obs - 1;
-            w_new = arma_weights[n - 1];
-            
-            if (x(i, j) == 0) {
-              
-              x_new = 1;
-              n_zero += 1;
-              
-            } else {
-              x_new = x(i, j);
-            }
-            
-          }
-          
-          if ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j))) {
-            
-            w_old = 1;
-            x_old = 1;
-            
-          } else {
-            
-            if (x(i - width, j) == 0) {
-              
-              x_old = 1;
-              n_zero -= 1;
-              
-            } else {
-              x_old = x(i - width, j);
-            }
-            
-            if (arma_weights[n - width] == 0) {
-              w_old = 1;
-            } else {
-              w_old = arma_weights[n - width];
-            }
-            
-          }
-          
-          if (n_new == 0) {
-            n_exp = 1;
-          } else if (n_new > n_old) {
-            n_exp = n_exp * lambda;
-          } else if (n_new < n_old) {
-            n_exp = n_exp / lambda;
-          }
-          
-          n_old = n_new;
-          prod_w *= w_new * n_exp / w_old;
-          prod_x *= x_new / x_old;
-          
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
+          int n_obs = prefix.window(i, i - width, sum);
+          
           if (n_obs >= min_obs) {
-            
-            if (n_zero == 0) {
-              arma_prod(i, j) = prod_w * prod_x;
-            } else {
-              arma_prod(i, j) = 0;
-            }
-            
+            arma_sum(i, j) = w * sum[0];
           } else {
-            arma_prod(i, j) = NA_REAL;
+            arma_sum(i, j) = NA_REAL;
           }
           
         } else {
           
           // can be either NA or NaN
-          arma_prod(i, j) = x(i, j);
+          arma_sum(i, j) = x(i, j);
           
         }
         
@@ -842,75 +777,90 @@ struct RollProdOnlineMat : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollProdOfflineMat : public Worker {
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollSumLinearMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  arma::mat& arma_prod;         // destination (pass by reference)
+  arma::mat& arma_sum;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollProdOfflineMat(const NumericMatrix x, const int n,
-                     const int n_rows_x, const int n_cols_x,
-                     const int width, const arma::vec arma_weights,
-                     const int min_obs, const arma::uvec arma_any_na,
-                     const bool na_restore, arma::mat& arma_prod)
+  RollSumLinearMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   arma::mat& arma_sum)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_prod(arma_prod) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_sum(arma_sum) { }
   
-  // function call operator that iterates by index
+  // function call operator that iterates by column and chunk of rows
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 2D array
-      int i = z / n_cols_x;
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
       int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
-      int count = 0;
-      int n_obs = 0;
-      long double prod_x = 1;
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double value[1];
+      long double sum[1];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 1, offset,
+                            arma_weights[n - 1], delta);
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+      for (int i = offset; i < end_row; i++) {
         
-        // number of observations is either the window size or,
-        // for partial results, the number of the current row
-        while ((width > count) && (i >= count)) {
-          
-          // don't include if missing value and 'any_na' argument is 1
-          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
-            
-            // compute the product
-            prod_x *= arma_weights[n - count - 1] * x(i - count, j);
-            n_obs += 1;
-            
-          }
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
           
-          count += 1;
+          value[0] = x(i, j);
+          linear.push_back(i, value);
           
-        }
-        
-        if (n_obs >= min_obs) {
-          arma_prod(i, j) = prod_x;
         } else {
-          arma_prod(i, j) = NA_REAL;
+          linear.push_back(i, NULL);
         }
         
-      } else {
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
         
-        // can be either NA or NaN
-        arma_prod(i, j) = x(i, j);
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if (n_obs >= min_obs) {
+            arma_sum(i, j) = sum[0];
+          } else {
+            arma_sum(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sum(i, j) = x(i, j);
+          
+        }
         
       }
       
@@ -919,65 +869,165 @@ struct RollProdOfflineMat : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMeanOnlineMat : public Worker {
+// 'Worker' function for computing the rolling statistic using the fast Fourier
+// transform, i.e., blocks of 'n_fft' rows that overlap by 'width' - 1 rows are
+// multiplied by the transform of the weights (overlap-save)
+struct RollSumFFTMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_fft;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  arma::mat& arma_mean;         // destination (pass by reference)
+  arma::cx_vec arma_weights_fft;
+  arma::mat& arma_sum;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollMeanOnlineMat(const NumericMatrix x, const int n,
-                    const int n_rows_x, const int n_cols_x,
-                    const int width, const arma::vec arma_weights,
-                    const int min_obs, const arma::uvec arma_any_na,
-                    const bool na_restore, arma::mat& arma_mean)
+  RollSumFFTMat(const NumericMatrix x, const int n,
+                const int n_rows_x, const int n_cols_x,
+                const int n_fft, const int width,
+                const arma::vec arma_weights, const int min_obs,
+                const arma::uvec arma_any_na, const bool na_restore,
+                arma::mat& arma_sum)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_mean(arma_mean) { }
+      n_fft(n_fft), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_sum(arma_sum) {
+    
+    // weights by lag (i.e., the current row has the last weight)
+    int n_size_x = std::min(width, n_rows_x);
+    arma::cx_vec arma_lag(n_fft, arma::fill::zeros);
+    
+    for (int count = 0; count < n_size_x; count++) {
+      arma_lag[count] = arma_weights[n - count - 1];
+    }
+    
+    arma_weights_fft = arma::fft(arma_lag);
+    
+  }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and block of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the block of rows),
+      // where each block includes the previous 'width' - 1 rows
+      int n_size_x = std::min(width, n_rows_x);
+      int n_step = n_fft - n_size_x + 1;
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_step;
+      int end_row = std::min(begin_row + n_step, n_rows_x);
+      int offset = begin_row - n_size_x + 1;
       
       int n_obs = 0;
-      long double lambda = 0;
-      long double w_new = 0;
-      long double w_old = 0;
-      long double x_new = 0;
-      long double x_old = 0;
-      long double sum_w = 0;
-      long double sum_x = 0;
+      arma::cx_vec arma_block(n_fft, arma::fill::zeros);
       
-      if (width > 1) {
-        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-      } else {
-        lambda = arma_weights[n - 1];
+      for (int i = std::max(0, offset); i < std::min(offset + n_fft, n_rows_x); i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          arma_block[i - offset] = x(i, j);
+        }
+        
       }
       
-      for (int i = 0; i < n_rows_x; i++) {
+      // number of observations in the window of the previous row
+      for (int i = std::max(0, begin_row - n_size_x); i < begin_row; i++) {
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          n_obs += 1;
+        }
+      }
+      
+      // circular convolution, where the first 'width' - 1 rows wrap around
+      convolve_block(arma_block, arma_weights_fft, arma_weights, n, n_size_x);
+      
+      for (int i = begin_row; i < end_row; i++) {
         
-        if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          n_obs += 1;
+        }
+        
+        if ((i >= n_size_x) && (arma_any_na[i - n_size_x] == 0) &&
+            !std::isnan(x(i - n_size_x, j))) {
+          n_obs -= 1;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
-          w_new = 0;
-          x_new = 0;
+          if (n_obs >= min_obs) {
+            arma_sum(i, j) = std::real(arma_block[i - offset]);
+          } else {
+            arma_sum(i, j) = NA_REAL;
+          }
           
         } else {
           
-          w_new = arma_weights[n - 1];
-          x_new = x(i, j);
+          // can be either NA or NaN
+          arma_sum(i, j) = x(i, j);
           
         }
         
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollProdOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_prod;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollProdOnlineMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int width, const arma::vec arma_weights,
+                    const int min_obs, const arma::uvec arma_any_na,
+                    const bool na_restore, arma::mat& arma_prod)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_prod(arma_prod) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      long double lambda = 0;
+      long double sum_rows = 0;
+      RollTwoStacks<RollProdMonoid> stacks(std::min(width, n_rows_x));
+      
+      if (arma_weights[n - 1] == 0) {
+        lambda = 1;
+      } else if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      } else {
+        lambda = arma_weights[n - 1];
+      }
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
         // expanding window
         if (i < width) {
           
@@ -987,18 +1037,6 @@ struct RollMeanOnlineMat : public Worker {
             n_obs += 1;
           }
           
-          if (width > 1) {
-            
-            sum_w = lambda * sum_w + w_new;
-            sum_x = lambda * sum_x + w_new * x_new;
-            
-          } else {
-            
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            
-          }
-          
         }
         
         // rolling window
@@ -1018,29 +1056,20 @@ struct RollMeanOnlineMat : public Worker {
             
           }
           
-          if ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j))) {
-            
-            w_old = 0;
-            x_old = 0;
-            
-          } else {
+          // at most one row leaves the window
+          if (!stacks.empty() && (stacks.row() <= i - width)) {
             
-            w_old = arma_weights[n - width];
-            x_old = x(i - width, j);
+            sum_rows -= stacks.row();
+            stacks.pop_front();
             
           }
           
-          if (width > 1) {
-            
-            sum_w = lambda * sum_w + w_new - lambda * w_old;
-            sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-            
-          } else {
-            
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            
-          }
+        }
+        
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          sum_rows += i;
+          stacks.push_back(x(i, j), i);
           
         }
         
@@ -1048,15 +1077,23 @@ struct RollMeanOnlineMat : public Worker {
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            arma_mean(i, j) = sum_x / sum_w;
+            
+            // weight of each observation is the last weight times 'lambda'
+            // to the power of its age (i.e., the sum of the ages is the
+            // number of observations times the current row less the rows)
+            long double prod_w = std::pow((long double)arma_weights[n - 1], n_obs) *
+              std::pow(lambda, n_obs * (long double)i - sum_rows);
+            
+            arma_prod(i, j) = prod_w * stacks.query();
+            
           } else {
-            arma_mean(i, j) = NA_REAL;
+            arma_prod(i, j) = NA_REAL;
           }
           
         } else {
           
           // can be either NA or NaN
-          arma_mean(i, j) = x(i, j);
+          arma_prod(i, j) = x(i, j);
           
         }
         
@@ -1068,7 +1105,7 @@ struct RollMeanOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMeanOfflineMat : public Worker {
+struct RollProdOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1079,19 +1116,19 @@ struct RollMeanOfflineMat : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  arma::mat& arma_mean;         // destination (pass by reference)
+  arma::mat& arma_prod;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMeanOfflineMat(const NumericMatrix x, const int n,
+  RollProdOfflineMat(const NumericMatrix x, const int n,
                      const int n_rows_x, const int n_cols_x,
                      const int width, const arma::vec arma_weights,
                      const int min_obs, const arma::uvec arma_any_na,
-                     const bool na_restore, arma::mat& arma_mean)
+                     const bool na_restore, arma::mat& arma_prod)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_mean(arma_mean) { }
+      na_restore(na_restore), arma_prod(arma_prod) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1103,8 +1140,7 @@ struct RollMeanOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      long double sum_w = 0;
-      long double sum_x = 0;
+      long double prod_x = 1;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -1117,9 +1153,8 @@ struct RollMeanOfflineMat : public Worker {
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
           if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            // compute the sum
-            sum_w += arma_weights[n - count - 1];
-            sum_x += arma_weights[n - count - 1] * x(i - count, j);
+            // compute the product
+            prod_x *= arma_weights[n - count - 1] * x(i - count, j);
             n_obs += 1;
             
           }
@@ -1129,15 +1164,15 @@ struct RollMeanOfflineMat : public Worker {
         }
         
         if (n_obs >= min_obs) {
-          arma_mean(i, j) = sum_x / sum_w;
+          arma_prod(i, j) = prod_x;
         } else {
-          arma_mean(i, j) = NA_REAL;
+          arma_prod(i, j) = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        arma_mean(i, j) = x(i, j);
+        arma_prod(i, j) = x(i, j);
         
       }
       
@@ -1147,43 +1182,83 @@ struct RollMeanOfflineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMinOnlineMat : public Worker {
+template <typename Accum>
+struct RollMeanOnlineMat : public Worker {
+  
+  typedef typename Accum::value_type value_type;
   
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<double> rcpp_min;     // destination (pass by reference)
+  const int reanchor;
+  arma::mat& arma_mean;         // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
-  RollMinOnlineMat(const NumericMatrix x, const int n,
-                   const int n_rows_x, const int n_cols_x,
-                   const int width, const arma::vec arma_weights,
-                   const int min_obs, const arma::uvec arma_any_na,
-                   const bool na_restore, NumericMatrix rcpp_min)
+  RollMeanOnlineMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int n_rows_chunk, const int width,
+                    const arma::vec arma_weights, const int min_obs,
+                    const arma::uvec arma_any_na, const bool na_restore,
+                    const int reanchor, arma::mat& arma_mean,
+                    arma::vec& arma_reanchor)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), rcpp_min(rcpp_min) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      reanchor(reanchor), arma_mean(arma_mean),
+      arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
       int n_obs = 0;
-      int idxmin_x = 0;
-      std::deque<int> deck(width);
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0;
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
       
-      for (int i = 0; i < n_rows_x; i++) {
+      if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      } else {
+        lambda = arma_weights[n - 1];
+      }
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
+          
+          w_new = 0;
+          x_new = 0;
+          
+        } else {
+          
+          w_new = arma_weights[n - 1];
+          x_new = x(i, j);
+          
+        }
         
         // expanding window
-        if (i < width) {
+        if (i < offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -1191,29 +1266,24 @@ struct RollMinOnlineMat : public Worker {
             n_obs += 1;
           }
           
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            
-            while (!deck.empty() && ((arma_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) < x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
+          if (width > 1) {
             
-            deck.push_back(i);
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
             
-          }
-          
-          if (width > 1) {
-            idxmin_x = deck.front();
           } else {
-            idxmin_x = i;
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            
           }
           
         }
         
         // rolling window
-        if (i >= width) {
+        if (i >= offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -1229,44 +1299,70 @@ struct RollMinOnlineMat : public Worker {
             
           }
           
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          if ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j))) {
             
-            while (!deck.empty() && ((arma_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) < x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
+            w_old = 0;
+            x_old = 0;
             
-            deck.push_back(i);
+          } else {
+            
+            w_old = arma_weights[n - width];
+            x_old = x(i - width, j);
             
-          }
-          
-          while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
-            deck.pop_front();
           }
           
           if (width > 1) {
-            idxmin_x = deck.front();
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            
           } else {
-            idxmin_x = i;
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            
+          }
+          
+        }
+        
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(&x(0, j), &x(0, j), arma_any_na.memptr(),
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, false);
+          
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sum_x.value() - exact.sum_x));
           }
           
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
+          
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            rcpp_min(i, j) = x(idxmin_x, j);
+            arma_mean(i, j) = sum_x.value() / sum_w.value();
           } else {
-            rcpp_min(i, j) = NA_REAL;
+            arma_mean(i, j) = NA_REAL;
           }
           
         } else {
           
           // can be either NA or NaN
-          rcpp_min(i, j) = x(i, j);
+          arma_mean(i, j) = x(i, j);
           
         }
         
@@ -1278,7 +1374,8 @@ struct RollMinOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMinOfflineMat : public Worker {
+template <typename Accum>
+struct RollMeanOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1289,19 +1386,19 @@ struct RollMinOfflineMat : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<double> rcpp_min;     // destination (pass by reference)
+  arma::mat& arma_mean;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMinOfflineMat(const NumericMatrix x, const int n,
-                    const int n_rows_x, const int n_cols_x,
-                    const int width, const arma::vec arma_weights,
-                    const int min_obs, const arma::uvec arma_any_na,
-                    const bool na_restore, NumericMatrix rcpp_min)
+  RollMeanOfflineMat(const NumericMatrix x, const int n,
+                     const int n_rows_x, const int n_cols_x,
+                     const int width, const arma::vec arma_weights,
+                     const int min_obs, const arma::uvec arma_any_na,
+                     const bool na_restore, arma::mat& arma_mean)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), rcpp_min(rcpp_min) { }
+      na_restore(na_restore), arma_mean(arma_mean) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1313,7 +1410,8 @@ struct RollMinOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      int idxmin_x = i;
+      Accum sum_w;
+      Accum sum_x;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -1326,15 +1424,9 @@ struct RollMinOfflineMat : public Worker {
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
           if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            // last element of sorted array
-            // note: 'weights' must be greater than 0
-            if ((arma_any_na[idxmin_x] != 0) || std::isnan(x(idxmin_x, j)) ||
-                (x(i - count, j) <= x(idxmin_x, j))) {
-              
-              idxmin_x = i - count;
-              
-            }
-            
+            // compute the sum
+            sum_w.add(arma_weights[n - count - 1]);
+            sum_x.add(arma_weights[n - count - 1] * x(i - count, j));
             n_obs += 1;
             
           }
@@ -1343,16 +1435,312 @@ struct RollMinOfflineMat : public Worker {
           
         }
         
-        if ((n_obs >= min_obs)) {
-          rcpp_min(i, j) = x(idxmin_x, j);
+        if (n_obs >= min_obs) {
+          arma_mean(i, j) = sum_x.value() / sum_w.value();
         } else {
-          rcpp_min(i, j) = NA_REAL;
+          arma_mean(i, j) = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_min(i, j) = x(i, j);
+        arma_mean(i, j) = x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollMeanPrefixMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_mean;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMeanPrefixMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int n_rows_chunk, const int width,
+                    const arma::vec arma_weights, const int min_obs,
+                    const arma::uvec arma_any_na, const bool na_restore,
+                    arma::mat& arma_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_mean(arma_mean) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double value[1];
+      long double sum[1];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 1, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          value[0] = x(i, j);
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if (n_obs >= min_obs) {
+            arma_mean(i, j) = (w * sum[0]) / (w * n_obs);
+          } else {
+            arma_mean(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_mean(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollMeanLinearMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_mean;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMeanLinearMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int n_rows_chunk, const int width,
+                    const arma::vec arma_weights, const int min_obs,
+                    const arma::uvec arma_any_na, const bool na_restore,
+                    arma::mat& arma_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_mean(arma_mean) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double value[1];
+      long double sum[1];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 1, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          value[0] = x(i, j);
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if (n_obs >= min_obs) {
+            arma_mean(i, j) = sum[0] / sum_w;
+          } else {
+            arma_mean(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_mean(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using the fast Fourier
+// transform, i.e., blocks of 'n_fft' rows that overlap by 'width' - 1 rows are
+// multiplied by the transform of the weights (overlap-save)
+struct RollMeanFFTMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_fft;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cx_vec arma_weights_fft;
+  arma::mat& arma_mean;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMeanFFTMat(const NumericMatrix x, const int n,
+                 const int n_rows_x, const int n_cols_x,
+                 const int n_fft, const int width,
+                 const arma::vec arma_weights, const int min_obs,
+                 const arma::uvec arma_any_na, const bool na_restore,
+                 arma::mat& arma_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_fft(n_fft), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_mean(arma_mean) {
+    
+    // weights by lag (i.e., the current row has the last weight)
+    int n_size_x = std::min(width, n_rows_x);
+    arma::cx_vec arma_lag(n_fft, arma::fill::zeros);
+    
+    for (int count = 0; count < n_size_x; count++) {
+      arma_lag[count] = arma_weights[n - count - 1];
+    }
+    
+    arma_weights_fft = arma::fft(arma_lag);
+    
+  }
+  
+  // function call operator that iterates by column and block of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the block of rows),
+      // where each block includes the previous 'width' - 1 rows
+      int n_size_x = std::min(width, n_rows_x);
+      int n_step = n_fft - n_size_x + 1;
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_step;
+      int end_row = std::min(begin_row + n_step, n_rows_x);
+      int offset = begin_row - n_size_x + 1;
+      
+      int n_obs = 0;
+      arma::cx_vec arma_block(n_fft, arma::fill::zeros);
+      
+      for (int i = std::max(0, offset); i < std::min(offset + n_fft, n_rows_x); i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        // the weights of the observations are the imaginary part
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          arma_block[i - offset] = std::complex<double>(x(i, j), 1);
+        }
+        
+      }
+      
+      // number of observations in the window of the previous row
+      for (int i = std::max(0, begin_row - n_size_x); i < begin_row; i++) {
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          n_obs += 1;
+        }
+      }
+      
+      // circular convolution, where the first 'width' - 1 rows wrap around
+      convolve_block(arma_block, arma_weights_fft, arma_weights, n, n_size_x);
+      
+      for (int i = begin_row; i < end_row; i++) {
+        
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          n_obs += 1;
+        }
+        
+        if ((i >= n_size_x) && (arma_any_na[i - n_size_x] == 0) &&
+            !std::isnan(x(i - n_size_x, j))) {
+          n_obs -= 1;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (n_obs >= min_obs) {
+            arma_mean(i, j) = std::real(arma_block[i - offset]) /
+              std::imag(arma_block[i - offset]);
+          } else {
+            arma_mean(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_mean(i, j) = x(i, j);
+          
+        }
         
       }
       
@@ -1362,7 +1750,7 @@ struct RollMinOfflineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMaxOnlineMat : public Worker {
+struct RollMinOnlineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1373,27 +1761,27 @@ struct RollMaxOnlineMat : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<double> rcpp_max;     // destination (pass by reference)
+  RMatrix<double> rcpp_min;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollMaxOnlineMat(const NumericMatrix x, const int n,
+  RollMinOnlineMat(const NumericMatrix x, const int n,
                    const int n_rows_x, const int n_cols_x,
                    const int width, const arma::vec arma_weights,
                    const int min_obs, const arma::uvec arma_any_na,
-                   const bool na_restore, NumericMatrix rcpp_max)
+                   const bool na_restore, NumericMatrix rcpp_min)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), rcpp_max(rcpp_max) { }
+      na_restore(na_restore), rcpp_min(rcpp_min) { }
   
   // function call operator that iterates by column
   void operator()(std::size_t begin_col, std::size_t end_col) {
     for (std::size_t j = begin_col; j < end_col; j++) {
       
       int n_obs = 0;
-      int idxmax_x = 0;
-      std::deque<int> deck(width);
+      int idxmin_x = 0;
+      RollMonotonicQueue deck(std::min(width, n_rows_x));
       
       for (int i = 0; i < n_rows_x; i++) {
         
@@ -1406,25 +1794,6 @@ struct RollMaxOnlineMat : public Worker {
             n_obs += 1;
           }
           
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            
-            while (!deck.empty() && ((arma_any_na[deck.back()] != 0) || 
-                   std::isnan(x(deck.back(), j)) || (x(i, j) > x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
-            
-            deck.push_back(i);
-            
-          }
-          
-          if (width > 1) {
-            idxmax_x = deck.front();
-          } else {
-            idxmax_x = i;
-          }
-          
         }
         
         // rolling window
@@ -1444,44 +1813,41 @@ struct RollMaxOnlineMat : public Worker {
             
           }
           
-          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            
-            while (!deck.empty() && ((arma_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) > x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
-            
-            deck.push_back(i);
-            
-          }
-          
-          while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
+          // at most one row leaves the window
+          if (!deck.empty() && (deck.front() <= i - width)) {
             deck.pop_front();
           }
           
-          if (width > 1) {
-            idxmax_x = deck.front();
-          } else {
-            idxmax_x = i;
+        }
+        
+        // only valid observations are in the queue
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          while (!deck.empty() && (x(i, j) < x(deck.back(), j))) {
+            deck.pop_back();
           }
           
+          deck.push_back(i);
+          
+        }
+        
+        if (!deck.empty()) {
+          idxmin_x = deck.front();
         }
         
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            rcpp_max(i, j) = x(idxmax_x, j);
+            rcpp_min(i, j) = x(idxmin_x, j);
           } else {
-            rcpp_max(i, j) = NA_REAL;
+            rcpp_min(i, j) = NA_REAL;
           }
           
         } else {
           
           // can be either NA or NaN
-          rcpp_max(i, j) = x(i, j);
+          rcpp_min(i, j) = x(i, j);
           
         }
         
@@ -1493,7 +1859,7 @@ struct RollMaxOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMaxOfflineMat : public Worker {
+struct RollMinOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1504,19 +1870,19 @@ struct RollMaxOfflineMat : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<double> rcpp_max;     // destination (pass by reference)
+  RMatrix<double> rcpp_min;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollMaxOfflineMat(const NumericMatrix x, const int n,
+  RollMinOfflineMat(const NumericMatrix x, const int n,
                     const int n_rows_x, const int n_cols_x,
                     const int width, const arma::vec arma_weights,
                     const int min_obs, const arma::uvec arma_any_na,
-                    const bool na_restore, NumericMatrix rcpp_max)
+                    const bool na_restore, NumericMatrix rcpp_min)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), rcpp_max(rcpp_max) { }
+      na_restore(na_restore), rcpp_min(rcpp_min) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1528,7 +1894,7 @@ struct RollMaxOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      int idxmax_x = i;
+      int idxmin_x = i;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -1541,12 +1907,12 @@ struct RollMaxOfflineMat : public Worker {
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
           if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            // first element of sorted array
+            // last element of sorted array
             // note: 'weights' must be greater than 0
-            if ((arma_any_na[idxmax_x] != 0) || std::isnan(x(idxmax_x, j)) ||
-                (x(i - count, j) >= x(idxmax_x, j))) {
+            if ((arma_any_na[idxmin_x] != 0) || std::isnan(x(idxmin_x, j)) ||
+                (x(i - count, j) <= x(idxmin_x, j))) {
               
-              idxmax_x = i - count;
+              idxmin_x = i - count;
               
             }
             
@@ -1559,25 +1925,183 @@ struct RollMaxOfflineMat : public Worker {
         }
         
         if ((n_obs >= min_obs)) {
-          rcpp_max(i, j) = x(idxmax_x, j);
+          rcpp_min(i, j) = x(idxmin_x, j);
         } else {
-          rcpp_max(i, j) = NA_REAL;
+          rcpp_min(i, j) = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_max(i, j) = x(i, j);
+        rcpp_min(i, j) = x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using the van Herk and
+// Gil-Werman algorithm, i.e., forward and backward scans within blocks of size
+// 'width' so each min is the min of a suffix and a prefix, where the
+// scans are over 'n_lanes' adjacent columns that are contiguous in a buffer
+struct RollMinBlockMat : public Worker {
+  
+  static const int n_lanes = 8;
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_min;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMinBlockMat(const NumericMatrix x, const int n,
+                  const int n_rows_x, const int n_cols_x,
+                  const int width, const arma::vec arma_weights,
+                  const int min_obs, const arma::uvec arma_any_na,
+                  const bool na_restore, NumericMatrix rcpp_min)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_min(rcpp_min) { }
+  
+  // function call operator that iterates by block of 'n_lanes' columns
+  void operator()(std::size_t begin_block, std::size_t end_block) {
+    
+    // rows are interleaved by column (i.e., row 'i' and lane 'l' is
+    // 'i * n_lanes + l') for the inner loops to be vectorized
+    int n_size_x = std::min(width, n_rows_x);
+    std::vector<double> x_prefix(n_size_x * n_lanes);
+    std::vector<double> x_suffix(n_size_x * n_lanes);
+    std::vector<double> x_suffix_prev(n_size_x * n_lanes);
+    
+    for (std::size_t b = begin_block; b < end_block; b++) {
+      
+      int offset = b * n_lanes;
+      int n_lanes_b = std::min(n_cols_x - offset, (int)n_lanes);
+      int n_obs[n_lanes] = {0};
+      
+      for (int begin_row = 0; begin_row < n_rows_x; begin_row += width) {
+        
+        int n_rows_b = std::min(width, n_rows_x - begin_row);
+        
+        // missing values are the identity so they are never the min
+        for (int i = 0; i < n_rows_b; i++) {
+          for (int l = 0; l < n_lanes; l++) {
+            
+            int k = begin_row + i;
+            
+            // don't include if missing value and 'any_na' argument is 1
+            // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+            if ((l < n_lanes_b) && (arma_any_na[k] == 0) && !std::isnan(x(k, offset + l))) {
+              x_suffix[i * n_lanes + l] = x(k, offset + l);
+            } else {
+              x_suffix[i * n_lanes + l] = R_PosInf;
+            }
+            
+          }
+        }
+        
+        // forward scan within the block
+        for (int l = 0; l < n_lanes; l++) {
+          x_prefix[l] = x_suffix[l];
+        }
+        
+        for (int i = 1; i < n_rows_b; i++) {
+          
+          double* prefix_i = &x_prefix[i * n_lanes];
+          const double* prefix_prev = prefix_i - n_lanes;
+          const double* x_i = &x_suffix[i * n_lanes];
+          
+          for (int l = 0; l < n_lanes; l++) {
+            prefix_i[l] = (x_i[l] < prefix_prev[l]) ? x_i[l] : prefix_prev[l];
+          }
+          
+        }
+        
+        for (int i = 0; i < n_rows_b; i++) {
+          
+          int k = begin_row + i;
+          
+          for (int l = 0; l < n_lanes_b; l++) {
+            
+            int j = offset + l;
+            
+            // expanding window
+            if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+              n_obs[l] += 1;
+            }
+            
+            // rolling window
+            if ((k >= width) && (arma_any_na[k - width] == 0) && !std::isnan(x(k - width, j))) {
+              n_obs[l] -= 1;
+            }
+            
+            // don't compute if missing value and 'na_restore' argument is TRUE
+            if ((!na_restore) || (na_restore && !std::isnan(x(k, j)))) {
+              
+              if (n_obs[l] >= min_obs) {
+                
+                double prefix = x_prefix[i * n_lanes + l];
+                
+                // window is the suffix of the previous block and the prefix
+                // of this block, except for the first block or last row
+                if ((begin_row > 0) && (i + 1 < width)) {
+                  
+                  double suffix = x_suffix_prev[(i + 1) * n_lanes + l];
+                  rcpp_min(k, j) = (prefix < suffix) ? prefix : suffix;
+                  
+                } else {
+                  rcpp_min(k, j) = prefix;
+                }
+                
+              } else {
+                rcpp_min(k, j) = NA_REAL;
+              }
+              
+            } else {
+              
+              // can be either NA or NaN
+              rcpp_min(k, j) = x(k, j);
+              
+            }
+            
+          }
+          
+        }
+        
+        // backward scan within the block (in place)
+        for (int i = n_rows_b - 2; i >= 0; i--) {
+          
+          double* suffix_i = &x_suffix[i * n_lanes];
+          const double* suffix_next = suffix_i + n_lanes;
+          
+          for (int l = 0; l < n_lanes; l++) {
+            suffix_i[l] = (suffix_next[l] < suffix_i[l]) ? suffix_next[l] : suffix_i[l];
+          }
+          
+        }
+        
+        x_suffix.swap(x_suffix_prev);
         
       }
       
     }
+    
   }
   
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollIdxMinOnlineMat : public Worker {
+struct RollMaxOnlineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1586,29 +2110,29 @@ struct RollIdxMinOnlineMat : public Worker {
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
-  const RVector<int> rcpp_any_na;
+  const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<int> rcpp_idxmin;     // destination (pass by reference)
+  RMatrix<double> rcpp_max;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMinOnlineMat(const NumericMatrix x, const int n,
-                      const int n_rows_x, const int n_cols_x,
-                      const int width, const arma::vec arma_weights,
-                      const int min_obs, const IntegerVector rcpp_any_na,
-                      const bool na_restore, IntegerMatrix rcpp_idxmin)
+  RollMaxOnlineMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int width, const arma::vec arma_weights,
+                   const int min_obs, const arma::uvec arma_any_na,
+                   const bool na_restore, NumericMatrix rcpp_max)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
-      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
-      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_max(rcpp_max) { }
   
   // function call operator that iterates by column
   void operator()(std::size_t begin_col, std::size_t end_col) {
     for (std::size_t j = begin_col; j < end_col; j++) {
       
       int n_obs = 0;
-      int idxmin_x = 0;
-      std::deque<int> deck(width);
+      int idxmax_x = 0;
+      RollMonotonicQueue deck(std::min(width, n_rows_x));
       
       for (int i = 0; i < n_rows_x; i++) {
         
@@ -1617,29 +2141,10 @@ struct RollIdxMinOnlineMat : public Worker {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
             n_obs += 1;
           }
           
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            
-            while (!deck.empty() && ((rcpp_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) < x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
-            
-            deck.push_back(i);
-            
-          }
-          
-          if (width > 1) {
-            idxmin_x = deck.front() + 1;
-          } else {
-            idxmin_x = 1;
-          }
-          
         }
         
         // rolling window
@@ -1647,56 +2152,53 @@ struct RollIdxMinOnlineMat : public Worker {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j)) &&
-              ((rcpp_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
+              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
             
             n_obs += 1;
             
-          } else if (((rcpp_any_na[i] != 0) || std::isnan(x(i, j))) &&
-            (rcpp_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
+            (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
             n_obs -= 1;
             
           }
           
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            
-            while (!deck.empty() && ((rcpp_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) < x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
-            
-            deck.push_back(i);
-            
-          }
-          
-          while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
+          // at most one row leaves the window
+          if (!deck.empty() && (deck.front() <= i - width)) {
             deck.pop_front();
           }
           
-          if (width > 1) {
-            idxmin_x = width - (i - deck.front());
-          } else {
-            idxmin_x = 1;
+        }
+        
+        // only valid observations are in the queue
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          while (!deck.empty() && (x(i, j) > x(deck.back(), j))) {
+            deck.pop_back();
           }
           
+          deck.push_back(i);
+          
+        }
+        
+        if (!deck.empty()) {
+          idxmax_x = deck.front();
         }
         
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            rcpp_idxmin(i, j) = idxmin_x;
+            rcpp_max(i, j) = x(idxmax_x, j);
           } else {
-            rcpp_idxmin(i, j) = NA_INTEGER;
+            rcpp_max(i, j) = NA_REAL;
           }
           
         } else {
           
           // can be either NA or NaN
-          rcpp_idxmin(i, j) = (int)x(i, j);
+          rcpp_max(i, j) = x(i, j);
           
         }
         
@@ -1708,7 +2210,7 @@ struct RollIdxMinOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollIdxMinOfflineMat : public Worker {
+struct RollMaxOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1717,21 +2219,21 @@ struct RollIdxMinOfflineMat : public Worker {
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
-  const RVector<int> rcpp_any_na;
+  const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<int> rcpp_idxmin;     // destination (pass by reference)
+  RMatrix<double> rcpp_max;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMinOfflineMat(const NumericMatrix x, const int n,
-                       const int n_rows_x, const int n_cols_x,
-                       const int width, const arma::vec arma_weights,
-                       const int min_obs, const IntegerVector rcpp_any_na,
-                       const bool na_restore, IntegerMatrix rcpp_idxmin)
+  RollMaxOfflineMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int width, const arma::vec arma_weights,
+                    const int min_obs, const arma::uvec arma_any_na,
+                    const bool na_restore, NumericMatrix rcpp_max)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
-      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
-      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_max(rcpp_max) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1743,7 +2245,7 @@ struct RollIdxMinOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      int idxmin_x = i;
+      int idxmax_x = i;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -1754,14 +2256,14 @@ struct RollIdxMinOfflineMat : public Worker {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((rcpp_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
+          if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            // last element of sorted array
+            // first element of sorted array
             // note: 'weights' must be greater than 0
-            if ((rcpp_any_na[idxmin_x] != 0) || std::isnan(x(idxmin_x, j)) ||
-                (x(i - count, j) <= x(idxmin_x, j))) {
+            if ((arma_any_na[idxmax_x] != 0) || std::isnan(x(idxmax_x, j)) ||
+                (x(i - count, j) >= x(idxmax_x, j))) {
               
-              idxmin_x = i - count;
+              idxmax_x = i - count;
               
             }
             
@@ -1774,21 +2276,15 @@ struct RollIdxMinOfflineMat : public Worker {
         }
         
         if ((n_obs >= min_obs)) {
-          
-          if (i < width) {
-            rcpp_idxmin(i, j) = idxmin_x + 1;
-          } else if (i >= width) {
-            rcpp_idxmin(i, j) = width - (i - idxmin_x);
-          }
-          
+          rcpp_max(i, j) = x(idxmax_x, j);
         } else {
-          rcpp_idxmin(i, j) = NA_INTEGER;
+          rcpp_max(i, j) = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmin(i, j) = (int)x(i, j);
+        rcpp_max(i, j) = x(i, j);
         
       }
       
@@ -1797,8 +2293,13 @@ struct RollIdxMinOfflineMat : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollIdxMaxOnlineMat : public Worker {
+// 'Worker' function for computing the rolling statistic using the van Herk and
+// Gil-Werman algorithm, i.e., forward and backward scans within blocks of size
+// 'width' so each max is the max of a suffix and a prefix, where the
+// scans are over 'n_lanes' adjacent columns that are contiguous in a buffer
+struct RollMaxBlockMat : public Worker {
+  
+  static const int n_lanes = 8;
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1807,100 +2308,237 @@ struct RollIdxMaxOnlineMat : public Worker {
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
-  const RVector<int> rcpp_any_na;
+  const arma::uvec arma_any_na;
   const bool na_restore;
-  RMatrix<int> rcpp_idxmax;     // destination (pass by reference)
+  RMatrix<double> rcpp_max;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMaxOnlineMat(const NumericMatrix x, const int n,
-                      const int n_rows_x, const int n_cols_x,
-                      const int width, const arma::vec arma_weights,
-                      const int min_obs, const IntegerVector rcpp_any_na,
-                      const bool na_restore, IntegerMatrix rcpp_idxmax)
+  RollMaxBlockMat(const NumericMatrix x, const int n,
+                  const int n_rows_x, const int n_cols_x,
+                  const int width, const arma::vec arma_weights,
+                  const int min_obs, const arma::uvec arma_any_na,
+                  const bool na_restore, NumericMatrix rcpp_max)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
-      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
-      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_max(rcpp_max) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by block of 'n_lanes' columns
+  void operator()(std::size_t begin_block, std::size_t end_block) {
+    
+    // rows are interleaved by column (i.e., row 'i' and lane 'l' is
+    // 'i * n_lanes + l') for the inner loops to be vectorized
+    int n_size_x = std::min(width, n_rows_x);
+    std::vector<double> x_prefix(n_size_x * n_lanes);
+    std::vector<double> x_suffix(n_size_x * n_lanes);
+    std::vector<double> x_suffix_prev(n_size_x * n_lanes);
+    
+    for (std::size_t b = begin_block; b < end_block; b++) {
       
-      int n_obs = 0;
-      int idxmax_x = 0;
-      std::deque<int> deck(width);
+      int offset = b * n_lanes;
+      int n_lanes_b = std::min(n_cols_x - offset, (int)n_lanes);
+      int n_obs[n_lanes] = {0};
       
-      for (int i = 0; i < n_rows_x; i++) {
+      for (int begin_row = 0; begin_row < n_rows_x; begin_row += width) {
         
-        // expanding window
-        if (i < width) {
-          
-          // don't include if missing value and 'any_na' argument is 1
-          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
-            n_obs += 1;
-          }
-          
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+        int n_rows_b = std::min(width, n_rows_x - begin_row);
+        
+        // missing values are the identity so they are never the max
+        for (int i = 0; i < n_rows_b; i++) {
+          for (int l = 0; l < n_lanes; l++) {
             
-            while (!deck.empty() && ((rcpp_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) > x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
+            int k = begin_row + i;
             
-            deck.push_back(i);
+            // don't include if missing value and 'any_na' argument is 1
+            // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+            if ((l < n_lanes_b) && (arma_any_na[k] == 0) && !std::isnan(x(k, offset + l))) {
+              x_suffix[i * n_lanes + l] = x(k, offset + l);
+            } else {
+              x_suffix[i * n_lanes + l] = R_NegInf;
+            }
             
           }
+        }
+        
+        // forward scan within the block
+        for (int l = 0; l < n_lanes; l++) {
+          x_prefix[l] = x_suffix[l];
+        }
+        
+        for (int i = 1; i < n_rows_b; i++) {
           
-          if (width > 1) {
-            idxmax_x = deck.front() + 1;
-          } else {
-            idxmax_x = 1;
+          double* prefix_i = &x_prefix[i * n_lanes];
+          const double* prefix_prev = prefix_i - n_lanes;
+          const double* x_i = &x_suffix[i * n_lanes];
+          
+          for (int l = 0; l < n_lanes; l++) {
+            prefix_i[l] = (x_i[l] > prefix_prev[l]) ? x_i[l] : prefix_prev[l];
           }
           
         }
         
-        // rolling window
-        if (i >= width) {
+        for (int i = 0; i < n_rows_b; i++) {
           
-          // don't include if missing value and 'any_na' argument is 1
-          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j)) &&
-              ((rcpp_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
+          int k = begin_row + i;
+          
+          for (int l = 0; l < n_lanes_b; l++) {
             
-            n_obs += 1;
+            int j = offset + l;
             
-          } else if (((rcpp_any_na[i] != 0) || std::isnan(x(i, j))) &&
-            (rcpp_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+            // expanding window
+            if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+              n_obs[l] += 1;
+            }
             
-            n_obs -= 1;
+            // rolling window
+            if ((k >= width) && (arma_any_na[k - width] == 0) && !std::isnan(x(k - width, j))) {
+              n_obs[l] -= 1;
+            }
+            
+            // don't compute if missing value and 'na_restore' argument is TRUE
+            if ((!na_restore) || (na_restore && !std::isnan(x(k, j)))) {
+              
+              if (n_obs[l] >= min_obs) {
+                
+                double prefix = x_prefix[i * n_lanes + l];
+                
+                // window is the suffix of the previous block and the prefix
+                // of this block, except for the first block or last row
+                if ((begin_row > 0) && (i + 1 < width)) {
+                  
+                  double suffix = x_suffix_prev[(i + 1) * n_lanes + l];
+                  rcpp_max(k, j) = (prefix > suffix) ? prefix : suffix;
+                  
+                } else {
+                  rcpp_max(k, j) = prefix;
+                }
+                
+              } else {
+                rcpp_max(k, j) = NA_REAL;
+              }
+              
+            } else {
+              
+              // can be either NA or NaN
+              rcpp_max(k, j) = x(k, j);
+              
+            }
             
           }
           
+        }
+        
+        // backward scan within the block (in place)
+        for (int i = n_rows_b - 2; i >= 0; i--) {
+          
+          double* suffix_i = &x_suffix[i * n_lanes];
+          const double* suffix_next = suffix_i + n_lanes;
+          
+          for (int l = 0; l < n_lanes; l++) {
+            suffix_i[l] = (suffix_next[l] > suffix_i[l]) ? suffix_next[l] : suffix_i[l];
+          }
+          
+        }
+        
+        x_suffix.swap(x_suffix_prev);
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollIdxMinOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const RVector<int> rcpp_any_na;
+  const bool na_restore;
+  RMatrix<int> rcpp_idxmin;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxMinOnlineMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const IntegerVector rcpp_any_na,
+                      const bool na_restore, IntegerMatrix rcpp_idxmin)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
+      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      int idxmin_x = 0;
+      RollMonotonicQueue deck(std::min(width, n_rows_x));
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        if (i < width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
           if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+            n_obs += 1;
+          }
+          
+        }
+        
+        // rolling window
+        if (i >= width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j)) &&
+              ((rcpp_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
             
-            while (!deck.empty() && ((rcpp_any_na[deck.back()] != 0) ||
-                   std::isnan(x(deck.back(), j)) || (x(i, j) > x(deck.back(), j)))) {
-              
-              deck.pop_back();
-              
-            }
+            n_obs += 1;
+            
+          } else if (((rcpp_any_na[i] != 0) || std::isnan(x(i, j))) &&
+            (rcpp_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
-            deck.push_back(i);
+            n_obs -= 1;
             
           }
           
-          while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
+          // at most one row leaves the window
+          if (!deck.empty() && (deck.front() <= i - width)) {
             deck.pop_front();
           }
           
-          if (width > 1) {
-            idxmax_x = width - (i - deck.front());
+        }
+        
+        // only valid observations are in the queue
+        if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          while (!deck.empty() && (x(i, j) < x(deck.back(), j))) {
+            deck.pop_back();
+          }
+          
+          deck.push_back(i);
+          
+        }
+        
+        if (!deck.empty()) {
+          
+          if (i < width) {
+            idxmin_x = deck.front() + 1;
           } else {
-            idxmax_x = 1;
+            idxmin_x = width - (i - deck.front());
           }
           
         }
@@ -1909,15 +2547,15 @@ struct RollIdxMaxOnlineMat : public Worker {
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if (n_obs >= min_obs) {
-            rcpp_idxmax(i, j) = idxmax_x;
+            rcpp_idxmin(i, j) = idxmin_x;
           } else {
-            rcpp_idxmax(i, j) = NA_INTEGER;
+            rcpp_idxmin(i, j) = NA_INTEGER;
           }
           
         } else {
           
           // can be either NA or NaN
-          rcpp_idxmax(i, j) = (int)x(i, j);
+          rcpp_idxmin(i, j) = (int)x(i, j);
           
         }
         
@@ -1929,7 +2567,7 @@ struct RollIdxMaxOnlineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollIdxMaxOfflineMat : public Worker {
+struct RollIdxMinOfflineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -1940,19 +2578,19 @@ struct RollIdxMaxOfflineMat : public Worker {
   const int min_obs;
   const RVector<int> rcpp_any_na;
   const bool na_restore;
-  RMatrix<int> rcpp_idxmax;     // destination (pass by reference)
+  RMatrix<int> rcpp_idxmin;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMaxOfflineMat(const NumericMatrix x, const int n,
+  RollIdxMinOfflineMat(const NumericMatrix x, const int n,
                        const int n_rows_x, const int n_cols_x,
                        const int width, const arma::vec arma_weights,
                        const int min_obs, const IntegerVector rcpp_any_na,
-                       const bool na_restore, IntegerMatrix rcpp_idxmax)
+                       const bool na_restore, IntegerMatrix rcpp_idxmin)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       min_obs(min_obs), rcpp_any_na(rcpp_any_na),
-      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
+      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1964,7 +2602,7 @@ struct RollIdxMaxOfflineMat : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      int idxmax_x = i;
+      int idxmin_x = i;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
@@ -1977,12 +2615,12 @@ struct RollIdxMaxOfflineMat : public Worker {
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
           if ((rcpp_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            // first element of sorted array
+            // last element of sorted array
             // note: 'weights' must be greater than 0
-            if ((rcpp_any_na[idxmax_x] != 0) || std::isnan(x(idxmax_x, j)) ||
-                (x(i - count, j) >= x(idxmax_x, j))) {
+            if ((rcpp_any_na[idxmin_x] != 0) || std::isnan(x(idxmin_x, j)) ||
+                (x(i - count, j) <= x(idxmin_x, j))) {
               
-              idxmax_x = i - count;
+              idxmin_x = i - count;
               
             }
             
@@ -1997,19 +2635,19 @@ struct RollIdxMaxOfflineMat : public Worker {
         if ((n_obs >= min_obs)) {
           
           if (i < width) {
-            rcpp_idxmax(i, j) = idxmax_x + 1;
+            rcpp_idxmin(i, j) = idxmin_x + 1;
           } else if (i >= width) {
-            rcpp_idxmax(i, j) = width - (i - idxmax_x);
+            rcpp_idxmin(i, j) = width - (i - idxmin_x);
           }
           
         } else {
-          rcpp_idxmax(i, j) = NA_INTEGER;
+          rcpp_idxmin(i, j) = NA_INTEGER;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmax(i, j) = (int)x(i, j);
+        rcpp_idxmin(i, j) = (int)x(i, j);
         
       }
       
@@ -2018,8 +2656,8 @@ struct RollIdxMaxOfflineMat : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollQuantileOfflineMat : public Worker {
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollIdxMaxOnlineMat : public Worker {
   
   const RMatrix<double> x;      // source
   const int n;
@@ -2027,103 +2665,2689 @@ struct RollQuantileOfflineMat : public Worker {
   const int n_cols_x;
   const int width;
   const arma::vec arma_weights;
-  const double p;
   const int min_obs;
-  const arma::uvec arma_any_na;
+  const RVector<int> rcpp_any_na;
   const bool na_restore;
-  RMatrix<double> rcpp_quantile;// destination (pass by reference)
+  RMatrix<int> rcpp_idxmax;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollQuantileOfflineMat(const NumericMatrix x, const int n,
-                         const int n_rows_x, const int n_cols_x,
-                         const int width,  const arma::vec arma_weights,
-                         const double p, const int min_obs,
-                         const arma::uvec arma_any_na, const bool na_restore,
-                         NumericMatrix rcpp_quantile)
+  RollIdxMaxOnlineMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const IntegerVector rcpp_any_na,
+                      const bool na_restore, IntegerMatrix rcpp_idxmax)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
-      p(p), min_obs(min_obs),
-      arma_any_na(arma_any_na), na_restore(na_restore),
-      rcpp_quantile(rcpp_quantile) { }
+      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
+      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
   
-  // function call operator that iterates by index
-  void operator()(std::size_t begin_index, std::size_t end_index) {
-    for (std::size_t z = begin_index; z < end_index; z++) {
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
       
-      // from 1D to 2D array
-      int i = z / n_cols_x;
-      int j = z % n_cols_x;
+      int n_obs = 0;
+      int idxmax_x = 0;
+      RollMonotonicQueue deck(std::min(width, n_rows_x));
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
-        
-        int k = 0;
-        int count = 0;
-        long double sum_w = 0;
-        
-        int offset = std::max(0, i - width + 1);
-        int n_size_x = i - offset + 1;
-        arma::vec x_subset(n_size_x);
-        arma::vec arma_weights_subset(n_size_x);
-        arma::uvec arma_any_na_subset(n_size_x);
-        
-        std::copy(x.begin() + n_rows_x * j + offset, x.begin() + n_rows_x * j + i + 1,
-                  x_subset.begin());
-        std::copy(arma_weights.begin() + n - n_size_x, arma_weights.begin() + n,
-                  arma_weights_subset.begin());
-        std::copy(arma_any_na.begin() + offset, arma_any_na.begin() + i + 1,
-                  arma_any_na_subset.begin());
-        
-        // similar to R's sort with 'index.return = TRUE'
-        arma::ivec sort_ix = stl_sort_index(x_subset);
+      for (int i = 0; i < n_rows_x; i++) {
         
-        // number of observations is either the window size or,
-        // for partial results, the number of the current row
-        while ((width > count) && (n_size_x - 1 >= count)) {
+        // expanding window
+        if (i < width) {
           
-          k = sort_ix[n_size_x - count - 1];
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+            n_obs += 1;
+          }
+          
+        }
+        
+        // rolling window
+        if (i >= width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((arma_any_na_subset[k] == 0) && !std::isnan(x_subset[k])) {
+          if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j)) &&
+              ((rcpp_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
             
-            // compute the sum
-            sum_w += arma_weights_subset[k];
+            n_obs += 1;
+            
+          } else if (((rcpp_any_na[i] != 0) || std::isnan(x(i, j))) &&
+            (rcpp_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+            
+            n_obs -= 1;
             
           }
           
-          count += 1;
+          // at most one row leaves the window
+          if (!deck.empty() && (deck.front() <= i - width)) {
+            deck.pop_front();
+          }
+          
+        }
+        
+        // only valid observations are in the queue
+        if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          while (!deck.empty() && (x(i, j) > x(deck.back(), j))) {
+            deck.pop_back();
+          }
+          
+          deck.push_back(i);
+          
+        }
+        
+        if (!deck.empty()) {
+          
+          if (i < width) {
+            idxmax_x = deck.front() + 1;
+          } else {
+            idxmax_x = width - (i - deck.front());
+          }
           
         }
         
-        count = 0;
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (n_obs >= min_obs) {
+            rcpp_idxmax(i, j) = idxmax_x;
+          } else {
+            rcpp_idxmax(i, j) = NA_INTEGER;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_idxmax(i, j) = (int)x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollIdxMaxOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const RVector<int> rcpp_any_na;
+  const bool na_restore;
+  RMatrix<int> rcpp_idxmax;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxMaxOfflineMat(const NumericMatrix x, const int n,
+                       const int n_rows_x, const int n_cols_x,
+                       const int width, const arma::vec arma_weights,
+                       const int min_obs, const IntegerVector rcpp_any_na,
+                       const bool na_restore, IntegerMatrix rcpp_idxmax)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), rcpp_any_na(rcpp_any_na),
+      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      int count = 0;
+      int n_obs = 0;
+      int idxmax_x = i;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (i >= count)) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((rcpp_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
+            
+            // first element of sorted array
+            // note: 'weights' must be greater than 0
+            if ((rcpp_any_na[idxmax_x] != 0) || std::isnan(x(idxmax_x, j)) ||
+                (x(i - count, j) >= x(idxmax_x, j))) {
+              
+              idxmax_x = i - count;
+              
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        if ((n_obs >= min_obs)) {
+          
+          if (i < width) {
+            rcpp_idxmax(i, j) = idxmax_x + 1;
+          } else if (i >= width) {
+            rcpp_idxmax(i, j) = width - (i - idxmax_x);
+          }
+          
+        } else {
+          rcpp_idxmax(i, j) = NA_INTEGER;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_idxmax(i, j) = (int)x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistics using an online algorithm
+struct RollRangeOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  const bool status_min;
+  const bool status_max;
+  const bool status_idxmin;
+  const bool status_idxmax;
+  RMatrix<double> rcpp_min;     // destination (pass by reference)
+  RMatrix<double> rcpp_max;
+  RMatrix<int> rcpp_idxmin;
+  RMatrix<int> rcpp_idxmax;
+  
+  // initialize with source and destination
+  RollRangeOnlineMat(const NumericMatrix x, const int n,
+                     const int n_rows_x, const int n_cols_x,
+                     const int width, const arma::vec arma_weights,
+                     const int min_obs, const arma::uvec arma_any_na,
+                     const bool na_restore, const bool status_min,
+                     const bool status_max, const bool status_idxmin,
+                     const bool status_idxmax, NumericMatrix rcpp_min,
+                     NumericMatrix rcpp_max, IntegerMatrix rcpp_idxmin,
+                     IntegerMatrix rcpp_idxmax)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), status_min(status_min),
+      status_max(status_max), status_idxmin(status_idxmin),
+      status_idxmax(status_idxmax), rcpp_min(rcpp_min),
+      rcpp_max(rcpp_max), rcpp_idxmin(rcpp_idxmin),
+      rcpp_idxmax(rcpp_idxmax) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    // only the queues of the requested statistics are updated
+    bool status_deck_min = status_min || status_idxmin;
+    bool status_deck_max = status_max || status_idxmax;
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      RollMonotonicQueue deck_min(std::min(width, n_rows_x));
+      RollMonotonicQueue deck_max(std::min(width, n_rows_x));
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        if (i < width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+            n_obs += 1;
+          }
+          
+        }
+        
+        // rolling window
+        if (i >= width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
+              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
+            
+            n_obs += 1;
+            
+          } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
+            (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+            
+            n_obs -= 1;
+            
+          }
+          
+          // at most one row leaves the window
+          if (!deck_min.empty() && (deck_min.front() <= i - width)) {
+            deck_min.pop_front();
+          }
+          
+          if (!deck_max.empty() && (deck_max.front() <= i - width)) {
+            deck_max.pop_front();
+          }
+          
+        }
+        
+        // only valid observations are in the queues
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          if (status_deck_min) {
+            
+            while (!deck_min.empty() && (x(i, j) < x(deck_min.back(), j))) {
+              deck_min.pop_back();
+            }
+            
+            deck_min.push_back(i);
+            
+          }
+          
+          if (status_deck_max) {
+            
+            while (!deck_max.empty() && (x(i, j) > x(deck_max.back(), j))) {
+              deck_max.pop_back();
+            }
+            
+            deck_max.push_back(i);
+            
+          }
+          
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          // first row of the window
+          int offset = std::max(0, i - width + 1);
+          
+          if (n_obs >= min_obs) {
+            
+            if (status_min) {
+              rcpp_min(i, j) = x(deck_min.front(), j);
+            }
+            
+            if (status_max) {
+              rcpp_max(i, j) = x(deck_max.front(), j);
+            }
+            
+            if (status_idxmin) {
+              rcpp_idxmin(i, j) = deck_min.front() - offset + 1;
+            }
+            
+            if (status_idxmax) {
+              rcpp_idxmax(i, j) = deck_max.front() - offset + 1;
+            }
+            
+          } else {
+            
+            if (status_min) {
+              rcpp_min(i, j) = NA_REAL;
+            }
+            
+            if (status_max) {
+              rcpp_max(i, j) = NA_REAL;
+            }
+            
+            if (status_idxmin) {
+              rcpp_idxmin(i, j) = NA_INTEGER;
+            }
+            
+            if (status_idxmax) {
+              rcpp_idxmax(i, j) = NA_INTEGER;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          if (status_min) {
+            rcpp_min(i, j) = x(i, j);
+          }
+          
+          if (status_max) {
+            rcpp_max(i, j) = x(i, j);
+          }
+          
+          if (status_idxmin) {
+            rcpp_idxmin(i, j) = (int)x(i, j);
+          }
+          
+          if (status_idxmax) {
+            rcpp_idxmax(i, j) = (int)x(i, j);
+          }
+          
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistics using an offline algorithm
+struct RollRangeOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  const bool status_min;
+  const bool status_max;
+  const bool status_idxmin;
+  const bool status_idxmax;
+  RMatrix<double> rcpp_min;     // destination (pass by reference)
+  RMatrix<double> rcpp_max;
+  RMatrix<int> rcpp_idxmin;
+  RMatrix<int> rcpp_idxmax;
+  
+  // initialize with source and destination
+  RollRangeOfflineMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const arma::uvec arma_any_na,
+                      const bool na_restore, const bool status_min,
+                      const bool status_max, const bool status_idxmin,
+                      const bool status_idxmax, NumericMatrix rcpp_min,
+                      NumericMatrix rcpp_max, IntegerMatrix rcpp_idxmin,
+                      IntegerMatrix rcpp_idxmax)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), status_min(status_min),
+      status_max(status_max), status_idxmin(status_idxmin),
+      status_idxmax(status_idxmax), rcpp_min(rcpp_min),
+      rcpp_max(rcpp_max), rcpp_idxmin(rcpp_idxmin),
+      rcpp_idxmax(rcpp_idxmax) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      int count = 0;
+      int n_obs = 0;
+      int idxmin_x = i;
+      int idxmax_x = i;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (i >= count)) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
+            
+            // first and last elements of sorted array
+            if ((arma_any_na[idxmin_x] != 0) || std::isnan(x(idxmin_x, j)) ||
+                (x(i - count, j) <= x(idxmin_x, j))) {
+              
+              idxmin_x = i - count;
+              
+            }
+            
+            if ((arma_any_na[idxmax_x] != 0) || std::isnan(x(idxmax_x, j)) ||
+                (x(i - count, j) >= x(idxmax_x, j))) {
+              
+              idxmax_x = i - count;
+              
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        // first row of the window
+        int offset = std::max(0, i - width + 1);
+        
+        if (n_obs >= min_obs) {
+          
+          if (status_min) {
+            rcpp_min(i, j) = x(idxmin_x, j);
+          }
+          
+          if (status_max) {
+            rcpp_max(i, j) = x(idxmax_x, j);
+          }
+          
+          if (status_idxmin) {
+            rcpp_idxmin(i, j) = idxmin_x - offset + 1;
+          }
+          
+          if (status_idxmax) {
+            rcpp_idxmax(i, j) = idxmax_x - offset + 1;
+          }
+          
+        } else {
+          
+          if (status_min) {
+            rcpp_min(i, j) = NA_REAL;
+          }
+          
+          if (status_max) {
+            rcpp_max(i, j) = NA_REAL;
+          }
+          
+          if (status_idxmin) {
+            rcpp_idxmin(i, j) = NA_INTEGER;
+          }
+          
+          if (status_idxmax) {
+            rcpp_idxmax(i, j) = NA_INTEGER;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        if (status_min) {
+          rcpp_min(i, j) = x(i, j);
+        }
+        
+        if (status_max) {
+          rcpp_max(i, j) = x(i, j);
+        }
+        
+        if (status_idxmin) {
+          rcpp_idxmin(i, j) = (int)x(i, j);
+        }
+        
+        if (status_idxmax) {
+          rcpp_idxmax(i, j) = (int)x(i, j);
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollDrawdownOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool runup;
+  const bool index;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_drawdown;     // destination (pass by reference)
+  RMatrix<int> rcpp_peak;
+  RMatrix<int> rcpp_trough;
+  
+  // initialize with source and destination
+  RollDrawdownOnlineMat(const NumericMatrix x, const int n,
+                        const int n_rows_x, const int n_cols_x,
+                        const int width, const arma::vec arma_weights,
+                        const bool runup, const bool index,
+                        const int min_obs, const arma::uvec arma_any_na,
+                        const bool na_restore, NumericMatrix rcpp_drawdown,
+                        IntegerMatrix rcpp_peak, IntegerMatrix rcpp_trough)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      runup(runup), index(index),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_drawdown(rcpp_drawdown),
+      rcpp_peak(rcpp_peak), rcpp_trough(rcpp_trough) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      int n_obs = 0;
+      RollTwoStacks<RollDrawdownMonoid> queue(std::min(width, n_rows_x));
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        if (i < width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+            n_obs += 1;
+          }
+          
+        }
+        
+        // rolling window
+        if (i >= width) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
+              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
+            
+            n_obs += 1;
+            
+          } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
+            (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+            
+            n_obs -= 1;
+            
+          }
+          
+          // at most one row leaves the window
+          if (!queue.empty() && (queue.row() <= i - width)) {
+            queue.pop_front();
+          }
+          
+        }
+        
+        // run-up is the drawdown of the negative values
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          if (runup) {
+            queue.push_back(RollDrawdownMonoid::single(-x(i, j), i), i);
+          } else {
+            queue.push_back(RollDrawdownMonoid::single(x(i, j), i), i);
+          }
+          
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (n_obs >= min_obs) {
+            
+            RollDrawdownMonoid::Entry entry = queue.query();
+            rcpp_drawdown(i, j) = entry.drawdown;
+            
+            if (index) {
+              
+              // first row of the window
+              int offset = std::max(0, i - width + 1);
+              
+              if (runup) {
+                
+                rcpp_peak(i, j) = entry.trough - offset + 1;
+                rcpp_trough(i, j) = entry.peak - offset + 1;
+                
+              } else {
+                
+                rcpp_peak(i, j) = entry.peak - offset + 1;
+                rcpp_trough(i, j) = entry.trough - offset + 1;
+                
+              }
+              
+            }
+            
+          } else {
+            
+            rcpp_drawdown(i, j) = NA_REAL;
+            
+            if (index) {
+              
+              rcpp_peak(i, j) = NA_INTEGER;
+              rcpp_trough(i, j) = NA_INTEGER;
+              
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_drawdown(i, j) = x(i, j);
+          
+          if (index) {
+            
+            rcpp_peak(i, j) = (int)x(i, j);
+            rcpp_trough(i, j) = (int)x(i, j);
+            
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollDrawdownOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool runup;
+  const bool index;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_drawdown;     // destination (pass by reference)
+  RMatrix<int> rcpp_peak;
+  RMatrix<int> rcpp_trough;
+  
+  // initialize with source and destination
+  RollDrawdownOfflineMat(const NumericMatrix x, const int n,
+                         const int n_rows_x, const int n_cols_x,
+                         const int width, const arma::vec arma_weights,
+                         const bool runup, const bool index,
+                         const int min_obs, const arma::uvec arma_any_na,
+                         const bool na_restore, NumericMatrix rcpp_drawdown,
+                         IntegerMatrix rcpp_peak, IntegerMatrix rcpp_trough)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      runup(runup), index(index),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_drawdown(rcpp_drawdown),
+      rcpp_peak(rcpp_peak), rcpp_trough(rcpp_trough) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // first row of the window
+      int offset = std::max(0, i - width + 1);
+      
+      int n_obs = 0;
+      int idxmax_x = offset;
+      int peak_x = offset;
+      int trough_x = offset;
+      double max_x = 0;
+      double drawdown_x = 0;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        // run-up is the drawdown of the negative values, where each row is
+        // a trough of the running maximum (i.e., the peak)
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+            
+            double value = runup ? -x(k, j) : x(k, j);
+            
+            if ((n_obs == 0) || (value > max_x)) {
+              
+              max_x = value;
+              idxmax_x = k;
+              
+            }
+            
+            if ((n_obs == 0) || (max_x - value > drawdown_x)) {
+              
+              drawdown_x = max_x - value;
+              peak_x = idxmax_x;
+              trough_x = k;
+              
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          
+          rcpp_drawdown(i, j) = drawdown_x;
+          
+          if (index) {
+            
+            if (runup) {
+              
+              rcpp_peak(i, j) = trough_x - offset + 1;
+              rcpp_trough(i, j) = peak_x - offset + 1;
+              
+            } else {
+              
+              rcpp_peak(i, j) = peak_x - offset + 1;
+              rcpp_trough(i, j) = trough_x - offset + 1;
+              
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_drawdown(i, j) = NA_REAL;
+          
+          if (index) {
+            
+            rcpp_peak(i, j) = NA_INTEGER;
+            rcpp_trough(i, j) = NA_INTEGER;
+            
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_drawdown(i, j) = x(i, j);
+        
+        if (index) {
+          
+          rcpp_peak(i, j) = (int)x(i, j);
+          rcpp_trough(i, j) = (int)x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollIdxQuantileOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const RVector<int> rcpp_any_na;
+  const bool na_restore;
+  RMatrix<int> rcpp_idxquantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxQuantileOnlineMat(const NumericMatrix x, const int n,
+                           const int n_rows_x, const int n_cols_x,
+                           const int width, const arma::vec arma_weights,
+                           const double p, const int min_obs,
+                           const IntegerVector rcpp_any_na, const bool na_restore,
+                           IntegerMatrix rcpp_idxquantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      p(p), min_obs(min_obs),
+      rcpp_any_na(rcpp_any_na), na_restore(na_restore),
+      rcpp_idxquantile(rcpp_idxquantile) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      long double lambda = 1;
+      long double w_new = 1;
+      
+      if ((width > 1) && (n > 1)) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      RollOrderTree tree(n_rows_x, lambda != 1);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // weight of the new row relative to the first row
+        // note: only the ratio of weights is required for the quantile
+        if (i > 0) {
+          w_new = w_new / lambda;
+        }
+        
+        // rescale the frame by a power of two to avoid overflow or underflow
+        if ((w_new > w_max) || (w_new < 1 / w_max)) {
+          
+          long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+          
+          tree.scale(scale);
+          
+          for (int k = 0; k < n_ring; k++) {
+            w_x[k] *= scale;
+          }
+          
+          w_new *= scale;
+          
+        }
+        
+        w_x[i % n_ring] = w_new;
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((rcpp_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i], w_new);
+        }
+        
+        // rolling window
+        if ((i >= width) && (rcpp_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (tree.n_obs >= min_obs) {
+            
+            bool status_avg = false;
+            int k = tree.quantile(p, status_avg);
+            
+            // lower observation if upper and lower weight is equal
+            if (status_avg && (k > 0)) {
+              k -= 1;
+            }
+            
+            rcpp_idxquantile(i, j) = rank_ix[tree.select(k)] - std::max(0, i - width + 1) + 1;
+            
+          } else {
+            rcpp_idxquantile(i, j) = NA_INTEGER;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_idxquantile(i, j) = (int)x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollIdxQuantileOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const RVector<int> rcpp_any_na;
+  const bool na_restore;
+  RMatrix<int> rcpp_idxquantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxQuantileOfflineMat(const NumericMatrix x, const int n,
+                            const int n_rows_x, const int n_cols_x,
+                            const int width, const arma::vec arma_weights,
+                            const double p, const int min_obs,
+                            const IntegerVector rcpp_any_na, const bool na_restore,
+                            IntegerMatrix rcpp_idxquantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      p(p), min_obs(min_obs),
+      rcpp_any_na(rcpp_any_na), na_restore(na_restore),
+      rcpp_idxquantile(rcpp_idxquantile) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        int n_obs = 0;
+        long double sum_w = 0;
+        long double sum_upper_w = 0;
+        
+        int offset = std::max(0, i - width + 1);
+        int n_size_x = i - offset + 1;
+        std::vector<int> rank_x(n_size_x);
+        std::vector<int> sort_ix(n_size_x);
+        
+        // similar to R's sort with 'index.return = TRUE' and ties by row
+        rank_index(x.begin() + n_rows_x * j + offset, n_size_x, rank_x, sort_ix);
+        
+        for (int count = n_size_x - 1; count >= 0; count--) {
+          
+          int k = sort_ix[count];
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((rcpp_any_na[offset + k] == 0) && !std::isnan(x(offset + k, j))) {
+            
+            // compute the sum
+            sum_w += arma_weights[n - n_size_x + k];
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          
+          int idxquantile_x = 0;
+          long double sum_upper_w_temp = 0;
+          
+          // last element of sorted array that is 'p' of 'weights'
+          // note: 'weights' must be greater than 0
+          for (int count = n_size_x - 1; count >= 0; count--) {
+            
+            int k = sort_ix[count];
+            
+            if ((rcpp_any_na[offset + k] == 0) && !std::isnan(x(offset + k, j))) {
+              
+              sum_upper_w += arma_weights[n - n_size_x + k];
+              
+              if (sum_upper_w / sum_w >= p) {
+                
+                idxquantile_x = count;
+                sum_upper_w_temp = sum_upper_w;
+                break;
+                
+              }
+              
+            }
+            
+          }
+          
+          int idxlower_x = idxquantile_x - 1;
+          
+          // don't include if 'any_na' argument is 1
+          while ((idxlower_x >= 0) && (rcpp_any_na[offset + sort_ix[idxlower_x]] != 0)) {
+            idxlower_x -= 1;
+          }
+          
+          // lower observation if upper and lower weight is equal
+          if ((idxlower_x >= 0) &&
+              (std::fabs(sum_upper_w_temp / sum_w - p) <= sqrt(arma::datum::eps))) {
+            idxquantile_x = idxlower_x;
+          }
+          
+          rcpp_idxquantile(i, j) = sort_ix[idxquantile_x] + 1;
+          
+        } else {
+          rcpp_idxquantile(i, j) = NA_INTEGER;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_idxquantile(i, j) = (int)x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollMedianOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_median;  // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMedianOnlineMat(const NumericMatrix x, const int n,
+                      const int n_rows_x, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const int min_obs, const arma::uvec arma_any_na,
+                      const bool na_restore, NumericMatrix rcpp_median)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_median(rcpp_median) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      RollMedianHeap heap;
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          heap.insert(x(i, j), i);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          heap.erase(x(i - width, j), i - width);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (heap.n_obs() >= min_obs) {
+            rcpp_median(i, j) = heap.median();
+          } else {
+            rcpp_median(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_median(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollQuantileOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_quantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileOnlineMat(const NumericMatrix x, const int n,
+                        const int n_rows_x, const int n_cols_x,
+                        const int width,  const arma::vec arma_weights,
+                        const arma::vec arma_p, const int min_obs,
+                        const arma::uvec arma_any_na, const bool na_restore,
+                        arma::cube& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      arma_p(arma_p), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_p = arma_p.size();
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      long double lambda = 1;
+      long double w_new = 1;
+      
+      if ((width > 1) && (n > 1)) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      RollOrderTree tree(n_rows_x, lambda != 1);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // weight of the new row relative to the first row
+        // note: only the ratio of weights is required for the quantile
+        if (i > 0) {
+          w_new = w_new / lambda;
+        }
+        
+        // rescale the frame by a power of two to avoid overflow or underflow
+        if ((w_new > w_max) || (w_new < 1 / w_max)) {
+          
+          long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+          
+          tree.scale(scale);
+          
+          for (int k = 0; k < n_ring; k++) {
+            w_x[k] *= scale;
+          }
+          
+          w_new *= scale;
+          
+        }
+        
+        w_x[i % n_ring] = w_new;
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i], w_new);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (tree.n_obs >= min_obs) {
+            
+            // each probability is answered from the same tree
+            for (int l = 0; l < n_p; l++) {
+              
+              bool status_avg = false;
+              int k = tree.quantile(arma_p[l], status_avg);
+              
+              // average if upper and lower weight is equal
+              if (status_avg && (k > 0)) {
+                arma_quantile(i, j, l) = (x(rank_ix[tree.select(k)], j) +
+                  x(rank_ix[tree.select(k - 1)], j)) / 2;
+              } else {
+                arma_quantile(i, j, l) = x(rank_ix[tree.select(k)], j);
+              }
+              
+            }
+            
+          } else {
+            
+            for (int l = 0; l < n_p; l++) {
+              arma_quantile(i, j, l) = NA_REAL;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, j, l) = x(i, j);
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a sorted window
+struct RollQuantileSortedMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_quantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileSortedMat(const NumericMatrix x, const int n,
+                        const int n_rows_x, const int n_cols_x,
+                        const int width,  const arma::vec arma_weights,
+                        const arma::vec arma_p, const int min_obs,
+                        const arma::uvec arma_any_na, const bool na_restore,
+                        arma::cube& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      arma_p(arma_p), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_p = arma_p.size();
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      RollSortedWindow sorted(std::min(width, n_rows_x));
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          sorted.insert(x(i, j), i);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          sorted.erase(x(i - width, j), i - width);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          int n_obs = sorted.n_obs();
+          
+          if (n_obs >= min_obs) {
+            
+            long double sum_w = 0;
+            
+            // weight of each observation is by row within the window
+            if (!status_eq) {
+              for (int k = n_obs - 1; k >= 0; k--) {
+                sum_w += arma_weights[n - 1 - i + sorted.window[k].row];
+              }
+            }
+            
+            // each probability is answered from the same sorted window
+            for (int l = 0; l < n_p; l++) {
+              
+              int k = 0;
+              bool status_avg = false;
+              
+              if (status_eq) {
+                k = n_obs - quantile_upper(n_obs, arma_p[l], status_avg);
+              } else {
+                
+                long double sum_upper_w = 0;
+                
+                // last element of sorted array that is 'p' of 'weights'
+                for (int k_upper = n_obs - 1; k_upper >= 0; k_upper--) {
+                  
+                  sum_upper_w += arma_weights[n - 1 - i + sorted.window[k_upper].row];
+                  
+                  if (sum_upper_w / sum_w >= arma_p[l]) {
+                    
+                    k = k_upper;
+                    status_avg = std::fabs(sum_upper_w / sum_w - arma_p[l]) <= sqrt(arma::datum::eps);
+                    break;
+                    
+                  }
+                  
+                }
+                
+              }
+              
+              // average if upper and lower weight is equal
+              if (status_avg && (k > 0)) {
+                arma_quantile(i, j, l) = (sorted.window[k].value + sorted.window[k - 1].value) / 2;
+              } else {
+                arma_quantile(i, j, l) = sorted.window[k].value;
+              }
+              
+            }
+            
+          } else {
+            
+            for (int l = 0; l < n_p; l++) {
+              arma_quantile(i, j, l) = NA_REAL;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, j, l) = x(i, j);
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the expanding statistic using an approximate online algorithm
+struct RollQuantileSketchMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n_rows_x;
+  const int n_cols_x;
+  const arma::vec arma_p;
+  const double error;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_quantile;    // destination (pass by reference)
+  arma::vec& arma_error;
+  
+  // initialize with source and destination
+  RollQuantileSketchMat(const NumericMatrix x, const int n_rows_x,
+                        const int n_cols_x, const arma::vec arma_p,
+                        const double error, const int min_obs,
+                        const arma::uvec arma_any_na, const bool na_restore,
+                        arma::cube& arma_quantile, arma::vec& arma_error)
+    : x(x), n_rows_x(n_rows_x),
+      n_cols_x(n_cols_x), arma_p(arma_p),
+      error(error), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_quantile(arma_quantile), arma_error(arma_error) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_p = arma_p.size();
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      RollQuantileSketch sketch(n_rows_x, error);
+      
+      arma_error[j] = 0;
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          sketch.insert(x(i, j));
+          
+          // achieved rank error relative to the number of observations
+          arma_error[j] = std::max(arma_error[j],
+                                   (double)(sketch.error_rank / sketch.n_obs));
+          
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (sketch.n_obs >= min_obs) {
+            
+            // each probability is answered from the same sketch
+            for (int l = 0; l < n_p; l++) {
+              arma_quantile(i, j, l) = sketch.quantile(arma_p[l]);
+            }
+            
+          } else {
+            
+            for (int l = 0; l < n_p; l++) {
+              arma_quantile(i, j, l) = NA_REAL;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, j, l) = x(i, j);
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollQuantileOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_quantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileOfflineMat(const NumericMatrix x, const int n,
+                         const int n_rows_x, const int n_cols_x,
+                         const int width,  const arma::vec arma_weights,
+                         const arma::vec arma_p, const int min_obs,
+                         const arma::uvec arma_any_na, const bool na_restore,
+                         arma::cube& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      arma_p(arma_p), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      int n_p = arma_p.size();
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        int k = 0;
+        int count = 0;
+        int n_obs = 0;
+        long double sum_w = 0;
+        
+        int offset = std::max(0, i - width + 1);
+        int n_size_x = i - offset + 1;
+        arma::vec x_subset(n_size_x);
+        arma::vec arma_weights_subset(n_size_x);
+        arma::uvec arma_any_na_subset(n_size_x);
+        
+        std::copy(x.begin() + n_rows_x * j + offset, x.begin() + n_rows_x * j + i + 1,
+                  x_subset.begin());
+        std::copy(arma_weights.begin() + n - n_size_x, arma_weights.begin() + n,
+                  arma_weights_subset.begin());
+        std::copy(arma_any_na.begin() + offset, arma_any_na.begin() + i + 1,
+                  arma_any_na_subset.begin());
+        
+        // similar to R's sort with 'index.return = TRUE'
+        arma::ivec sort_ix = stl_sort_index(x_subset);
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (n_size_x - 1 >= count)) {
+          
+          k = sort_ix[n_size_x - count - 1];
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na_subset[k] == 0) && !std::isnan(x_subset[k])) {
+            
+            // compute the sum
+            sum_w += arma_weights_subset[k];
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        // each probability is answered from the same sorted window
+        for (int l = 0; l < n_p; l++) {
+          
+          count = 0;
+          int idxquantile_x = 0;
+          bool status = false;
+          long double sum_upper_w = 0;
+          long double sum_upper_w_temp = 0;
+          
+          // number of observations is either the window size or,
+          // for partial results, the number of the current row
+          while (!status && (width > count) && (n_size_x - 1 >= count)) {
+            
+            k = sort_ix[n_size_x - count - 1];
+            
+            // don't include if missing value and 'any_na' argument is 1
+            // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+            if ((arma_any_na_subset[k] == 0) && !std::isnan(x_subset[k])) {
+              
+              sum_upper_w += arma_weights_subset[k];
+              
+              // last element of sorted array that is 'p' of 'weights'
+              // note: 'weights' must be greater than 0
+              if (sum_upper_w / sum_w >= arma_p[l]) {
+                
+                status = true;
+                idxquantile_x = n_size_x - count - 1;
+                sum_upper_w_temp = sum_upper_w;
+                
+              }
+              
+            }
+            
+            count += 1;
+            
+          }
+          
+          if ((n_obs >= min_obs)) {
+            
+            k = sort_ix[idxquantile_x];
+            int idxlower_x = idxquantile_x - 1;
+            
+            // don't include if 'any_na' argument is 1
+            while ((idxlower_x >= 0) && (arma_any_na_subset[sort_ix[idxlower_x]] != 0)) {
+              idxlower_x -= 1;
+            }
+            
+            // average if upper and lower weight is equal
+            if ((idxlower_x >= 0) &&
+                (std::fabs(sum_upper_w_temp / sum_w - arma_p[l]) <= sqrt(arma::datum::eps))) {
+              
+              int k_lower = sort_ix[idxlower_x];
+              arma_quantile(i, j, l) = (x_subset[k] + x_subset[k_lower]) / 2;
+              
+            } else {
+              arma_quantile(i, j, l) = x_subset[k];
+            }
+            
+          } else {
+            arma_quantile(i, j, l) = NA_REAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        for (int l = 0; l < n_p; l++) {
+          arma_quantile(i, j, l) = x(i, j);
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollEsOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_es;      // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollEsOnlineMat(const NumericMatrix x, const int n,
+                  const int n_rows_x, const int n_cols_x,
+                  const int width, const arma::vec arma_weights,
+                  const double p, const int min_obs,
+                  const arma::uvec arma_any_na, const bool na_restore,
+                  NumericMatrix rcpp_es)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      p(p), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_es(rcpp_es) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      long double lambda = 1;
+      long double w_new = 1;
+      
+      if ((width > 1) && (n > 1)) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      bool status_w = (lambda != 1);
+      RollOrderTree tree(n_rows_x, status_w, true);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // weight of the new row relative to the first row
+        // note: only the ratio of weights is required for the mean
+        if (i > 0) {
+          w_new = w_new / lambda;
+        }
+        
+        // rescale the frame by a power of two to avoid overflow or underflow
+        if ((w_new > w_max) || (w_new < 1 / w_max)) {
+          
+          long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+          
+          tree.scale(scale);
+          
+          for (int k = 0; k < n_ring; k++) {
+            w_x[k] *= scale;
+          }
+          
+          w_new *= scale;
+          
+        }
+        
+        w_x[i % n_ring] = w_new;
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i], w_new, x(i, j));
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width], w_x[(i - width) % n_ring], x(i - width, j));
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (tree.n_obs >= min_obs) {
+            
+            bool status_avg = false;
+            int k = tree.quantile(p, status_avg);
+            double quantile_x = x(rank_ix[tree.select(k)], j);
+            
+            // average if upper and lower weight is equal
+            if (status_avg && (k > 0)) {
+              quantile_x = (quantile_x + x(rank_ix[tree.select(k - 1)], j)) / 2;
+            }
+            
+            // mean of the observations less than or equal to the quantile
+            int r = rank_bound(x.begin() + n_rows_x * j, n_rows_x, rank_ix, quantile_x, true);
+            long double sum_w = status_w ? tree.sum(r) : tree.count(r);
+            
+            rcpp_es(i, j) = tree.sum_x(r) / sum_w;
+            
+          } else {
+            rcpp_es(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_es(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollEsOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_es;      // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollEsOfflineMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int width, const arma::vec arma_weights,
+                   const double p, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   NumericMatrix rcpp_es)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      p(p), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_es(rcpp_es) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x(k, j), w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double quantile_x = quantile_w(x_w, sum_w, p);
+          long double sum_lower_w = 0;
+          long double sum_lower_x = 0;
+          
+          // mean of the observations less than or equal to the quantile
+          for (std::size_t k = 0; (k < x_w.size()) && (x_w[k].first <= quantile_x); k++) {
+            
+            sum_lower_w += x_w[k].second;
+            sum_lower_x += x_w[k].second * x_w[k].first;
+            
+          }
+          
+          rcpp_es(i, j) = sum_lower_x / sum_lower_w;
+          
+        } else {
+          rcpp_es(i, j) = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_es(i, j) = x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollTrimMeanOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double trim;
+  const bool winsorize;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_mean;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollTrimMeanOnlineMat(const NumericMatrix x, const int n,
+                        const int n_rows_x, const int n_cols_x,
+                        const int width, const arma::vec arma_weights,
+                        const double trim, const bool winsorize,
+                        const int min_obs, const arma::uvec arma_any_na,
+                        const bool na_restore, NumericMatrix rcpp_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      trim(trim), winsorize(winsorize),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_mean(rcpp_mean) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      long double lambda = 1;
+      long double w_new = 1;
+      
+      if ((width > 1) && (n > 1)) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      bool status_w = (lambda != 1);
+      RollOrderTree tree(n_rows_x, status_w, true);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // weight of the new row relative to the first row
+        // note: only the ratio of weights is required for the mean
+        if (i > 0) {
+          w_new = w_new / lambda;
+        }
+        
+        // rescale the frame by a power of two to avoid overflow or underflow
+        if ((w_new > w_max) || (w_new < 1 / w_max)) {
+          
+          long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+          
+          tree.scale(scale);
+          
+          for (int k = 0; k < n_ring; k++) {
+            w_x[k] *= scale;
+          }
+          
+          w_new *= scale;
+          
+        }
+        
+        w_x[i % n_ring] = w_new;
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i], w_new, x(i, j));
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width], w_x[(i - width) % n_ring], x(i - width, j));
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (tree.n_obs >= min_obs) {
+            
+            double quantile_x[2];
+            
+            // lower and upper quantiles, where 'p' is the upper probability
+            for (int l = 0; l < 2; l++) {
+              
+              bool status_avg = false;
+              int k = tree.quantile((l == 0) ? 1 - trim : trim, status_avg);
+              
+              quantile_x[l] = x(rank_ix[tree.select(k)], j);
+              
+              // average if upper and lower weight is equal
+              if (status_avg && (k > 0)) {
+                quantile_x[l] = (quantile_x[l] + x(rank_ix[tree.select(k - 1)], j)) / 2;
+              }
+              
+            }
+            
+            int r_lower = rank_bound(x.begin() + n_rows_x * j, n_rows_x, rank_ix, quantile_x[0], false);
+            int r_upper = rank_bound(x.begin() + n_rows_x * j, n_rows_x, rank_ix, quantile_x[1], true);
+            long double sum_lower_w = status_w ? tree.sum(r_lower) : tree.count(r_lower);
+            long double sum_upper_w = status_w ? tree.sum(r_upper) : tree.count(r_upper);
+            long double sum_x = tree.sum_x(r_upper) - tree.sum_x(r_lower);
+            
+            if (winsorize) {
+              
+              // observations outside the quantiles are replaced by the quantiles
+              long double sum_w = status_w ? tree.sum(n_rows_x) : tree.n_obs;
+              
+              rcpp_mean(i, j) = (sum_x + quantile_x[0] * sum_lower_w +
+                quantile_x[1] * (sum_w - sum_upper_w)) / sum_w;
+              
+            } else if (tree.count(r_upper) > tree.count(r_lower)) {
+              
+              // observations outside the quantiles are removed
+              rcpp_mean(i, j) = sum_x / (sum_upper_w - sum_lower_w);
+              
+            } else {
+              rcpp_mean(i, j) = (quantile_x[0] + quantile_x[1]) / 2;
+            }
+            
+          } else {
+            rcpp_mean(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_mean(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollTrimMeanOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double trim;
+  const bool winsorize;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_mean;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollTrimMeanOfflineMat(const NumericMatrix x, const int n,
+                         const int n_rows_x, const int n_cols_x,
+                         const int width, const arma::vec arma_weights,
+                         const double trim, const bool winsorize,
+                         const int min_obs, const arma::uvec arma_any_na,
+                         const bool na_restore, NumericMatrix rcpp_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      trim(trim), winsorize(winsorize),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), rcpp_mean(rcpp_mean) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x(k, j), w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double quantile_lower = quantile_w(x_w, sum_w, 1 - trim);
+          double quantile_upper = quantile_w(x_w, sum_w, trim);
+          long double sum_trim_w = 0;
+          long double sum_trim_x = 0;
+          
+          for (std::size_t k = 0; k < x_w.size(); k++) {
+            
+            if (winsorize) {
+              
+              // observations outside the quantiles are replaced by the quantiles
+              double value = std::min(std::max(x_w[k].first, quantile_lower), quantile_upper);
+              
+              sum_trim_w += x_w[k].second;
+              sum_trim_x += x_w[k].second * value;
+              
+            } else if ((x_w[k].first >= quantile_lower) && (x_w[k].first <= quantile_upper)) {
+              
+              // observations outside the quantiles are removed
+              sum_trim_w += x_w[k].second;
+              sum_trim_x += x_w[k].second * x_w[k].first;
+              
+            }
+            
+          }
+          
+          if (sum_trim_w > 0) {
+            rcpp_mean(i, j) = sum_trim_x / sum_trim_w;
+          } else {
+            rcpp_mean(i, j) = (quantile_lower + quantile_upper) / 2;
+          }
+          
+        } else {
+          rcpp_mean(i, j) = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mean(i, j) = x(i, j);
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollMadOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_mad;     // destination (pass by reference)
+  RMatrix<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadOnlineMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int width, const arma::vec arma_weights,
+                   const double threshold, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   NumericMatrix rcpp_mad, LogicalMatrix rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      threshold(threshold), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      RollOrderTree tree(n_rows_x);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      
+      // k-th smallest observation in the window
+      auto value = [&](int k) { return x(rank_ix[tree.select(k)], j); };
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i]);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width]);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (tree.n_obs >= min_obs) {
+            
+            double center = 0;
+            rcpp_mad(i, j) = mad_select(tree.n_obs, value, center);
+            
+            // flag if the absolute deviation is more than 'threshold' times
+            // the scaled median absolute deviation (see R's mad)
+            if (threshold > 0) {
+              
+              if (std::isnan(x(i, j))) {
+                rcpp_outlier(i, j) = NA_LOGICAL;
+              } else {
+                rcpp_outlier(i, j) = std::fabs(x(i, j) - center) > threshold * 1.4826 * rcpp_mad(i, j);
+              }
+              
+            }
+            
+          } else {
+            
+            rcpp_mad(i, j) = NA_REAL;
+            
+            if (threshold > 0) {
+              rcpp_outlier(i, j) = NA_LOGICAL;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_mad(i, j) = x(i, j);
+          
+          if (threshold > 0) {
+            rcpp_outlier(i, j) = NA_LOGICAL;
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a sorted window
+struct RollMadSortedMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_mad;     // destination (pass by reference)
+  RMatrix<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadSortedMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int width, const arma::vec arma_weights,
+                   const double threshold, const int min_obs,
+                   const arma::uvec arma_any_na, const bool na_restore,
+                   NumericMatrix rcpp_mad, LogicalMatrix rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      threshold(threshold), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      RollSortedWindow sorted(std::min(width, n_rows_x));
+      
+      // k-th smallest observation in the window
+      auto value = [&](int k) { return sorted.window[k].value; };
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          sorted.insert(x(i, j), i);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          sorted.erase(x(i - width, j), i - width);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          if (sorted.n_obs() >= min_obs) {
+            
+            double center = 0;
+            rcpp_mad(i, j) = mad_select(sorted.n_obs(), value, center);
+            
+            // flag if the absolute deviation is more than 'threshold' times
+            // the scaled median absolute deviation (see R's mad)
+            if (threshold > 0) {
+              
+              if (std::isnan(x(i, j))) {
+                rcpp_outlier(i, j) = NA_LOGICAL;
+              } else {
+                rcpp_outlier(i, j) = std::fabs(x(i, j) - center) > threshold * 1.4826 * rcpp_mad(i, j);
+              }
+              
+            }
+            
+          } else {
+            
+            rcpp_mad(i, j) = NA_REAL;
+            
+            if (threshold > 0) {
+              rcpp_outlier(i, j) = NA_LOGICAL;
+            }
+            
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_mad(i, j) = x(i, j);
+          
+          if (threshold > 0) {
+            rcpp_outlier(i, j) = NA_LOGICAL;
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollMadOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_mad;     // destination (pass by reference)
+  RMatrix<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadOfflineMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int width, const arma::vec arma_weights,
+                    const double threshold, const int min_obs,
+                    const arma::uvec arma_any_na, const bool na_restore,
+                    NumericMatrix rcpp_mad, LogicalMatrix rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      threshold(threshold), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    std::vector<std::pair<double, long double> > dev_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        dev_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value and 'any_na' argument is 1
+          // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+          if ((arma_any_na[k] == 0) && !std::isnan(x(k, j))) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x(k, j), w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double center = quantile_w(x_w, sum_w, 0.5);
+          
+          for (std::size_t k = 0; k < x_w.size(); k++) {
+            dev_w.push_back(std::make_pair(std::fabs(x_w[k].first - center), x_w[k].second));
+          }
+          
+          std::sort(dev_w.begin(), dev_w.end());
+          rcpp_mad(i, j) = quantile_w(dev_w, sum_w, 0.5);
+          
+          // flag if the absolute deviation is more than 'threshold' times
+          // the scaled median absolute deviation (see R's mad)
+          if (threshold > 0) {
+            
+            if (std::isnan(x(i, j))) {
+              rcpp_outlier(i, j) = NA_LOGICAL;
+            } else {
+              rcpp_outlier(i, j) = std::fabs(x(i, j) - center) > threshold * 1.4826 * rcpp_mad(i, j);
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_mad(i, j) = NA_REAL;
+          
+          if (threshold > 0) {
+            rcpp_outlier(i, j) = NA_LOGICAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mad(i, j) = x(i, j);
+        
+        if (threshold > 0) {
+          rcpp_outlier(i, j) = NA_LOGICAL;
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollRankOnlineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double ties;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_rank;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollRankOnlineMat(const NumericMatrix x, const int n,
+                    const int n_rows_x, const int n_cols_x,
+                    const int width, const arma::vec arma_weights,
+                    const double ties, const int min_obs,
+                    const arma::uvec arma_any_na, const bool na_restore,
+                    NumericMatrix rcpp_rank)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      ties(ties), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_rank(rcpp_rank) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<int> ties_lower(n_rows_x);
+    std::vector<int> ties_upper(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    for (std::size_t j = begin_col; j < end_col; j++) {
+      
+      long double lambda = 1;
+      long double w_new = 1;
+      
+      if ((width > 1) && (n > 1)) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      }
+      
+      bool status_w = (lambda != 1);
+      RollOrderTree tree(n_rows_x, status_w);
+      
+      // similar to R's rank with 'ties.method = "first"'
+      rank_index(x.begin() + n_rows_x * j, n_rows_x, rank_x, rank_ix);
+      rank_ties(x.begin() + n_rows_x * j, n_rows_x, rank_ix, ties_lower, ties_upper);
+      
+      for (int i = 0; i < n_rows_x; i++) {
+        
+        // weight of the new row relative to the first row
+        // note: only the ratio of weights is required for the rank
+        if (i > 0) {
+          w_new = w_new / lambda;
+        }
+        
+        // rescale the frame by a power of two to avoid overflow or underflow
+        if ((w_new > w_max) || (w_new < 1 / w_max)) {
+          
+          long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+          
+          tree.scale(scale);
+          
+          for (int k = 0; k < n_ring; k++) {
+            w_x[k] *= scale;
+          }
+          
+          w_new *= scale;
+          
+        }
+        
+        w_x[i % n_ring] = w_new;
+        
+        // expanding window
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          tree.insert(rank_x[i], w_new);
+        }
+        
+        // rolling window
+        if ((i >= width) && (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
+          tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          // current observation must be within the window
+          if ((tree.n_obs >= min_obs) && (arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+            
+            int lower = ties_lower[rank_x[i]];
+            int upper = ties_upper[rank_x[i]];
+            
+            // fraction of the window below the current observation, where
+            // 'ties' is the fraction of other equal observations that are below
+            if (status_w) {
+              
+              long double sum_w = tree.sum(n_rows_x);
+              long double sum_lower_w = tree.sum(lower);
+              long double sum_ties_w = tree.sum(upper) - sum_lower_w - w_new;
+              
+              rcpp_rank(i, j) = (sum_lower_w + ties * sum_ties_w) / sum_w;
+              
+            } else {
+              
+              int n_lower = tree.count(lower);
+              int n_ties = tree.count(upper) - n_lower - 1;
+              
+              rcpp_rank(i, j) = (n_lower + ties * n_ties) / tree.n_obs;
+              
+            }
+            
+          } else {
+            rcpp_rank(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          rcpp_rank(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollRankOfflineMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double ties;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  RMatrix<double> rcpp_rank;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollRankOfflineMat(const NumericMatrix x, const int n,
+                     const int n_rows_x, const int n_cols_x,
+                     const int width, const arma::vec arma_weights,
+                     const double ties, const int min_obs,
+                     const arma::uvec arma_any_na, const bool na_restore,
+                     NumericMatrix rcpp_rank)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      ties(ties), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      rcpp_rank(rcpp_rank) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z / n_cols_x;
+      int j = z % n_cols_x;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+        
+        int count = 0;
         int n_obs = 0;
-        int idxquantile_x = 0;
-        bool status = false;
-        long double sum_upper_w = 0;
-        long double sum_upper_w_temp = 0;
+        long double sum_w = 0;
+        long double sum_lower_w = 0;
+        long double sum_ties_w = 0;
         
         // number of observations is either the window size or,
         // for partial results, the number of the current row
-        while ((width > count) && (n_size_x - 1 >= count)) {
-          
-          k = sort_ix[n_size_x - count - 1];
+        while ((width > count) && (i >= count)) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-          if ((arma_any_na_subset[k] == 0) && !std::isnan(x_subset[k])) {
+          if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j))) {
             
-            sum_upper_w += arma_weights_subset[k];
+            sum_w += arma_weights[n - count - 1];
             
-            // last element of sorted array that is 'p' of 'weights'
-            // note: 'weights' must be greater than 0
-            if (!status && (sum_upper_w / sum_w >= p)) {
-              
-              status = true;
-              idxquantile_x = n_size_x - count - 1;
-              sum_upper_w_temp = sum_upper_w;
-              
+            if (x(i - count, j) < x(i, j)) {
+              sum_lower_w += arma_weights[n - count - 1];
+            } else if ((count > 0) && (x(i - count, j) == x(i, j))) {
+              sum_ties_w += arma_weights[n - count - 1];
             }
             
             n_obs += 1;
@@ -2134,28 +5358,17 @@ struct RollQuantileOfflineMat : public Worker {
           
         }
         
-        if ((n_obs >= min_obs)) {
-          
-          k = sort_ix[idxquantile_x];
-          
-          // average if upper and lower weight is equal
-          if (std::fabs(sum_upper_w_temp / sum_w - p) <= sqrt(arma::datum::eps)) {
-            
-            int k_lower = sort_ix[idxquantile_x - 1];
-            rcpp_quantile(i, j) = (x_subset[k] + x_subset[k_lower]) / 2;
-            
-          } else {
-            rcpp_quantile(i, j) = x_subset[k];
-          }
-          
+        // current observation must be within the window
+        if ((n_obs >= min_obs) && (arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          rcpp_rank(i, j) = (sum_lower_w + ties * sum_ties_w) / sum_w;
         } else {
-          rcpp_quantile(i, j) = NA_REAL;
+          rcpp_rank(i, j) = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_quantile(i, j) = x(i, j);
+        rcpp_rank(i, j) = x(i, j);
         
       }
       
@@ -2165,50 +5378,65 @@ struct RollQuantileOfflineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollVarOnlineMat : public Worker {
   
+  typedef typename Accum::value_type value_type;
+  
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const bool center;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
+  const int reanchor;
   arma::mat& arma_var;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollVarOnlineMat(const NumericMatrix x, const int n,
                    const int n_rows_x, const int n_cols_x,
-                   const int width, const arma::vec arma_weights,
-                   const bool center, const int min_obs,
-                   const arma::uvec arma_any_na, const bool na_restore,
-                   arma::mat& arma_var)
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const bool center,
+                   const int min_obs, const arma::uvec arma_any_na,
+                   const bool na_restore, const int reanchor,
+                   arma::mat& arma_var, arma::vec& arma_reanchor)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      center(center), min_obs(min_obs),
-      arma_any_na(arma_any_na), na_restore(na_restore),
-      arma_var(arma_var) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), reanchor(reanchor),
+      arma_var(arma_var), arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
       int n_obs = 0;
-      long double lambda = 0;
-      long double w_new = 0;
-      long double w_old = 0; 
-      long double x_new = 0;
-      long double x_old = 0;
-      long double sum_w = 0;
-      long double sum_x = 0;
-      long double sumsq_w = 0;
-      long double sumsq_x = 0;
-      long double mean_prev_x = 0;
-      long double mean_x = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0; 
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
+      Accum sumsq_w;
+      Accum sumsq_x;
+      value_type mean_prev_x = 0;
+      value_type mean_x = 0;
       
       if (width > 1) {
         lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -2216,7 +5444,7 @@ struct RollVarOnlineMat : public Worker {
         lambda = arma_weights[n - 1];
       }
       
-      for (int i = 0; i < n_rows_x; i++) {
+      for (int i = offset; i < end_row; i++) {
         
         if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
           
@@ -2231,7 +5459,7 @@ struct RollVarOnlineMat : public Worker {
         }
         
         // expanding window
-        if (i < width) {
+        if (i < offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -2241,15 +5469,18 @@ struct RollVarOnlineMat : public Worker {
           
           if (width > 1) {
             
-            sum_w = lambda * sum_w + w_new;
-            sum_x = lambda * sum_x + w_new * x_new;
-            sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
             
           } else {
             
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            sumsq_w = pow(w_new, (long double)2.0);
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
             
           }
           
@@ -2257,31 +5488,31 @@ struct RollVarOnlineMat : public Worker {
             
             // compute the mean
             mean_prev_x = mean_x;
-            mean_x = sum_x / sum_w;
+            mean_x = sum_x.value() / sum_w.value();
             
           }
           
           // compute the sum of squares
           if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && (n_obs > 1)) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
             (n_obs == 1) && !center) {
             
-            sumsq_x = w_new * pow(x_new, (long double)2.0);
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
             
           }
           
         }
         
         // rolling window
-        if (i >= width) {
+        if (i >= offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -2311,16 +5542,21 @@ struct RollVarOnlineMat : public Worker {
           
           if (width > 1) {
             
-            sum_w = lambda * sum_w + w_new - lambda * w_old;
-            sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-            sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-              pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
             
           } else {
             
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            sumsq_w = pow(w_new, (long double)2.0);
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
             
           }
           
@@ -2328,7 +5564,7 @@ struct RollVarOnlineMat : public Worker {
             
             // compute the mean
             mean_prev_x = mean_x;
-            mean_x = sum_x / sum_w;
+            mean_x = sum_x.value() / sum_w.value();
             
           }
           
@@ -2336,36 +5572,60 @@ struct RollVarOnlineMat : public Worker {
           if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
               (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
             ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
             (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) ||
             (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           }
           
         }
         
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(&x(0, j), &x(0, j), arma_any_na.memptr(),
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, center);
+          
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sumsq_x.value() - exact.sumsq_x));
+          }
+          
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
+          sumsq_w.set(exact.sumsq_w);
+          sumsq_x.set(exact.sumsq_x);
+          mean_x = exact.mean_x;
+          
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
           if ((n_obs > 1) && (n_obs >= min_obs)) {
-            arma_var(i, j) = sumsq_x / (sum_w - sumsq_w / sum_w);
+            arma_var(i, j) = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
           } else {
             arma_var(i, j) = NA_REAL;
           }
@@ -2506,52 +5766,295 @@ struct RollVarOfflineMat : public Worker {
   
 };
 
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollVarPrefixMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_var;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollVarPrefixMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const bool center,
+                   const int min_obs, const arma::uvec arma_any_na,
+                   const bool na_restore, arma::mat& arma_var)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_var(arma_var) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 2, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          // shift by the first finite observation if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x(i, j))) {
+            
+            x_ref = x(i, j);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = value[0] * value[0];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            
+            arma_var(i, j) = sumsq_x / (sum_w - sumsq_w / sum_w);
+            
+          } else {
+            arma_var(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_var(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollVarLinearMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_var;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollVarLinearMat(const NumericMatrix x, const int n,
+                   const int n_rows_x, const int n_cols_x,
+                   const int n_rows_chunk, const int width,
+                   const arma::vec arma_weights, const bool center,
+                   const int min_obs, const arma::uvec arma_any_na,
+                   const bool na_restore, arma::mat& arma_var)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_var(arma_var) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 2, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          // shift by the first observation if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x(i, j);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = value[0] * value[0];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            
+            arma_var(i, j) = sumsq_x / (sum_w - sumsq_w / sum_w);
+            
+          } else {
+            arma_var(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_var(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollSdOnlineMat : public Worker {
   
+  typedef typename Accum::value_type value_type;
+  
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_x;
   const int n_cols_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const bool center;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
+  const int reanchor;
   arma::mat& arma_sd;         // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollSdOnlineMat(const NumericMatrix x, const int n,
                   const int n_rows_x, const int n_cols_x,
-                  const int width, const arma::vec arma_weights,
-                  const bool center, const int min_obs,
-                  const arma::uvec arma_any_na, const bool na_restore,
-                  arma::mat& arma_sd)
+                  const int n_rows_chunk, const int width,
+                  const arma::vec arma_weights, const bool center,
+                  const int min_obs, const arma::uvec arma_any_na,
+                  const bool na_restore, const int reanchor,
+                  arma::mat& arma_sd, arma::vec& arma_reanchor)
     : x(x), n(n),
       n_rows_x(n_rows_x), n_cols_x(n_cols_x),
-      width(width), arma_weights(arma_weights),
-      center(center), min_obs(min_obs),
-      arma_any_na(arma_any_na), na_restore(na_restore),
-      arma_sd(arma_sd) { }
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), reanchor(reanchor),
+      arma_sd(arma_sd), arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by column
-  void operator()(std::size_t begin_col, std::size_t end_col) {
-    for (std::size_t j = begin_col; j < end_col; j++) {
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
       int n_obs = 0;
-      long double lambda = 0;
-      long double w_new = 0;
-      long double w_old = 0; 
-      long double x_new = 0;
-      long double x_old = 0;
-      long double sum_w = 0;
-      long double sum_x = 0;
-      long double sumsq_w = 0;
-      long double sumsq_x = 0;
-      long double mean_prev_x = 0;
-      long double mean_x = 0;
-      long double var_x = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0; 
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
+      Accum sumsq_w;
+      Accum sumsq_x;
+      value_type mean_prev_x = 0;
+      value_type mean_x = 0;
+      value_type var_x = 0;
       
       if (width > 1) {
         lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -2559,7 +6062,7 @@ struct RollSdOnlineMat : public Worker {
         lambda = arma_weights[n - 1];
       }
       
-      for (int i = 0; i < n_rows_x; i++) {
+      for (int i = offset; i < end_row; i++) {
         
         if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
           
@@ -2574,7 +6077,7 @@ struct RollSdOnlineMat : public Worker {
         }
         
         // expanding window
-        if (i < width) {
+        if (i < offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -2584,15 +6087,18 @@ struct RollSdOnlineMat : public Worker {
           
           if (width > 1) {
             
-            sum_w = lambda * sum_w + w_new;
-            sum_x = lambda * sum_x + w_new * x_new;
-            sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
             
           } else {
             
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            sumsq_w = pow(w_new, (long double)2.0);
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
             
           }
           
@@ -2600,33 +6106,33 @@ struct RollSdOnlineMat : public Worker {
             
             // compute the mean
             mean_prev_x = mean_x;
-            mean_x = sum_x / sum_w;
+            mean_x = sum_x.value() / sum_w.value();
             
           }
           
           // compute the sum of squares
           if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && (n_obs > 1)) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j))) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
             (n_obs == 1) && !center) {
             
-            sumsq_x = w_new * pow(x_new, (long double)2.0);
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
             
           }
           
-          var_x = sumsq_x / (sum_w - sumsq_w / sum_w);
+          var_x = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
           
         }
         
         // rolling window
-        if (i >= width) {
+        if (i >= offset + width) {
           
           // don't include if missing value and 'any_na' argument is 1
           // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
@@ -2656,16 +6162,21 @@ struct RollSdOnlineMat : public Worker {
           
           if (width > 1) {
             
-            sum_w = lambda * sum_w + w_new - lambda * w_old;
-            sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-            sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-              pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
             
           } else {
             
-            sum_w = w_new;
-            sum_x = w_new * x_new;
-            sumsq_w = pow(w_new, (long double)2.0);
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
             
           }
           
@@ -2673,7 +6184,7 @@ struct RollSdOnlineMat : public Worker {
             
             // compute the mean
             mean_prev_x = mean_x;
-            mean_x = sum_x / sum_w;
+            mean_x = sum_x.value() / sum_w.value();
             
           }
           
@@ -2681,33 +6192,57 @@ struct RollSdOnlineMat : public Worker {
           if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
               (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) &&
             ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)))) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j))) &&
             (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) ||
             (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j))) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           }
           
-          var_x = sumsq_x / (sum_w - sumsq_w / sum_w);
+          var_x = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
           
         }
         
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(&x(0, j), &x(0, j), arma_any_na.memptr(),
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, center);
+          
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sumsq_x.value() - exact.sumsq_x));
+          }
+          
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
+          sumsq_w.set(exact.sumsq_w);
+          sumsq_x.set(exact.sumsq_x);
+          mean_x = exact.mean_x;
+          
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
         // don't compute if missing value and 'na_restore' argument is TRUE
         if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
           
@@ -2859,6 +6394,234 @@ struct RollSdOfflineMat : public Worker {
   
 };
 
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollSdPrefixMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_sd;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollSdPrefixMat(const NumericMatrix x, const int n,
+                  const int n_rows_x, const int n_cols_x,
+                  const int n_rows_chunk, const int width,
+                  const arma::vec arma_weights, const bool center,
+                  const int min_obs, const arma::uvec arma_any_na,
+                  const bool na_restore, arma::mat& arma_sd)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_sd(arma_sd) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 2, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          // shift by the first finite observation if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x(i, j))) {
+            
+            x_ref = x(i, j);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = value[0] * value[0];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            
+            arma_sd(i, j) = sqrt(sumsq_x / (sum_w - sumsq_w / sum_w));
+            
+          } else {
+            arma_sd(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sd(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollSdLinearMat : public Worker {
+  
+  const RMatrix<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::mat& arma_sd;         // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollSdLinearMat(const NumericMatrix x, const int n,
+                  const int n_rows_x, const int n_cols_x,
+                  const int n_rows_chunk, const int width,
+                  const arma::vec arma_weights, const bool center,
+                  const int min_obs, const arma::uvec arma_any_na,
+                  const bool na_restore, arma::mat& arma_sd)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_sd(arma_sd) { }
+  
+  // function call operator that iterates by column and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (i.e., the column and the chunk of rows),
+      // where each chunk is warmed up on the previous 'width' rows
+      int j = z % n_cols_x;
+      int begin_row = (z / n_cols_x) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 2, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j))) {
+          
+          // shift by the first observation if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x(i, j);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = value[0] * value[0];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            
+            arma_sd(i, j) = sqrt(sumsq_x / (sum_w - sumsq_w / sum_w));
+            
+          } else {
+            arma_sd(i, j) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sd(i, j) = x(i, j);
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
 // 'Worker' function for computing the rolling statistic using an online algorithm
 struct RollScaleOnlineMat : public Worker {
   
@@ -3280,8 +7043,11 @@ struct RollScaleOfflineMat : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollCovOnlineMatXX : public Worker {
   
+  typedef typename Accum::value_type value_type;
+  
   const RMatrix<double> x;      // source
   const int n;
   const int n_rows_xy;
@@ -3293,7 +7059,9 @@ struct RollCovOnlineMatXX : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
+  const int reanchor;
   arma::cube& arma_cov;         // destination (pass by reference)
+  arma::mat& arma_reanchor;
   
   // initialize with source and destination
   RollCovOnlineMatXX(const NumericMatrix x, const int n,
@@ -3301,13 +7069,15 @@ struct RollCovOnlineMatXX : public Worker {
                      const int width, const arma::vec arma_weights,
                      const bool center, const bool scale,
                      const int min_obs, const arma::uvec arma_any_na,
-                     const bool na_restore, arma::cube& arma_cov)
+                     const bool na_restore, const int reanchor,
+                     arma::cube& arma_cov, arma::mat& arma_reanchor)
     : x(x), n(n),
       n_rows_xy(n_rows_xy), n_cols_x(n_cols_x),
       width(width), arma_weights(arma_weights),
       center(center), scale(scale),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_cov(arma_cov) { }
+      na_restore(na_restore), reanchor(reanchor),
+      arma_cov(arma_cov), arma_reanchor(arma_reanchor) { }
   
   // function call operator that iterates by column
   void operator()(std::size_t begin_col, std::size_t end_col) {
@@ -3315,24 +7085,24 @@ struct RollCovOnlineMatXX : public Worker {
       for (std::size_t k = 0; k <= j; k++) {
         
         int n_obs = 0;
-        long double lambda = 0;
-        long double w_new = 0;
-        long double w_old = 0;      
-        long double x_new = 0;
-        long double x_old = 0;
-        long double y_new = 0;
-        long double y_old = 0;
-        long double sum_w = 0;
-        long double sum_x = 0;
-        long double sum_y = 0;
-        long double sumsq_w = 0;
-        long double sumsq_x = 0;
-        long double sumsq_y = 0;
-        long double sumsq_xy = 0;
-        long double mean_prev_x = 0;
-        long double mean_prev_y = 0;
-        long double mean_x = 0;
-        long double mean_y = 0;
+        value_type lambda = 0;
+        value_type w_new = 0;
+        value_type w_old = 0;      
+        value_type x_new = 0;
+        value_type x_old = 0;
+        value_type y_new = 0;
+        value_type y_old = 0;
+        Accum sum_w;
+        Accum sum_x;
+        Accum sum_y;
+        Accum sumsq_w;
+        Accum sumsq_x;
+        Accum sumsq_y;
+        Accum sumsq_xy;
+        value_type mean_prev_x = 0;
+        value_type mean_prev_y = 0;
+        value_type mean_x = 0;
+        value_type mean_y = 0;
         
         if (width > 1) {
           lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -3367,17 +7137,21 @@ struct RollCovOnlineMatXX : public Worker {
             
             if (width > 1) {
               
-              sum_w = lambda * sum_w + w_new;
-              sum_x = lambda * sum_x + w_new * x_new;
-              sum_y = lambda * sum_y + w_new * y_new;
-              sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+              sum_w.scale(lambda);
+              sum_w.add(w_new);
+              sum_x.scale(lambda);
+              sum_x.add(w_new * x_new);
+              sum_y.scale(lambda);
+              sum_y.add(w_new * y_new);
+              sumsq_w.scale(pow(lambda, (value_type)2.0));
+              sumsq_w.add(pow(w_new, (value_type)2.0));
               
             } else {
               
-              sum_w = w_new;
-              sum_x = w_new * x_new;
-              sum_y = w_new * y_new;
-              sumsq_w = pow(w_new, (long double)2.0);
+              sum_w.set(w_new);
+              sum_x.set(w_new * x_new);
+              sum_y.set(w_new * y_new);
+              sumsq_w.set(pow(w_new, (value_type)2.0));
               
             }
             
@@ -3386,8 +7160,8 @@ struct RollCovOnlineMatXX : public Worker {
               // compute the mean
               mean_prev_x = mean_x;
               mean_prev_y = mean_y;
-              mean_x = sum_x / sum_w;
-              mean_y = sum_y / sum_w;
+              mean_x = sum_x.value() / sum_w.value();
+              mean_y = sum_y.value() / sum_w.value();
               
             }
             
@@ -3397,21 +7171,21 @@ struct RollCovOnlineMatXX : public Worker {
               if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                   (n_obs > 1)) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
                 
               } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k))) {
                 
-                sumsq_x = lambda * sumsq_x;
-                sumsq_y = lambda * sumsq_y;
+                sumsq_x.scale(lambda);
+                sumsq_y.scale(lambda);
                 
               } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                 (n_obs == 1) && !center) {
                 
-                sumsq_x = w_new * pow(x_new, (long double)2.0);
-                sumsq_y = w_new * pow(y_new, (long double)2.0);
+                sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
+                sumsq_y.set(w_new * pow(y_new, (value_type)2.0));
                 
               }
               
@@ -3421,17 +7195,17 @@ struct RollCovOnlineMatXX : public Worker {
             if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                 (n_obs > 1)) {
               
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y);
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
               
             } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k))) {
               
-              sumsq_xy = lambda * sumsq_xy;
+              sumsq_xy.scale(lambda);
               
             } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
               (n_obs == 1) && !center) {
               
-              sumsq_xy = w_new * x_new * y_new;
+              sumsq_xy.set(w_new * x_new * y_new);
               
             }
             
@@ -3470,18 +7244,25 @@ struct RollCovOnlineMatXX : public Worker {
             
             if (width > 1) {
               
-              sum_w = lambda * sum_w + w_new - lambda * w_old;
-              sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-              sum_y = lambda * sum_y + w_new * y_new - lambda * w_old * y_old;
-              sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-                pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+              sum_w.scale(lambda);
+              sum_w.add(w_new);
+              sum_w.add(-(lambda * w_old));
+              sum_x.scale(lambda);
+              sum_x.add(w_new * x_new);
+              sum_x.add(-(lambda * w_old * x_old));
+              sum_y.scale(lambda);
+              sum_y.add(w_new * y_new);
+              sum_y.add(-(lambda * w_old * y_old));
+              sumsq_w.scale(pow(lambda, (value_type)2.0));
+              sumsq_w.add(pow(w_new, (value_type)2.0));
+              sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
               
             } else {
               
-              sum_w = w_new;
-              sum_x = w_new * x_new;
-              sum_y = w_new * y_new;
-              sumsq_w = pow(w_new, (long double)2.0);
+              sum_w.set(w_new);
+              sum_x.set(w_new * x_new);
+              sum_y.set(w_new * y_new);
+              sumsq_w.set(pow(w_new, (value_type)2.0));
               
             }
             
@@ -3490,8 +7271,8 @@ struct RollCovOnlineMatXX : public Worker {
               // compute the mean
               mean_prev_x = mean_x;
               mean_prev_y = mean_y;
-              mean_x = sum_x / sum_w;
-              mean_y = sum_y / sum_w;
+              mean_x = sum_x.value() / sum_w.value();
+              mean_y = sum_y.value() / sum_w.value();
               
             }
             
@@ -3501,34 +7282,34 @@ struct RollCovOnlineMatXX : public Worker {
               if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                   (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(x(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-                  lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y) -
-                  lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
+                sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
                 
               } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                 ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(x(i - width, k)))) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
                 
               } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k))) &&
                 (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(x(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x -
-                  lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-                sumsq_y = lambda * sumsq_y -
-                  lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
                 
               } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k)) ||
                 (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(x(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x;
-                sumsq_y = lambda * sumsq_y;
+                sumsq_x.scale(lambda);
+                sumsq_y.scale(lambda);
                 
               }
               
@@ -3538,31 +7319,53 @@ struct RollCovOnlineMatXX : public Worker {
             if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
                 (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(x(i - width, k))) {
               
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y) -
-                lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
+              sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
               
             } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k)) &&
               ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(x(i - width, k)))) {
               
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y);
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
               
             } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k))) &&
               (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(x(i - width, k))) {
               
-              sumsq_xy = lambda * sumsq_xy -
-                lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
               
             } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(x(i, k)) ||
               (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(x(i - width, k))) {
               
-              sumsq_xy = lambda * sumsq_xy;
+              sumsq_xy.scale(lambda);
               
             }
             
           }
           
+          // recompute the sums of the window every 'reanchor' rows
+          if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+            
+            RollReanchor exact(&x(0, j), &x(0, k), arma_any_na.memptr(),
+                               std::max(0, i - width + 1), i,
+                               n, arma_weights, center);
+            
+            arma_reanchor(j, k) = std::max(arma_reanchor(j, k), (double)std::abs(sumsq_xy.value() - exact.sumsq_xy));
+            arma_reanchor(k, j) = arma_reanchor(j, k);
+            
+            sum_w.set(exact.sum_w);
+            sum_x.set(exact.sum_x);
+            sum_y.set(exact.sum_y);
+            sumsq_w.set(exact.sumsq_w);
+            sumsq_x.set(exact.sumsq_x);
+            sumsq_y.set(exact.sumsq_y);
+            sumsq_xy.set(exact.sumsq_xy);
+            mean_x = exact.mean_x;
+            mean_y = exact.mean_y;
+            
+          }
+          
           // don't compute if missing value and 'na_restore' argument is TRUE
           if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
               !std::isnan(x(i, k)))) {
@@ -3572,17 +7375,17 @@ struct RollCovOnlineMatXX : public Worker {
                 if (scale) {
                   
                   // don't compute if the standard deviation is zero
-                  if ((sumsq_x < 0) || (sumsq_y < 0) ||
-                      (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+                  if ((sumsq_x.value() < 0) || (sumsq_y.value() < 0) ||
+                      (sqrt(sumsq_x.value()) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y.value()) <= sqrt(arma::datum::eps))) {
                     
                     arma_cov(j, k, i) = NA_REAL;
                     
                   } else {
-                    arma_cov(j, k, i) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+                    arma_cov(j, k, i) = sumsq_xy.value() / (sqrt(sumsq_x.value()) * sqrt(sumsq_y.value()));
                   }
                   
                 } else if (!scale) {
-                  arma_cov(j, k, i) = sumsq_xy / (sum_w - sumsq_w / sum_w);
+                  arma_cov(j, k, i) = sumsq_xy.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
                 }
                 
               } else {
@@ -3612,8 +7415,11 @@ struct RollCovOnlineMatXX : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollCovOnlineMatXY : public Worker {
   
+  typedef typename Accum::value_type value_type;
+  
   const RMatrix<double> x;      // source
   const RMatrix<double> y;      // source
   const int n;
@@ -3627,7 +7433,9 @@ struct RollCovOnlineMatXY : public Worker {
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
+  const int reanchor;
   arma::cube& arma_cov;         // destination (pass by reference)
+  arma::mat& arma_reanchor;
   
   // initialize with source and destination
   RollCovOnlineMatXY(const NumericMatrix x, const NumericMatrix y,
@@ -3636,14 +7444,16 @@ struct RollCovOnlineMatXY : public Worker {
                      const int width, const arma::vec arma_weights,
                      const bool center, const bool scale,
                      const int min_obs, const arma::uvec arma_any_na,
-                     const bool na_restore, arma::cube& arma_cov)
+                     const bool na_restore, const int reanchor,
+                     arma::cube& arma_cov, arma::mat& arma_reanchor)
     : x(x), y(y),
       n(n), n_rows_xy(n_rows_xy),
       n_cols_x(n_cols_x), n_cols_y(n_cols_y),
       width(width), arma_weights(arma_weights),
       center(center), scale(scale),
       min_obs(min_obs), arma_any_na(arma_any_na),
-      na_restore(na_restore), arma_cov(arma_cov) { }
+      na_restore(na_restore), reanchor(reanchor),
+      arma_cov(arma_cov), arma_reanchor(arma_reanchor) { }
   
   // function call operator that iterates by column
   void operator()(std::size_t begin_col, std::size_t end_col) {
@@ -3651,24 +7461,24 @@ struct RollCovOnlineMatXY : public Worker {
       for (int k = 0; k <= n_cols_y - 1; k++) {
         
         int n_obs = 0;
-        long double lambda = 0;
-        long double w_new = 0;
-        long double w_old = 0;      
-        long double x_new = 0;
-        long double x_old = 0;
-        long double y_new = 0;
-        long double y_old = 0;
-        long double sum_w = 0;
-        long double sum_x = 0;
-        long double sum_y = 0;
-        long double sumsq_w = 0;
-        long double sumsq_x = 0;
-        long double sumsq_y = 0;
-        long double sumsq_xy = 0;
-        long double mean_prev_x = 0;
-        long double mean_prev_y = 0;
-        long double mean_x = 0;
-        long double mean_y = 0;
+        value_type lambda = 0;
+        value_type w_new = 0;
+        value_type w_old = 0;      
+        value_type x_new = 0;
+        value_type x_old = 0;
+        value_type y_new = 0;
+        value_type y_old = 0;
+        Accum sum_w;
+        Accum sum_x;
+        Accum sum_y;
+        Accum sumsq_w;
+        Accum sumsq_x;
+        Accum sumsq_y;
+        Accum sumsq_xy;
+        value_type mean_prev_x = 0;
+        value_type mean_prev_y = 0;
+        value_type mean_x = 0;
+        value_type mean_y = 0;
         
         if (width > 1) {
           lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -3703,17 +7513,21 @@ struct RollCovOnlineMatXY : public Worker {
             
             if (width > 1) {
               
-              sum_w = lambda * sum_w + w_new;
-              sum_x = lambda * sum_x + w_new * x_new;
-              sum_y = lambda * sum_y + w_new * y_new;
-              sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+              sum_w.scale(lambda);
+              sum_w.add(w_new);
+              sum_x.scale(lambda);
+              sum_x.add(w_new * x_new);
+              sum_y.scale(lambda);
+              sum_y.add(w_new * y_new);
+              sumsq_w.scale(pow(lambda, (value_type)2.0));
+              sumsq_w.add(pow(w_new, (value_type)2.0));
               
             } else {
               
-              sum_w = w_new;
-              sum_x = w_new * x_new;
-              sum_y = w_new * y_new;
-              sumsq_w = pow(w_new, (long double)2.0);
+              sum_w.set(w_new);
+              sum_x.set(w_new * x_new);
+              sum_y.set(w_new * y_new);
+              sumsq_w.set(pow(w_new, (value_type)2.0));
               
             }
             
@@ -3722,8 +7536,8 @@ struct RollCovOnlineMatXY : public Worker {
               // compute the mean
               mean_prev_x = mean_x;
               mean_prev_y = mean_y;
-              mean_x = sum_x / sum_w;
-              mean_y = sum_y / sum_w;
+              mean_x = sum_x.value() / sum_w.value();
+              mean_y = sum_y.value() / sum_w.value();
               
             }
             
@@ -3733,21 +7547,21 @@ struct RollCovOnlineMatXY : public Worker {
               if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
                   (n_obs > 1)) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
                 
               } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k))) {
                 
-                sumsq_x = lambda * sumsq_x;
-                sumsq_y = lambda * sumsq_y;
+                sumsq_x.scale(lambda);
+                sumsq_y.scale(lambda);
                 
               } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
                 (n_obs == 1) && !center) {
                 
-                sumsq_x = w_new * pow(x_new, (long double)2.0);
-                sumsq_y = w_new * pow(y_new, (long double)2.0);
+                sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
+                sumsq_y.set(w_new * pow(y_new, (value_type)2.0));
                 
               }
               
@@ -3757,17 +7571,17 @@ struct RollCovOnlineMatXY : public Worker {
             if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
                 (n_obs > 1)) {
               
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y);
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
               
             } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k))) {
               
-              sumsq_xy = lambda * sumsq_xy;
+              sumsq_xy.scale(lambda);
               
             } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
               (n_obs == 1) && !center) {
               
-              sumsq_xy = w_new * x_new * y_new;
+              sumsq_xy.set(w_new * x_new * y_new);
               
             }
             
@@ -3806,18 +7620,25 @@ struct RollCovOnlineMatXY : public Worker {
             
             if (width > 1) {
               
-              sum_w = lambda * sum_w + w_new - lambda * w_old;
-              sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-              sum_y = lambda * sum_y + w_new * y_new - lambda * w_old * y_old;
-              sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-                pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+              sum_w.scale(lambda);
+              sum_w.add(w_new);
+              sum_w.add(-(lambda * w_old));
+              sum_x.scale(lambda);
+              sum_x.add(w_new * x_new);
+              sum_x.add(-(lambda * w_old * x_old));
+              sum_y.scale(lambda);
+              sum_y.add(w_new * y_new);
+              sum_y.add(-(lambda * w_old * y_old));
+              sumsq_w.scale(pow(lambda, (value_type)2.0));
+              sumsq_w.add(pow(w_new, (value_type)2.0));
+              sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
               
             } else {
               
-              sum_w = w_new;
-              sum_x = w_new * x_new;
-              sum_y = w_new * y_new;
-              sumsq_w = pow(w_new, (long double)2.0);
+              sum_w.set(w_new);
+              sum_x.set(w_new * x_new);
+              sum_y.set(w_new * y_new);
+              sumsq_w.set(pow(w_new, (value_type)2.0));
               
             }
             
@@ -3826,8 +7647,8 @@ struct RollCovOnlineMatXY : public Worker {
               // compute the mean
               mean_prev_x = mean_x;
               mean_prev_y = mean_y;
-              mean_x = sum_x / sum_w;
-              mean_y = sum_y / sum_w;
+              mean_x = sum_x.value() / sum_w.value();
+              mean_y = sum_y.value() / sum_w.value();
               
             }
             
@@ -3837,120 +7658,341 @@ struct RollCovOnlineMatXY : public Worker {
               if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
                   (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-                  lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y) -
-                  lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
+                sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
                 
               } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
                 ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k)))) {
                 
-                sumsq_x = lambda * sumsq_x +
-                  w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-                sumsq_y = lambda * sumsq_y +
-                  w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
                 
               } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k))) &&
                 (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x -
-                  lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-                sumsq_y = lambda * sumsq_y -
-                  lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+                sumsq_x.scale(lambda);
+                sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+                sumsq_y.scale(lambda);
+                sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
                 
               } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k)) ||
                 (arma_any_na[i - width] == 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k))) {
                 
-                sumsq_x = lambda * sumsq_x;
-                sumsq_y = lambda * sumsq_y;
+                sumsq_x.scale(lambda);
+                sumsq_y.scale(lambda);
+                
+              }
+              
+            }
+            
+            // compute the sum of squares
+            if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
+                (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
+              
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
+              sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
+              
+            } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
+              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k)))) {
+              
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
+              
+            } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k))) &&
+              (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
+              
+              sumsq_xy.scale(lambda);
+              sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
+              
+            } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k)) ||
+              (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k))) {
+              
+              sumsq_xy.scale(lambda);
+              
+            }
+            
+          }
+          
+          // recompute the sums of the window every 'reanchor' rows
+          if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+            
+            RollReanchor exact(&x(0, j), &y(0, k), arma_any_na.memptr(),
+                               std::max(0, i - width + 1), i,
+                               n, arma_weights, center);
+            
+            arma_reanchor(j, k) = std::max(arma_reanchor(j, k), (double)std::abs(sumsq_xy.value() - exact.sumsq_xy));
+            
+            sum_w.set(exact.sum_w);
+            sum_x.set(exact.sum_x);
+            sum_y.set(exact.sum_y);
+            sumsq_w.set(exact.sumsq_w);
+            sumsq_x.set(exact.sumsq_x);
+            sumsq_y.set(exact.sumsq_y);
+            sumsq_xy.set(exact.sumsq_xy);
+            mean_x = exact.mean_x;
+            mean_y = exact.mean_y;
+            
+          }
+          
+          // don't compute if missing value and 'na_restore' argument is TRUE
+          if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
+              !std::isnan(y(i, k)))) {
+              
+              if ((n_obs > 1) && (n_obs >= min_obs)) {
+                
+                if (scale) {
+                  
+                  // don't compute if the standard deviation is zero
+                  if ((sumsq_x.value() < 0) || (sumsq_y.value() < 0) ||
+                      (sqrt(sumsq_x.value()) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y.value()) <= sqrt(arma::datum::eps))) {
+                    
+                    arma_cov(j, k, i) = NA_REAL;
+                    
+                  } else {
+                    arma_cov(j, k, i) = sumsq_xy.value() / (sqrt(sumsq_x.value()) * sqrt(sumsq_y.value()));
+                  }
+                  
+                } else if (!scale) {
+                  arma_cov(j, k, i) = sumsq_xy.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
+                }
+                
+              } else {
+                arma_cov(j, k, i) = NA_REAL;
+              }
+              
+          } else {
+            
+            // can be either NA or NaN
+            if (std::isnan(x(i, j))) {
+              arma_cov(j, k, i) = x(i, j);
+            } else {
+              arma_cov(j, k, i) = y(i, k);
+            }
+            
+          }
+          
+        }
+        
+      }
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollCovOfflineMatXX : public Worker {
+  
+  const RMatrix<double> x;       // source
+  const int n;
+  const int n_rows_xy;
+  const int n_cols_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const bool scale;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_cov;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollCovOfflineMatXX(const NumericMatrix x, const int n,
+                      const int n_rows_xy, const int n_cols_x,
+                      const int width, const arma::vec arma_weights,
+                      const bool center, const bool scale, 
+                      const int min_obs, const arma::uvec arma_any_na,
+                      const bool na_restore, arma::cube& arma_cov)
+    : x(x), n(n),
+      n_rows_xy(n_rows_xy), n_cols_x(n_cols_x),
+      width(width), arma_weights(arma_weights),
+      center(center), scale(scale),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_cov(arma_cov) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 3D array (lower triangle)
+      int n_unique = n_cols_x * (n_cols_x + 1) / 2;
+      int i = z / n_unique;
+      int z_unique = z % n_unique;
+      int k = n_cols_x -
+        floor((sqrt((long double)(4 * n_cols_x * (n_cols_x + 1) - (7 + 8 * z_unique))) - 1) / 2) - 1;
+      int j = z_unique - n_cols_x * k + k * (k + 1) / 2;
+      
+      long double sumsq_x = 0;
+      long double sumsq_y = 0;
+      long double mean_x = 0;
+      long double mean_y = 0;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
+          !std::isnan(x(i, k)))) {
+          
+          if (center) {
+            
+            int count = 0;
+            long double sum_w = 0;
+            long double sum_x = 0;
+            long double sum_y = 0;
+            
+            // number of observations is either the window size or,
+            // for partial results, the number of the current row
+            while ((width > count) && (i >= count)) {
+              
+              // don't include if missing value and 'any_na' argument is 1
+              // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+              if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
+                  !std::isnan(x(i - count, k))) {
+                  
+                  // compute the sum
+                  sum_w += arma_weights[n - count - 1];
+                sum_x += arma_weights[n - count - 1] * x(i - count, j);
+                sum_y += arma_weights[n - count - 1] * x(i - count, k);
                 
               }
               
+              count += 1;
+              
+            }
+            
+            // compute the mean
+            mean_x = sum_x / sum_w;
+            mean_y = sum_y / sum_w;
+            
+          }
+          
+          if (scale) {
+            
+            int count = 0;
+            
+            // number of observations is either the window size or,
+            // for partial results, the number of the current row
+            while ((width > count) && (i >= count)) {
+              
+              // don't include if missing value and 'any_na' argument is 1
+              // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+              if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
+                  !std::isnan(x(i - count, k))) {
+                  
+                  // compute the sum of squares with 'center' argument
+                  if (center) {
+                    
+                    sumsq_x += arma_weights[n - count - 1] *
+                      pow(x(i - count, j) - mean_x, (long double)2.0);
+                    sumsq_y += arma_weights[n - count - 1] *
+                      pow(x(i - count, k) - mean_y, (long double)2.0);
+                    
+                  } else if (!center) {
+                    
+                    sumsq_x += arma_weights[n - count - 1] *
+                      pow(x(i - count, j), 2.0);
+                    sumsq_y += arma_weights[n - count - 1] *
+                      pow(x(i - count, k), 2.0);
+                    
+                  }
+                  
+              }
+              
+              count += 1;
+              
             }
             
-            // compute the sum of squares
-            if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
-                (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
-              
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y) -
-                lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
-              
-            } else if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k)) &&
-              ((arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k)))) {
-              
-              sumsq_xy = lambda * sumsq_xy +
-                w_new * (x_new - mean_x) * (y_new - mean_prev_y);
-              
-            } else if (((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k))) &&
-              (arma_any_na[i - width] == 0) && !std::isnan(x(i - width, j)) && !std::isnan(y(i - width, k))) {
-              
-              sumsq_xy = lambda * sumsq_xy -
-                lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
+          }
+          
+          int count = 0;
+          int n_obs = 0;
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          long double sumsq_xy = 0;
+          
+          // number of observations is either the window size or,
+          // for partial results, the number of the current row
+          while ((width > count) && (i >= count)) {
+            
+            // don't include if missing value and 'any_na' argument is 1
+            // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+            if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
+                !std::isnan(x(i - count, k))) {
+                
+                sum_w += arma_weights[n - count - 1];
+              sumsq_w += pow(arma_weights[n - count - 1], 2.0);
               
-            } else if ((arma_any_na[i] != 0) || std::isnan(x(i, j)) || std::isnan(y(i, k)) ||
-              (arma_any_na[i - width] != 0) || std::isnan(x(i - width, j)) || std::isnan(y(i - width, k))) {
+              // compute the sum of squares with 'center' argument
+              if (center) {
+                sumsq_xy += arma_weights[n - count - 1] * 
+                  (x(i - count, j) - mean_x) * (x(i - count, k) - mean_y);
+              } else if (!center) {
+                sumsq_xy += arma_weights[n - count - 1] * 
+                  x(i - count, j) * x(i - count, k);
+              }
               
-              sumsq_xy = lambda * sumsq_xy;
+              n_obs += 1;
               
             }
             
+            count += 1;
+            
           }
           
-          // don't compute if missing value and 'na_restore' argument is TRUE
-          if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
-              !std::isnan(y(i, k)))) {
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            if (scale) {
               
-              if ((n_obs > 1) && (n_obs >= min_obs)) {
+              // don't compute if the standard deviation is zero
+              if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
                 
-                if (scale) {
-                  
-                  // don't compute if the standard deviation is zero
-                  if ((sumsq_x < 0) || (sumsq_y < 0) ||
-                      (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
-                    
-                    arma_cov(j, k, i) = NA_REAL;
-                    
-                  } else {
-                    arma_cov(j, k, i) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
-                  }
-                  
-                } else if (!scale) {
-                  arma_cov(j, k, i) = sumsq_xy / (sum_w - sumsq_w / sum_w);
-                }
+                arma_cov(j, k, i) = NA_REAL;
                 
               } else {
-                arma_cov(j, k, i) = NA_REAL;
+                arma_cov(j, k, i) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
               }
               
-          } else {
-            
-            // can be either NA or NaN
-            if (std::isnan(x(i, j))) {
-              arma_cov(j, k, i) = x(i, j);
-            } else {
-              arma_cov(j, k, i) = y(i, k);
+            } else if (!scale) {
+              arma_cov(j, k, i) = sumsq_xy / (sum_w - sumsq_w / sum_w);
             }
             
+          } else {
+            arma_cov(j, k, i) = NA_REAL;
           }
           
+      } else {
+        
+        // can be either NA or NaN
+        if (std::isnan(x(i, j))) {
+          arma_cov(j, k, i) = x(i, j);
+        } else {
+          arma_cov(j, k, i) = x(i, k);
         }
         
       }
+      
+      // covariance matrix is symmetric
+      arma_cov(k, j, i) = arma_cov(j, k, i);
+      
     }
   }
   
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollCovOfflineMatXX : public Worker {
+struct RollCovOfflineMatXY : public Worker {
   
   const RMatrix<double> x;       // source
+  const RMatrix<double> y;       // source
   const int n;
   const int n_rows_xy;
   const int n_cols_x;
+  const int n_cols_y;
   const int width;
   const arma::vec arma_weights;
   const bool center;
@@ -3961,14 +8003,16 @@ struct RollCovOfflineMatXX : public Worker {
   arma::cube& arma_cov;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollCovOfflineMatXX(const NumericMatrix x, const int n,
-                      const int n_rows_xy, const int n_cols_x,
+  RollCovOfflineMatXY(const NumericMatrix x, const NumericMatrix y,
+                      const int n, const int n_rows_xy,
+                      const int n_cols_x, const int n_cols_y,
                       const int width, const arma::vec arma_weights,
-                      const bool center, const bool scale, 
+                      const bool center, const bool scale,
                       const int min_obs, const arma::uvec arma_any_na,
                       const bool na_restore, arma::cube& arma_cov)
-    : x(x), n(n),
-      n_rows_xy(n_rows_xy), n_cols_x(n_cols_x),
+    : x(x), y(y),
+      n(n), n_rows_xy(n_rows_xy),
+      n_cols_x(n_cols_x), n_cols_y(n_cols_y),
       width(width), arma_weights(arma_weights),
       center(center), scale(scale),
       min_obs(min_obs), arma_any_na(arma_any_na),
@@ -3978,13 +8022,10 @@ struct RollCovOfflineMatXX : public Worker {
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 3D array (lower triangle)
-      int n_unique = n_cols_x * (n_cols_x + 1) / 2;
-      int i = z / n_unique;
-      int z_unique = z % n_unique;
-      int k = n_cols_x -
-        floor((sqrt((long double)(4 * n_cols_x * (n_cols_x + 1) - (7 + 8 * z_unique))) - 1) / 2) - 1;
-      int j = z_unique - n_cols_x * k + k * (k + 1) / 2;
+      // from 1D to 3D array
+      int i = z % n_rows_xy;
+      int j = z / (n_cols_y * n_rows_xy);
+      int k = (z / n_rows_xy) % n_cols_y;
       
       long double sumsq_x = 0;
       long double sumsq_y = 0;
@@ -3993,7 +8034,7 @@ struct RollCovOfflineMatXX : public Worker {
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
-          !std::isnan(x(i, k)))) {
+          !std::isnan(y(i, k)))) {
           
           if (center) {
             
@@ -4009,12 +8050,12 @@ struct RollCovOfflineMatXX : public Worker {
               // don't include if missing value and 'any_na' argument is 1
               // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
               if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                  !std::isnan(x(i - count, k))) {
+                  !std::isnan(y(i - count, k))) {
                   
                   // compute the sum
                   sum_w += arma_weights[n - count - 1];
                 sum_x += arma_weights[n - count - 1] * x(i - count, j);
-                sum_y += arma_weights[n - count - 1] * x(i - count, k);
+                sum_y += arma_weights[n - count - 1] * y(i - count, k);
                 
               }
               
@@ -4039,7 +8080,7 @@ struct RollCovOfflineMatXX : public Worker {
               // don't include if missing value and 'any_na' argument is 1
               // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
               if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                  !std::isnan(x(i - count, k))) {
+                  !std::isnan(y(i - count, k))) {
                   
                   // compute the sum of squares with 'center' argument
                   if (center) {
@@ -4047,14 +8088,14 @@ struct RollCovOfflineMatXX : public Worker {
                     sumsq_x += arma_weights[n - count - 1] *
                       pow(x(i - count, j) - mean_x, (long double)2.0);
                     sumsq_y += arma_weights[n - count - 1] *
-                      pow(x(i - count, k) - mean_y, (long double)2.0);
+                      pow(y(i - count, k) - mean_y, (long double)2.0);
                     
                   } else if (!center) {
                     
                     sumsq_x += arma_weights[n - count - 1] *
                       pow(x(i - count, j), 2.0);
                     sumsq_y += arma_weights[n - count - 1] *
-                      pow(x(i - count, k), 2.0);
+                      pow(y(i - count, k), 2.0);
                     
                   }
                   
@@ -4079,7 +8120,7 @@ struct RollCovOfflineMatXX : public Worker {
             // don't include if missing value and 'any_na' argument is 1
             // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
             if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                !std::isnan(x(i - count, k))) {
+                !std::isnan(y(i - count, k))) {
                 
                 sum_w += arma_weights[n - count - 1];
               sumsq_w += pow(arma_weights[n - count - 1], 2.0);
@@ -4087,10 +8128,10 @@ struct RollCovOfflineMatXX : public Worker {
               // compute the sum of squares with 'center' argument
               if (center) {
                 sumsq_xy += arma_weights[n - count - 1] * 
-                  (x(i - count, j) - mean_x) * (x(i - count, k) - mean_y);
+                  (x(i - count, j) - mean_x) * (y(i - count, k) - mean_y);
               } else if (!center) {
                 sumsq_xy += arma_weights[n - count - 1] * 
-                  x(i - count, j) * x(i - count, k);
+                  x(i - count, j) * y(i - count, k);
               }
               
               n_obs += 1;
@@ -4129,21 +8170,19 @@ struct RollCovOfflineMatXX : public Worker {
         if (std::isnan(x(i, j))) {
           arma_cov(j, k, i) = x(i, j);
         } else {
-          arma_cov(j, k, i) = x(i, k);
+          arma_cov(j, k, i) = y(i, k);
         }
         
       }
       
-      // covariance matrix is symmetric
-      arma_cov(k, j, i) = arma_cov(j, k, i);
-      
     }
   }
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollCovOfflineMatXY : public Worker {
+// 'Worker' function for computing the rolling statistic using prefix sums,
+// where 'symmetric' is the lower triangle of 'x' and 'y' (i.e., 'y' is 'x')
+struct RollCovPrefixMatXY : public Worker {
   
   const RMatrix<double> x;       // source
   const RMatrix<double> y;       // source
@@ -4151,157 +8190,305 @@ struct RollCovOfflineMatXY : public Worker {
   const int n_rows_xy;
   const int n_cols_x;
   const int n_cols_y;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const bool center;
   const bool scale;
+  const bool symmetric;
   const int min_obs;
   const arma::uvec arma_any_na;
   const bool na_restore;
   arma::cube& arma_cov;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollCovOfflineMatXY(const NumericMatrix x, const NumericMatrix y,
-                      const int n, const int n_rows_xy,
-                      const int n_cols_x, const int n_cols_y,
-                      const int width, const arma::vec arma_weights,
-                      const bool center, const bool scale,
-                      const int min_obs, const arma::uvec arma_any_na,
-                      const bool na_restore, arma::cube& arma_cov)
+  RollCovPrefixMatXY(const NumericMatrix x, const NumericMatrix y,
+                     const int n, const int n_rows_xy,
+                     const int n_cols_x, const int n_cols_y,
+                     const int n_rows_chunk, const int width,
+                     const arma::vec arma_weights, const bool center,
+                     const bool scale, const bool symmetric,
+                     const int min_obs, const arma::uvec arma_any_na,
+                     const bool na_restore, arma::cube& arma_cov)
+    : x(x), y(y),
+      n(n), n_rows_xy(n_rows_xy),
+      n_cols_x(n_cols_x), n_cols_y(n_cols_y),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      scale(scale), symmetric(symmetric),
+      min_obs(min_obs), arma_any_na(arma_any_na),
+      na_restore(na_restore), arma_cov(arma_cov) { }
+  
+  // function call operator that iterates by pair of columns and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      int j = 0;
+      int k = 0;
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int z_pair = z % n_pairs;
+      
+      // from 1D to 2D array (lower triangle if 'symmetric')
+      if (symmetric) {
+        
+        k = n_cols_x -
+          floor((sqrt((long double)(4 * n_cols_x * (n_cols_x + 1) - (7 + 8 * z_pair))) - 1) / 2) - 1;
+        j = z_pair - n_cols_x * k + k * (k + 1) / 2;
+        
+      } else {
+        
+        j = z_pair / n_cols_y;
+        k = z_pair % n_cols_y;
+        
+      }
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = (z / n_pairs) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_xy);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      long double y_ref = 0;
+      bool status_ref = false;
+      long double value[5];
+      long double sum[5];
+      RollPrefixSums prefix(std::min(width, n_rows_xy), 5, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k))) {
+          
+          // shift by the first finite observations if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x(i, j)) && std::isfinite(y(i, k))) {
+            
+            x_ref = x(i, j);
+            y_ref = y(i, k);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = y(i, k) - y_ref;
+          value[2] = value[0] * value[0];
+          value[3] = value[1] * value[1];
+          value[4] = value[0] * value[1];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
+            !std::isnan(y(i, k)))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[2];
+            long double sumsq_y = sum[3];
+            long double sumsq_xy = sum[4];
+            
+            if (center) {
+              
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+              sumsq_y -= sum[1] * sum[1] / n_obs;
+              sumsq_xy -= sum[0] * sum[1] / n_obs;
+              
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            sumsq_y = w * std::max(sumsq_y, (long double)0);
+            sumsq_xy = w * sumsq_xy;
+            
+            if (scale) {
+              
+              // don't compute if the standard deviation is zero
+              if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+                
+                arma_cov(j, k, i) = NA_REAL;
+                
+              } else {
+                arma_cov(j, k, i) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+              }
+              
+            } else if (!scale) {
+              arma_cov(j, k, i) = sumsq_xy / (sum_w - sumsq_w / sum_w);
+            }
+            
+          } else {
+            arma_cov(j, k, i) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          if (std::isnan(x(i, j))) {
+            arma_cov(j, k, i) = x(i, j);
+          } else {
+            arma_cov(j, k, i) = y(i, k);
+          }
+          
+        }
+        
+        // covariance matrix is symmetric
+        if (symmetric) {
+          arma_cov(k, j, i) = arma_cov(j, k, i);
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// where 'symmetric' is the lower triangle of 'x' and 'y' (i.e., 'y' is 'x')
+struct RollCovLinearMatXY : public Worker {
+  
+  const RMatrix<double> x;       // source
+  const RMatrix<double> y;       // source
+  const int n;
+  const int n_rows_xy;
+  const int n_cols_x;
+  const int n_cols_y;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const bool scale;
+  const bool symmetric;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::cube& arma_cov;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollCovLinearMatXY(const NumericMatrix x, const NumericMatrix y,
+                     const int n, const int n_rows_xy,
+                     const int n_cols_x, const int n_cols_y,
+                     const int n_rows_chunk, const int width,
+                     const arma::vec arma_weights, const bool center,
+                     const bool scale, const bool symmetric,
+                     const int min_obs, const arma::uvec arma_any_na,
+                     const bool na_restore, arma::cube& arma_cov)
     : x(x), y(y),
       n(n), n_rows_xy(n_rows_xy),
       n_cols_x(n_cols_x), n_cols_y(n_cols_y),
-      width(width), arma_weights(arma_weights),
-      center(center), scale(scale),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      scale(scale), symmetric(symmetric),
       min_obs(min_obs), arma_any_na(arma_any_na),
       na_restore(na_restore), arma_cov(arma_cov) { }
   
-  // function call operator that iterates by index
+  // function call operator that iterates by pair of columns and chunk of rows
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 3D array
-      int i = z % n_rows_xy;
-      int j = z / (n_cols_y * n_rows_xy);
-      int k = (z / n_rows_xy) % n_cols_y;
+      int j = 0;
+      int k = 0;
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int z_pair = z % n_pairs;
       
-      long double sumsq_x = 0;
-      long double sumsq_y = 0;
-      long double mean_x = 0;
-      long double mean_y = 0;
+      // from 1D to 2D array (lower triangle if 'symmetric')
+      if (symmetric) {
+        
+        k = n_cols_x -
+          floor((sqrt((long double)(4 * n_cols_x * (n_cols_x + 1) - (7 + 8 * z_pair))) - 1) / 2) - 1;
+        j = z_pair - n_cols_x * k + k * (k + 1) / 2;
+        
+      } else {
+        
+        j = z_pair / n_cols_y;
+        k = z_pair % n_cols_y;
+        
+      }
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
-          !std::isnan(y(i, k)))) {
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = (z / n_pairs) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_xy);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      long double y_ref = 0;
+      bool status_ref = false;
+      long double value[5];
+      long double sum[5];
+      RollLinearSums linear(width, std::min(width, n_rows_xy), 5, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(y(i, k))) {
           
-          if (center) {
-            
-            int count = 0;
-            long double sum_w = 0;
-            long double sum_x = 0;
-            long double sum_y = 0;
-            
-            // number of observations is either the window size or,
-            // for partial results, the number of the current row
-            while ((width > count) && (i >= count)) {
-              
-              // don't include if missing value and 'any_na' argument is 1
-              // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-              if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                  !std::isnan(y(i - count, k))) {
-                  
-                  // compute the sum
-                  sum_w += arma_weights[n - count - 1];
-                sum_x += arma_weights[n - count - 1] * x(i - count, j);
-                sum_y += arma_weights[n - count - 1] * y(i - count, k);
-                
-              }
-              
-              count += 1;
-              
-            }
+          // shift by the first observations if 'center' argument is TRUE
+          if (center && !status_ref) {
             
-            // compute the mean
-            mean_x = sum_x / sum_w;
-            mean_y = sum_y / sum_w;
+            x_ref = x(i, j);
+            y_ref = y(i, k);
+            status_ref = true;
             
           }
           
-          if (scale) {
-            
-            int count = 0;
-            
-            // number of observations is either the window size or,
-            // for partial results, the number of the current row
-            while ((width > count) && (i >= count)) {
-              
-              // don't include if missing value and 'any_na' argument is 1
-              // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-              if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                  !std::isnan(y(i - count, k))) {
-                  
-                  // compute the sum of squares with 'center' argument
-                  if (center) {
-                    
-                    sumsq_x += arma_weights[n - count - 1] *
-                      pow(x(i - count, j) - mean_x, (long double)2.0);
-                    sumsq_y += arma_weights[n - count - 1] *
-                      pow(y(i - count, k) - mean_y, (long double)2.0);
-                    
-                  } else if (!center) {
-                    
-                    sumsq_x += arma_weights[n - count - 1] *
-                      pow(x(i - count, j), 2.0);
-                    sumsq_y += arma_weights[n - count - 1] *
-                      pow(y(i - count, k), 2.0);
-                    
-                  }
-                  
-              }
-              
-              count += 1;
-              
-            }
-            
-          }
+          value[0] = x(i, j) - x_ref;
+          value[1] = y(i, k) - y_ref;
+          value[2] = value[0] * value[0];
+          value[3] = value[1] * value[1];
+          value[4] = value[0] * value[1];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
+            !std::isnan(y(i, k)))) {
           
-          int count = 0;
-          int n_obs = 0;
           long double sum_w = 0;
           long double sumsq_w = 0;
-          long double sumsq_xy = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
           
-          // number of observations is either the window size or,
-          // for partial results, the number of the current row
-          while ((width > count) && (i >= count)) {
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
             
-            // don't include if missing value and 'any_na' argument is 1
-            // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
-            if ((arma_any_na[i - count] == 0) && !std::isnan(x(i - count, j)) &&
-                !std::isnan(y(i - count, k))) {
-                
-                sum_w += arma_weights[n - count - 1];
-              sumsq_w += pow(arma_weights[n - count - 1], 2.0);
-              
-              // compute the sum of squares with 'center' argument
-              if (center) {
-                sumsq_xy += arma_weights[n - count - 1] * 
-                  (x(i - count, j) - mean_x) * (y(i - count, k) - mean_y);
-              } else if (!center) {
-                sumsq_xy += arma_weights[n - count - 1] * 
-                  x(i - count, j) * y(i - count, k);
-              }
+            long double sumsq_x = sum[2];
+            long double sumsq_y = sum[3];
+            long double sumsq_xy = sum[4];
+            
+            if (center) {
               
-              n_obs += 1;
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+              sumsq_y -= sum[1] * sum[1] / sum_w;
+              sumsq_xy -= sum[0] * sum[1] / sum_w;
               
             }
             
-            count += 1;
-            
-          }
-          
-          if ((n_obs > 1) && (n_obs >= min_obs)) {
-            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            sumsq_y = std::max(sumsq_y, (long double)0);
+                        
             if (scale) {
               
               // don't compute if the standard deviation is zero
@@ -4322,13 +8509,20 @@ struct RollCovOfflineMatXY : public Worker {
             arma_cov(j, k, i) = NA_REAL;
           }
           
-      } else {
-        
-        // can be either NA or NaN
-        if (std::isnan(x(i, j))) {
-          arma_cov(j, k, i) = x(i, j);
         } else {
-          arma_cov(j, k, i) = y(i, k);
+          
+          // can be either NA or NaN
+          if (std::isnan(x(i, j))) {
+            arma_cov(j, k, i) = x(i, j);
+          } else {
+            arma_cov(j, k, i) = y(i, k);
+          }
+          
+        }
+        
+        // covariance matrix is symmetric
+        if (symmetric) {
+          arma_cov(k, j, i) = arma_cov(j, k, i);
         }
         
       }
@@ -5262,6 +9456,178 @@ struct RollCrossProdOfflineMatXX : public Worker {
   
 };
 
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollCrossProdLinearMatXX : public Worker {
+  
+  const RMatrix<double> x;       // source
+  const int n;
+  const int n_rows_xy;
+  const int n_cols_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const bool scale;
+  const int min_obs;
+  const arma::uvec arma_any_na;
+  const bool na_restore;
+  arma::vec& arma_n_obs;        // destination (pass by reference)
+  arma::vec& arma_sum_w;
+  arma::mat& arma_mean;
+  arma::cube& arma_cov;
+  
+  // initialize with source and destination
+  RollCrossProdLinearMatXX(const NumericMatrix x, const int n,
+                           const int n_rows_xy, const int n_cols_x,
+                           const int n_rows_chunk, const int width,
+                           const arma::vec arma_weights, const bool center,
+                           const bool scale, const int min_obs,
+                           const arma::uvec arma_any_na, const bool na_restore,
+                           arma::vec& arma_n_obs, arma::vec& arma_sum_w,
+                           arma::mat& arma_mean, arma::cube& arma_cov)
+    : x(x), n(n),
+      n_rows_xy(n_rows_xy), n_cols_x(n_cols_x),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      scale(scale), min_obs(min_obs),
+      arma_any_na(arma_any_na), na_restore(na_restore),
+      arma_n_obs(arma_n_obs), arma_sum_w(arma_sum_w),
+      arma_mean(arma_mean), arma_cov(arma_cov) { }
+  
+  // function call operator that iterates by pair of columns and chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array (lower triangle)
+      int n_unique = n_cols_x * (n_cols_x + 1) / 2;
+      int z_unique = z % n_unique;
+      int k = n_cols_x -
+        floor((sqrt((long double)(4 * n_cols_x * (n_cols_x + 1) - (7 + 8 * z_unique))) - 1) / 2) - 1;
+      int j = z_unique - n_cols_x * k + k * (k + 1) / 2;
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = (z / n_unique) * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_xy);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      long double y_ref = 0;
+      bool status_ref = false;
+      long double value[5];
+      long double sum[5];
+      RollLinearSums linear(width, std::min(width, n_rows_xy), 5, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value and 'any_na' argument is 1
+        // note: 'any_na' is set to 0 if 'complete_obs' argument is FALSE
+        if ((arma_any_na[i] == 0) && !std::isnan(x(i, j)) && !std::isnan(x(i, k))) {
+          
+          // shift by the first observations if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x(i, j);
+            y_ref = x(i, k);
+            status_ref = true;
+            
+          }
+          
+          value[0] = x(i, j) - x_ref;
+          value[1] = x(i, k) - y_ref;
+          value[2] = value[0] * value[0];
+          value[3] = value[1] * value[1];
+          value[4] = value[0] * value[1];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x(i, j)) &&
+            !std::isnan(x(i, k)))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          long double sumsq_x = sum[2];
+          long double sumsq_y = sum[3];
+          long double sumsq_xy = sum[4];
+          
+          if (center) {
+            
+            sumsq_x -= sum[0] * sum[0] / sum_w;
+            sumsq_y -= sum[1] * sum[1] / sum_w;
+            sumsq_xy -= sum[0] * sum[1] / sum_w;
+            
+          }
+          
+          // degrees of freedom and intercept std.error
+          if ((j == n_cols_x - 1) && (k == n_cols_x - 1)) {
+            
+            arma_n_obs[i] = n_obs;
+            arma_sum_w[i] = sum_w;
+            
+          }
+          
+          // intercept
+          if ((j == k) && center) {
+            arma_mean(i, j) = x_ref + sum[0] / sum_w;
+          } else if (j == k) {
+            arma_mean(i, j) = 0;
+          }
+          
+          if (n_obs >= min_obs) {
+            
+            if (scale) {
+              
+              // don't compute if the standard deviation is zero
+              if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+                
+                arma_cov(j, k, i) = NA_REAL;
+                
+              } else {
+                arma_cov(j, k, i) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+              }
+              
+            } else if (!scale) {
+              arma_cov(j, k, i) = sumsq_xy;
+            }
+            
+          } else {
+            arma_cov(j, k, i) = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          if (std::isnan(x(i, j))) {
+            arma_cov(j, k, i) = x(i, j);
+          } else {
+            arma_cov(j, k, i) = x(i, k);
+          }
+          
+        }
+        
+        // covariance matrix is symmetric
+        arma_cov(k, j, i) = arma_cov(j, k, i);
+        
+      }
+      
+    }
+  }
+  
+};
+
 // 'Worker' function for computing the rolling statistic using an offline algorithm
 struct RollCrossProdOfflineMatXY : public Worker {
   
@@ -0,0 +1,1409 @@
+#ifndef ROLL_ORDER_H
+#define ROLL_ORDER_H
+
+#include <RcppArmadillo.h>
+
+namespace roll {
+
+// similar to R's rank with 'ties.method = "first"' and 'na.last = TRUE',
+// where 'rank_ix' is the inverse (i.e., the row of each rank)
+inline void rank_index(const double* x, const int n_rows_x,
+                       std::vector<int>& rank_x, std::vector<int>& rank_ix) {
+  
+  std::iota(rank_ix.begin(), rank_ix.begin() + n_rows_x, 0);
+  
+  auto comparator = [x](int a, int b) {
+    if (std::isnan(x[a])) return false;
+    if (std::isnan(x[b])) return true;
+    if (x[a] == x[b]) return a < b;
+    return x[a] < x[b];
+  };
+  
+  std::sort(rank_ix.begin(), rank_ix.begin() + n_rows_x, comparator);
+  
+  for (int k = 0; k < n_rows_x; k++) {
+    rank_x[rank_ix[k]] = k;
+  }
+  
+}
+
+// first and last (exclusive) rank of the ties of each rank, where ranks of
+// equal values are contiguous (see 'rank_index')
+inline void rank_ties(const double* x, const int n_rows_x,
+                      const std::vector<int>& rank_ix,
+                      std::vector<int>& ties_lower, std::vector<int>& ties_upper) {
+  
+  for (int k = 0; k < n_rows_x; k++) {
+    
+    if ((k > 0) && (x[rank_ix[k]] == x[rank_ix[k - 1]])) {
+      ties_lower[k] = ties_lower[k - 1];
+    } else {
+      ties_lower[k] = k;
+    }
+    
+  }
+  
+  for (int k = n_rows_x - 1; k >= 0; k--) {
+    
+    if ((k < n_rows_x - 1) && (x[rank_ix[k]] == x[rank_ix[k + 1]])) {
+      ties_upper[k] = ties_upper[k + 1];
+    } else {
+      ties_upper[k] = k + 1;
+    }
+    
+  }
+  
+}
+
+// number of ranks with a value less than 'value', or less than or equal to
+// 'value' if 'status_eq', where 'x' in order of 'rank_ix' has missing values last
+inline int rank_bound(const double* x, const int n_rows_x,
+                      const std::vector<int>& rank_ix,
+                      const double value, const bool status_eq) {
+  
+  auto predicate = [x, value, status_eq](int a) {
+    return status_eq ? (x[a] <= value) : (x[a] < value);
+  };
+  
+  return std::partition_point(rank_ix.begin(), rank_ix.begin() + n_rows_x, predicate) -
+    rank_ix.begin();
+  
+}
+
+// number of observations from the top of the sorted window such that
+// the upper probability is at least 'p' (see the offline algorithm)
+inline int quantile_upper(const int n_obs, const double p, bool& status_avg) {
+  
+  long double sum_w = n_obs;
+  int n_upper = std::min(n_obs, std::max(1, (int)std::ceil(p * n_obs)));
+  
+  // correct for floating point arithmetic
+  while ((n_upper > 1) && ((n_upper - 1) / sum_w >= p)) {
+    n_upper -= 1;
+  }
+  
+  while ((n_upper < n_obs) && (n_upper / sum_w < p)) {
+    n_upper += 1;
+  }
+  
+  // average if upper and lower weight is equal
+  status_avg = std::fabs(n_upper / sum_w - p) <= sqrt(arma::datum::eps);
+  
+  return n_upper;
+  
+}
+
+// order-statistic tree over ranks using a binary indexed (Fenwick) tree,
+// i.e., insert, erase, and select the k-th smallest in O(log n), where
+// weights are optional (e.g., exponential decay 'weights' in a scaled frame)
+// and so are subtree sums of weighted values (e.g., means of the tails)
+struct RollOrderTree {
+  
+  int n_size;
+  int n_step;
+  int n_obs;
+  bool status_w;
+  bool status_x;
+  std::vector<int> tree;
+  std::vector<long double> tree_w;
+  std::vector<long double> tree_x;
+  
+  RollOrderTree(const int n_size, const bool status_w = false,
+                const bool status_x = false)
+    : n_size(n_size), n_step(1),
+      n_obs(0), status_w(status_w), status_x(status_x),
+      tree(n_size + 1, 0), tree_w(status_w ? n_size + 1 : 0, 0),
+      tree_x(status_x ? n_size + 1 : 0, 0) {
+    
+    while (2 * n_step <= n_size) {
+      n_step *= 2;
+    }
+    
+  }
+  
+  void insert(const int r, const long double w = 1, const double x = 0) {
+    
+    n_obs += 1;
+    
+    for (int k = r + 1; k <= n_size; k += k & -k) {
+      tree[k] += 1;
+    }
+    
+    if (status_w) {
+      for (int k = r + 1; k <= n_size; k += k & -k) {
+        tree_w[k] += w;
+      }
+    }
+    
+    if (status_x) {
+      for (int k = r + 1; k <= n_size; k += k & -k) {
+        tree_x[k] += w * x;
+      }
+    }
+    
+  }
+  
+  void erase(const int r, const long double w = 1, const double x = 0) {
+    
+    n_obs -= 1;
+    
+    for (int k = r + 1; k <= n_size; k += k & -k) {
+      tree[k] -= 1;
+    }
+    
+    if (status_w) {
+      for (int k = r + 1; k <= n_size; k += k & -k) {
+        tree_w[k] -= w;
+      }
+    }
+    
+    if (status_x) {
+      for (int k = r + 1; k <= n_size; k += k & -k) {
+        tree_x[k] -= w * x;
+      }
+    }
+    
+  }
+  
+  // multiply each weight by 's' (exact if 's' is a power of two)
+  void scale(const long double s) {
+    
+    for (std::size_t k = 1; k < tree_w.size(); k++) {
+      tree_w[k] *= s;
+    }
+    
+    for (std::size_t k = 1; k < tree_x.size(); k++) {
+      tree_x[k] *= s;
+    }
+    
+  }
+  
+  // number of ranks less than 'r'
+  int count(const int r) const {
+    
+    int result = 0;
+    
+    for (int k = r; k > 0; k -= k & -k) {
+      result += tree[k];
+    }
+    
+    return result;
+    
+  }
+  
+  // sum of weights of ranks less than 'r'
+  long double sum(const int r) const {
+    
+    long double result = 0;
+    
+    for (int k = r; k > 0; k -= k & -k) {
+      result += tree_w[k];
+    }
+    
+    return result;
+    
+  }
+  
+  // sum of weighted values of ranks less than 'r'
+  long double sum_x(const int r) const {
+    
+    long double result = 0;
+    
+    for (int k = r; k > 0; k -= k & -k) {
+      result += tree_x[k];
+    }
+    
+    return result;
+    
+  }
+  
+  // rank of the k-th smallest (zero-based)
+  int select(int k) const {
+    
+    int pos = 0;
+    
+    for (int step = n_step; step > 0; step >>= 1) {
+      if ((pos + step <= n_size) && (tree[pos + step] <= k)) {
+        
+        pos += step;
+        k -= tree[pos];
+        
+      }
+    }
+    
+    return pos;
+    
+  }
+  
+  // rank where the sum of weights of smaller ranks is at most 'w'
+  int select_w(long double w) const {
+    
+    int pos = 0;
+    
+    for (int step = n_step; step > 0; step >>= 1) {
+      if ((pos + step <= n_size) && (tree_w[pos + step] <= w)) {
+        
+        pos += step;
+        w -= tree_w[pos];
+        
+      }
+    }
+    
+    return pos;
+    
+  }
+  
+  // sum of weights from the k-th smallest (zero-based) to the largest
+  long double sum_upper(const int k, const long double sum_w) const {
+    return sum_w - sum(select(k));
+  }
+  
+  // zero-based position of the quantile in the sorted window, where 'p' is
+  // the upper probability (see the offline algorithm)
+  int quantile(const double p, bool& status_avg) const {
+    
+    if (!status_w) {
+      return n_obs - quantile_upper(n_obs, p, status_avg);
+    }
+    
+    long double sum_w = sum(n_size);
+    int k = std::min(n_obs - 1, count(select_w(sum_w * (1 - p))));
+    
+    // correct for floating point arithmetic
+    while ((k > 0) && (sum_upper(k, sum_w) / sum_w < p)) {
+      k -= 1;
+    }
+    
+    while ((k < n_obs - 1) && (sum_upper(k + 1, sum_w) / sum_w >= p)) {
+      k += 1;
+    }
+    
+    // average if upper and lower weight is equal
+    status_avg = std::fabs(sum_upper(k, sum_w) / sum_w - p) <= sqrt(arma::datum::eps);
+    
+    return k;
+    
+  }
+  
+};
+
+// sorted window updated by binary search and 'memmove' (i.e., insert and
+// erase of a contiguous array), which is cache-resident and branch-predictable
+// for small and medium widths
+struct RollSortedWindow {
+  
+  struct Entry {
+    double value;
+    int row;
+  };
+  
+  // total order by value, then by row
+  static bool less(const Entry& a, const Entry& b) {
+    return (a.value < b.value) || ((a.value == b.value) && (a.row < b.row));
+  }
+  
+  std::vector<Entry> window;
+  
+  RollSortedWindow(const int width) {
+    window.reserve(width + 1);
+  }
+  
+  int n_obs() const {
+    return window.size();
+  }
+  
+  void insert(const double value, const int row) {
+    
+    Entry entry = {value, row};
+    
+    window.insert(std::upper_bound(window.begin(), window.end(), entry, less), entry);
+    
+  }
+  
+  void erase(const double value, const int row) {
+    
+    Entry entry = {value, row};
+    
+    window.erase(std::lower_bound(window.begin(), window.end(), entry, less));
+    
+  }
+  
+};
+
+// monotonic queue of rows in a ring buffer that is allocated once, i.e., the
+// capacity is a power of two greater than the width so that push and pop are
+// a mask and an increment of the 'head' and 'tail' counters
+struct RollMonotonicQueue {
+  
+  std::vector<int> ring;
+  unsigned int mask;
+  unsigned int head;
+  unsigned int tail;
+  
+  RollMonotonicQueue(const int width) {
+    
+    unsigned int n_size = 1;
+    
+    while (n_size <= (unsigned int)width) {
+      n_size *= 2;
+    }
+    
+    ring.resize(n_size);
+    mask = n_size - 1;
+    head = 0;
+    tail = 0;
+    
+  }
+  
+  bool empty() const {
+    return head == tail;
+  }
+  
+  int front() const {
+    return ring[head & mask];
+  }
+  
+  int back() const {
+    return ring[(tail - 1) & mask];
+  }
+  
+  void push_back(const int row) {
+    ring[tail++ & mask] = row;
+  }
+  
+  void pop_back() {
+    tail--;
+  }
+  
+  void pop_front() {
+    head++;
+  }
+  
+};
+
+// weighted sums of the rows of a block with the weights by lag, i.e., the
+// circular convolution with the transform of the weights, where the first
+// 'n_size_x' - 1 rows wrap around and the weights of the observations are the
+// imaginary part (if any), otherwise the sum of 'n_size_x' products for each
+// row if the block is not finite or the largest absolute value is more than
+// 'n_range' times the mean (i.e., the round-off of the transform is relative
+// to the largest value of the block rather than each window)
+inline void convolve_block(arma::cx_vec& block, const arma::cx_vec& weights_fft,
+                           const arma::vec& arma_weights, const int n,
+                           const int n_size_x, const double n_range = 1024) {
+  
+  int n_fft = block.size();
+  int n_nonzero = 0;
+  bool status_fft = true;
+  long double sum_abs = 0;
+  double max_abs = 0;
+  
+  for (int k = 0; status_fft && (k < n_fft); k++) {
+    
+    double abs_x = std::abs(std::real(block[k]));
+    
+    if (!std::isfinite(abs_x)) {
+      status_fft = false;
+    } else if (abs_x > 0) {
+      
+      n_nonzero += 1;
+      sum_abs += abs_x;
+      max_abs = std::max(max_abs, abs_x);
+      
+    }
+    
+  }
+  
+  if (status_fft && (max_abs * n_nonzero <= n_range * sum_abs)) {
+    
+    block = arma::fft(block);
+    
+    for (int k = 0; k < n_fft; k++) {
+      block[k] *= weights_fft[k];
+    }
+    
+    block = arma::ifft(block);
+    
+  } else {
+    
+    // each row only depends on the previous rows (i.e., in place)
+    for (int k = n_fft - 1; k >= n_size_x - 1; k--) {
+      
+      long double sum_re = 0;
+      long double sum_im = 0;
+      
+      for (int count = 0; count < n_size_x; count++) {
+        
+        long double w = arma_weights[n - count - 1];
+        
+        sum_re += w * std::real(block[k - count]);
+        sum_im += w * std::imag(block[k - count]);
+        
+      }
+      
+      block[k] = std::complex<double>(sum_re, sum_im);
+      
+    }
+    
+  }
+  
+}
+
+// compensated prefix sums (see Neumaier, 1974) of 'n_sums' values for each row
+// in a ring buffer, i.e., the capacity is a power of two greater than the width
+// so that the sums of a window are the difference of the prefix sums of the
+// newest row and the row before the window (i.e., without the drift of
+// removing observations), where the prefix sums start at 'row_first' and
+// non-finite values are counted by type instead (i.e., Inf - Inf is not NaN)
+struct RollPrefixSums {
+  
+  int n_sums;
+  int row_first;
+  unsigned int mask;
+  std::vector<int> n_obs;
+  std::vector<int> n_pos_inf;
+  std::vector<int> n_neg_inf;
+  std::vector<int> n_nan;
+  std::vector<long double> sum_hi;
+  std::vector<long double> sum_lo;
+  
+  RollPrefixSums(const int width, const int n_sums, const int row_first)
+    : n_sums(n_sums), row_first(row_first) {
+    
+    unsigned int n_size = 1;
+    
+    while (n_size <= (unsigned int)width) {
+      n_size *= 2;
+    }
+    
+    mask = n_size - 1;
+    n_obs.resize(n_size);
+    n_pos_inf.resize(n_size * n_sums);
+    n_neg_inf.resize(n_size * n_sums);
+    n_nan.resize(n_size * n_sums);
+    sum_hi.resize(n_size * n_sums);
+    sum_lo.resize(n_size * n_sums);
+    
+  }
+  
+  // prefix sums of 'row' from the previous row, where 'value' is null if missing
+  void push_back(const int row, const long double* value) {
+    
+    unsigned int curr = row & mask;
+    unsigned int prev = (row - 1) & mask;
+    bool status_first = (row == row_first);
+    
+    n_obs[curr] = (status_first ? 0 : n_obs[prev]) + ((value != NULL) ? 1 : 0);
+    
+    for (int k = 0; k < n_sums; k++) {
+      
+      unsigned int ix_curr = curr * n_sums + k;
+      unsigned int ix_prev = prev * n_sums + k;
+      long double hi = status_first ? 0 : sum_hi[ix_prev];
+      long double lo = status_first ? 0 : sum_lo[ix_prev];
+      
+      n_pos_inf[ix_curr] = status_first ? 0 : n_pos_inf[ix_prev];
+      n_neg_inf[ix_curr] = status_first ? 0 : n_neg_inf[ix_prev];
+      n_nan[ix_curr] = status_first ? 0 : n_nan[ix_prev];
+      
+      if ((value != NULL) && std::isnan(value[k])) {
+        n_nan[ix_curr] += 1;
+      } else if ((value != NULL) && std::isinf(value[k])) {
+        
+        if (value[k] > 0) {
+          n_pos_inf[ix_curr] += 1;
+        } else {
+          n_neg_inf[ix_curr] += 1;
+        }
+        
+      } else if (value != NULL) {
+        
+        long double sum = hi + value[k];
+        
+        if (std::abs(hi) >= std::abs(value[k])) {
+          lo += (hi - sum) + value[k];
+        } else {
+          lo += (value[k] - sum) + hi;
+        }
+        
+        hi = sum;
+        
+      }
+      
+      sum_hi[ix_curr] = hi;
+      sum_lo[ix_curr] = lo;
+      
+    }
+    
+  }
+  
+  // number of observations and sums of the rows after 'row_old' through 'row'
+  int window(const int row, const int row_old, long double* sum) const {
+    
+    unsigned int curr = row & mask;
+    unsigned int old = row_old & mask;
+    bool status_old = (row_old >= row_first);
+    
+    for (int k = 0; k < n_sums; k++) {
+      
+      unsigned int ix_curr = curr * n_sums + k;
+      unsigned int ix_old = old * n_sums + k;
+      int n_pos = n_pos_inf[ix_curr] - (status_old ? n_pos_inf[ix_old] : 0);
+      int n_neg = n_neg_inf[ix_curr] - (status_old ? n_neg_inf[ix_old] : 0);
+      int n_na = n_nan[ix_curr] - (status_old ? n_nan[ix_old] : 0);
+      
+      // non-finite values of the window as in the sum of each value
+      if ((n_na > 0) || ((n_pos > 0) && (n_neg > 0))) {
+        sum[k] = R_NaN;
+      } else if (n_pos > 0) {
+        sum[k] = R_PosInf;
+      } else if (n_neg > 0) {
+        sum[k] = R_NegInf;
+      } else if (status_old) {
+        sum[k] = (sum_hi[ix_curr] - sum_hi[ix_old]) + (sum_lo[ix_curr] - sum_lo[ix_old]);
+      } else {
+        sum[k] = sum_hi[ix_curr] + sum_lo[ix_curr];
+      }
+      
+    }
+    
+    return n_obs[curr] - (status_old ? n_obs[old] : 0);
+    
+  }
+  
+};
+
+// sums of 'n_sums' values for each row with linear decay weights, i.e., the
+// weight of each observation decreases by 'delta' for each row so that the
+// weighted sums are updated in O(1) from the sums, where the newest row has
+// the weight 'weight', the rows of the window are in a ring buffer of size
+// 'n_size' (i.e., to remove the oldest row), and the sums start at 'row_first'
+struct RollLinearSums {
+  
+  int width;
+  int n_sums;
+  int row_first;
+  long double weight;
+  long double delta;
+  unsigned int mask;
+  std::vector<int> status;
+  std::vector<long double> values;
+  int n_obs;
+  long double sum_weights;
+  long double sumsq_weights;
+  std::vector<long double> sum_x;
+  std::vector<long double> sum_wx;
+  
+  RollLinearSums(const int width, const int n_size, const int n_sums,
+                 const int row_first, const long double weight,
+                 const long double delta)
+    : width(width), n_sums(n_sums), row_first(row_first),
+      weight(weight), delta(delta), n_obs(0),
+      sum_weights(0), sumsq_weights(0),
+      sum_x(n_sums), sum_wx(n_sums) {
+    
+    unsigned int n_ring = 1;
+    
+    while (n_ring < (unsigned int)n_size) {
+      n_ring *= 2;
+    }
+    
+    mask = n_ring - 1;
+    status.resize(n_ring);
+    values.resize(n_ring * n_sums);
+    
+  }
+  
+  // weights of the previous rows decrease by 'delta', then remove 'row' - 'width'
+  // and add 'row', where 'value' is null if missing
+  void push_back(const int row, const long double* value) {
+    
+    sumsq_weights += delta * (delta * n_obs - 2 * sum_weights);
+    sum_weights -= delta * n_obs;
+    
+    for (int k = 0; k < n_sums; k++) {
+      sum_wx[k] -= delta * sum_x[k];
+    }
+    
+    // oldest row has the weight of the newest row less 'width' times 'delta'
+    unsigned int old = (row - width) & mask;
+    
+    if ((row - width >= row_first) && status[old]) {
+      
+      long double w_old = weight - width * delta;
+      
+      n_obs -= 1;
+      sum_weights -= w_old;
+      sumsq_weights -= w_old * w_old;
+      
+      for (int k = 0; k < n_sums; k++) {
+        
+        sum_x[k] -= values[old * n_sums + k];
+        sum_wx[k] -= w_old * values[old * n_sums + k];
+        
+      }
+      
+    }
+    
+    unsigned int curr = row & mask;
+    status[curr] = (value != NULL);
+    
+    if (value != NULL) {
+      
+      n_obs += 1;
+      sum_weights += weight;
+      sumsq_weights += weight * weight;
+      
+      for (int k = 0; k < n_sums; k++) {
+        
+        values[curr * n_sums + k] = value[k];
+        sum_x[k] += value[k];
+        sum_wx[k] += weight * value[k];
+        
+      }
+      
+    }
+    
+    // reset the round-off if there are no observations
+    if (n_obs == 0) {
+      
+      sum_weights = 0;
+      sumsq_weights = 0;
+      std::fill(sum_x.begin(), sum_x.end(), 0);
+      std::fill(sum_wx.begin(), sum_wx.end(), 0);
+      
+    }
+    
+  }
+  
+  // number of observations, sum of weights, sum of squared weights, and
+  // weighted sums of the window of the newest row
+  int window(long double& sum_w, long double& sumsq_w, long double* sum) const {
+    
+    sum_w = sum_weights;
+    sumsq_w = sumsq_weights;
+    
+    for (int k = 0; k < n_sums; k++) {
+      sum[k] = sum_wx[k];
+    }
+    
+    return n_obs;
+    
+  }
+  
+};
+
+// sliding-window aggregation in a queue of two stacks, i.e., the front stack
+// has the aggregate of each entry and the newer entries below it and the back
+// stack has a running aggregate, so push and pop are amortized O(1) (see
+// Tangwongsan, Hirzel, and Schneider, 2017), where 'Monoid' has a 'value_type'
+// and an associative 'combine' of the rows in 'a' followed by the rows in 'b'
+// (i.e., not necessarily commutative or invertible)
+template <typename Monoid>
+struct RollTwoStacks {
+  
+  typedef typename Monoid::value_type value_type;
+  
+  std::vector<value_type> front;
+  std::vector<int> front_row;
+  std::vector<value_type> back;
+  std::vector<int> back_row;
+  value_type back_all;
+  
+  RollTwoStacks(const int width) {
+    
+    front.reserve(width);
+    front_row.reserve(width);
+    back.reserve(width);
+    back_row.reserve(width);
+    
+  }
+  
+  bool empty() const {
+    return front.empty() && back.empty();
+  }
+  
+  // row of the oldest entry
+  int row() const {
+    
+    if (front.empty()) {
+      return back_row[0];
+    }
+    
+    return front_row.back();
+    
+  }
+  
+  void push_back(const value_type& value, const int row) {
+    
+    if (back.empty()) {
+      back_all = value;
+    } else {
+      back_all = Monoid::combine(back_all, value);
+    }
+    
+    back.push_back(value);
+    back_row.push_back(row);
+    
+  }
+  
+  void pop_front() {
+    
+    // move the back stack to the front stack from the newest entry
+    if (front.empty()) {
+      
+      for (int k = back.size() - 1; k >= 0; k--) {
+        
+        if (front.empty()) {
+          front.push_back(back[k]);
+        } else {
+          front.push_back(Monoid::combine(back[k], front.back()));
+        }
+        
+        front_row.push_back(back_row[k]);
+        
+      }
+      
+      back.clear();
+      back_row.clear();
+      
+    }
+    
+    front.pop_back();
+    front_row.pop_back();
+    
+  }
+  
+  // aggregate of all entries (i.e., the queue must not be empty)
+  value_type query() const {
+    
+    if (front.empty()) {
+      return back_all;
+    } else if (back.empty()) {
+      return front.back();
+    }
+    
+    return Monoid::combine(front.back(), back_all);
+    
+  }
+  
+};
+
+// product of the rows, where zeros and infinite values are exact because
+// nothing is divided out of the window
+struct RollProdMonoid {
+  
+  typedef long double value_type;
+  
+  static value_type combine(const value_type& a, const value_type& b) {
+    return a * b;
+  }
+  
+};
+
+// largest decline from a peak to a later trough of the rows
+struct RollDrawdownMonoid {
+  
+  struct Entry {
+    double max;
+    double min;
+    double drawdown;
+    int idxmax;
+    int idxmin;
+    int peak;
+    int trough;
+  };
+  
+  typedef Entry value_type;
+  
+  static value_type single(const double value, const int row) {
+    
+    Entry result = {value, value, 0, row, row, row, row};
+    
+    return result;
+    
+  }
+  
+  // ties are the earliest trough and then the earliest peak
+  static value_type combine(const value_type& a, const value_type& b) {
+    
+    Entry result = a;
+    
+    if (b.max > a.max) {
+      result.max = b.max;
+      result.idxmax = b.idxmax;
+    }
+    
+    if (b.min < a.min) {
+      result.min = b.min;
+      result.idxmin = b.idxmin;
+    }
+    
+    if (b.drawdown > result.drawdown) {
+      result.drawdown = b.drawdown;
+      result.peak = b.peak;
+      result.trough = b.trough;
+    }
+    
+    // peak in 'a' and trough in 'b'
+    double drawdown = a.max - b.min;
+    
+    if ((drawdown > result.drawdown) ||
+        ((drawdown == result.drawdown) && ((b.idxmin < result.trough) ||
+         ((b.idxmin == result.trough) && (a.idxmax < result.peak))))) {
+      
+      result.drawdown = drawdown;
+      result.peak = a.idxmax;
+      result.trough = b.idxmin;
+      
+    }
+    
+    return result;
+    
+  }
+  
+};
+
+// deterministic and mergeable quantile sketch using a hierarchy of compactors
+// (see Manku, Rajagopalan, and Lindsay, 1998), i.e., each level has at most
+// 'n_size' values with weight 2^h and a full level is sorted then compacted by
+// keeping every other value, where the rank error is at most 'error' times the
+// number of observations and memory is O(log(n) ^ 2 / error)
+struct RollQuantileSketch {
+  
+  int n_size;
+  int n_obs;
+  long double error_rank;               // upper bound of the rank error
+  std::vector<std::vector<double>> levels;
+  std::vector<int> offset;
+  std::vector<double> cache_x;          // values of levels above zero
+  std::vector<int> cache_w;             // cumulative weights of 'cache_x'
+  bool status_cache;
+  
+  RollQuantileSketch(const int n_rows, const double error)
+    : n_size(size(n_rows, error)), n_obs(0),
+      error_rank(0), levels(1), offset(1, 0),
+      cache_w(1, 0), status_cache(true) {
+    
+    levels[0].reserve(n_size);
+    
+  }
+  
+  // smallest even capacity such that the rank error of 'n_rows' observations
+  // is at most 'error', i.e., n_rows / n_size for each level that is compacted
+  static int size(const int n_rows, const double error) {
+    
+    double n_size = 2 * std::ceil(1 / (2 * error));
+    double n_levels = 0;
+    
+    while (n_size < n_rows) {
+      
+      n_levels = std::floor(std::log2(n_rows / n_size)) + 1;
+      
+      if (n_levels <= error * n_size) break;
+      
+      n_size = 2 * std::ceil(n_levels / (2 * error));
+      
+    }
+    
+    // no compaction (i.e., exact) if each observation fits in level zero
+    return (int)std::max(2.0, std::min(n_size, n_rows + 2.0 - n_rows % 2));
+    
+  }
+  
+  // level zero is kept sorted
+  void insert(const double value) {
+    
+    std::vector<double>& level = levels[0];
+    
+    level.insert(std::upper_bound(level.begin(), level.end(), value), value);
+    n_obs += 1;
+    
+    if ((int)level.size() >= n_size) {
+      compact(0);
+    }
+    
+  }
+  
+  // keep every other value of a full level, alternating the first value kept
+  // to avoid bias, where each value of level 'h' introduces a rank error of
+  // at most 2^h
+  void compact(const int h) {
+    
+    if ((int)levels.size() == h + 1) {
+      
+      levels.push_back(std::vector<double>());
+      offset.push_back(0);
+      
+    }
+    
+    std::vector<double>& level = levels[h];
+    int n_level = level.size() - level.size() % 2;
+    
+    if (h > 0) {
+      std::sort(level.begin(), level.end());
+    }
+    
+    for (int k = offset[h]; k < n_level; k += 2) {
+      levels[h + 1].push_back(level[k]);
+    }
+    
+    level.erase(level.begin(), level.begin() + n_level);
+    offset[h] = 1 - offset[h];
+    error_rank += std::ldexp(1.0L, h);
+    status_cache = false;
+    
+    if ((int)levels[h + 1].size() >= n_size) {
+      compact(h + 1);
+    }
+    
+  }
+  
+  // combine with another sketch, e.g., of a different subset of rows
+  void merge(const RollQuantileSketch& other) {
+    
+    n_obs += other.n_obs;
+    error_rank += other.error_rank;
+    status_cache = false;
+    
+    for (int h = 0; h < (int)other.levels.size(); h++) {
+      
+      if ((int)levels.size() == h) {
+        
+        levels.push_back(std::vector<double>());
+        offset.push_back(0);
+        
+      }
+      
+      std::vector<double>& level = levels[h];
+      int n_level = level.size();
+      
+      level.insert(level.end(), other.levels[h].begin(), other.levels[h].end());
+      
+      if (h == 0) {
+        std::inplace_merge(level.begin(), level.begin() + n_level, level.end());
+      }
+      
+    }
+    
+    for (int h = 0; h < (int)levels.size(); h++) {
+      if ((int)levels[h].size() >= n_size) {
+        compact(h);
+      }
+    }
+    
+  }
+  
+  // sorted values of levels above zero with cumulative weights
+  void update_cache() {
+    
+    std::vector<std::pair<double, int>> items;
+    
+    for (int h = 1; h < (int)levels.size(); h++) {
+      for (int k = 0; k < (int)levels[h].size(); k++) {
+        items.push_back(std::make_pair(levels[h][k], 1 << h));
+      }
+    }
+    
+    std::sort(items.begin(), items.end());
+    
+    int n_items = items.size();
+    
+    cache_x.resize(n_items);
+    cache_w.resize(n_items + 1);
+    cache_w[0] = 0;
+    
+    for (int k = 0; k < n_items; k++) {
+      
+      cache_x[k] = items[k].first;
+      cache_w[k + 1] = cache_w[k] + items[k].second;
+      
+    }
+    
+    status_cache = true;
+    
+  }
+  
+  // sum of weights before the k-th value of level zero or the cache,
+  // where ties in level zero are before ties in the cache
+  int lower_level(const int k) const {
+    
+    const std::vector<double>& level = levels[0];
+    
+    return k + cache_w[std::lower_bound(cache_x.begin(), cache_x.end(), level[k]) -
+      cache_x.begin()];
+    
+  }
+  
+  int lower_cache(const int k) const {
+    
+    const std::vector<double>& level = levels[0];
+    
+    return cache_w[k] + (std::upper_bound(level.begin(), level.end(), cache_x[k]) -
+      level.begin());
+    
+  }
+  
+  // value of the quantile with upper probability 'p' (see the offline algorithm)
+  double quantile(const double p) {
+    
+    if (!status_cache) {
+      update_cache();
+    }
+    
+    // total weight is the number of observations, so the quantile is the
+    // last value with at most 'n_lower' weight before it
+    bool status_avg = false;
+    int n_lower = n_obs - quantile_upper(n_obs, p, status_avg);
+    int n_level = levels[0].size();
+    int n_cache = cache_x.size();
+    
+    // last value of level zero and of the cache
+    int lo = 0;
+    int hi = n_level;
+    
+    while (lo < hi) {
+      
+      int mid = (lo + hi) / 2;
+      
+      if (lower_level(mid) <= n_lower) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+      
+    }
+    
+    int k_level = lo - 1;
+    
+    lo = 0;
+    hi = n_cache;
+    
+    while (lo < hi) {
+      
+      int mid = (lo + hi) / 2;
+      
+      if (lower_cache(mid) <= n_lower) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+      
+    }
+    
+    int k_cache = lo - 1;
+    
+    // quantile is the later of the two in sorted order
+    int lower_w = -1;
+    int lower_prev_w = -1;
+    double quantile_x = NA_REAL;
+    double quantile_prev_x = NA_REAL;
+    int k_level_prev = -1;
+    int k_cache_prev = -1;
+    
+    if ((k_level >= 0) && (lower_level(k_level) > lower_w)) {
+      
+      lower_w = lower_level(k_level);
+      quantile_x = levels[0][k_level];
+      k_level_prev = k_level - 1;
+      k_cache_prev = std::lower_bound(cache_x.begin(), cache_x.end(), quantile_x) -
+        cache_x.begin() - 1;
+      
+    }
+    
+    if ((k_cache >= 0) && (lower_cache(k_cache) > lower_w)) {
+      
+      lower_w = lower_cache(k_cache);
+      quantile_x = cache_x[k_cache];
+      k_level_prev = std::upper_bound(levels[0].begin(), levels[0].end(), quantile_x) -
+        levels[0].begin() - 1;
+      k_cache_prev = k_cache - 1;
+      
+    }
+    
+    // average if upper and lower weight is equal
+    // note: only if the quantile is a boundary of the weights
+    if (status_avg && (lower_w == n_lower)) {
+      
+      if ((k_level_prev >= 0) && (lower_level(k_level_prev) > lower_prev_w)) {
+        
+        lower_prev_w = lower_level(k_level_prev);
+        quantile_prev_x = levels[0][k_level_prev];
+        
+      }
+      
+      if ((k_cache_prev >= 0) && (lower_cache(k_cache_prev) > lower_prev_w)) {
+        
+        lower_prev_w = lower_cache(k_cache_prev);
+        quantile_prev_x = cache_x[k_cache_prev];
+        
+      }
+      
+      if (lower_prev_w >= 0) {
+        return (quantile_x + quantile_prev_x) / 2;
+      }
+      
+    }
+    
+    return quantile_x;
+    
+  }
+  
+};
+
+// k-th smallest (zero-based) absolute deviation from 'center', where 'value'
+// returns the k-th smallest observation and 'n_lower' observations are less
+// than 'center', i.e., selection from two sorted sequences (deviations below
+// and above 'center') by binary search in O(log n) calls
+template <typename Value>
+inline double deviation_select(const int n_obs, const int n_lower,
+                               const double center, const int k,
+                               Value value) {
+  
+  int n_upper = n_obs - n_lower;
+  int lower = std::max(0, k + 1 - n_upper);
+  int upper = std::min(k + 1, n_lower);
+  
+  // number of deviations from below 'center' in the k + 1 smallest
+  while (lower < upper) {
+    
+    int mid = (lower + upper) / 2;
+    
+    if (center - value(n_lower - 1 - mid) < value(n_lower + k - mid) - center) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+    
+  }
+  
+  double result = 0;
+  
+  if (lower > 0) {
+    result = center - value(n_lower - lower);
+  }
+  
+  if (k + 1 - lower > 0) {
+    result = std::max(result, value(n_lower + k - lower) - center);
+  }
+  
+  return result;
+  
+}
+
+// median absolute deviation from the median using selection, where 'value'
+// returns the k-th smallest observation (e.g., of a sorted window or tree)
+template <typename Value>
+inline double mad_select(const int n_obs, Value value, double& center) {
+  
+  center = value((n_obs - 1) / 2);
+  
+  if (n_obs % 2 == 0) {
+    center = (center + value(n_obs / 2)) / 2;
+  }
+  
+  // number of observations less than the median
+  int lower = 0;
+  int upper = n_obs / 2;
+  
+  while (lower < upper) {
+    
+    int mid = (lower + upper) / 2;
+    
+    if (value(mid) < center) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+    
+  }
+  
+  double result = deviation_select(n_obs, lower, center, (n_obs - 1) / 2, value);
+  
+  if (n_obs % 2 == 0) {
+    result = (result + deviation_select(n_obs, lower, center, n_obs / 2, value)) / 2;
+  }
+  
+  return result;
+  
+}
+
+// weighted quantile of 'x' sorted in ascending order, where each element is a
+// value and its weight and 'p' is the upper probability (see the offline algorithm)
+inline double quantile_w(const std::vector<std::pair<double, long double> >& x,
+                         const long double sum_w, const double p) {
+  
+  long double sum_upper_w = 0;
+  
+  // last element of sorted array that is 'p' of 'weights'
+  for (int k = x.size() - 1; k >= 0; k--) {
+    
+    sum_upper_w += x[k].second;
+    
+    if (sum_upper_w / sum_w >= p) {
+      
+      // average if upper and lower weight is equal
+      if ((k > 0) && (std::fabs(sum_upper_w / sum_w - p) <= sqrt(arma::datum::eps))) {
+        return (x[k].first + x[k - 1].first) / 2;
+      }
+      
+      return x[k].first;
+      
+    }
+    
+  }
+  
+  return NA_REAL;
+  
+}
+
+// dual-heap sliding median with lazy deletion, i.e., a max-heap for the
+// lower half and a min-heap for the upper half of the window, where an
+// entry is deleted once its row leaves the window
+struct RollMedianHeap {
+  
+  struct Entry {
+    double value;
+    int row;
+  };
+  
+  // total order by value, then by row
+  static bool less(const Entry& a, const Entry& b) {
+    return (a.value < b.value) || ((a.value == b.value) && (a.row < b.row));
+  }
+  
+  static bool greater(const Entry& a, const Entry& b) {
+    return less(b, a);
+  }
+  
+  int row_min;
+  int n_lower;
+  int n_upper;
+  std::vector<Entry> lower;     // max-heap
+  std::vector<Entry> upper;     // min-heap
+  
+  RollMedianHeap()
+    : row_min(0), n_lower(0), n_upper(0) { }
+  
+  int n_obs() const {
+    return n_lower + n_upper;
+  }
+  
+  void insert(const double value, const int row) {
+    
+    Entry entry = {value, row};
+    
+    if ((n_lower > 0) && !less(lower.front(), entry)) {
+      
+      lower.push_back(entry);
+      std::push_heap(lower.begin(), lower.end(), less);
+      n_lower += 1;
+      
+    } else {
+      
+      upper.push_back(entry);
+      std::push_heap(upper.begin(), upper.end(), greater);
+      n_upper += 1;
+      
+    }
+    
+    balance();
+    
+  }
+  
+  // note: rows must be erased in the order they were inserted
+  void erase(const double value, const int row) {
+    
+    Entry entry = {value, row};
+    row_min = row + 1;
+    
+    if ((n_lower > 0) && !less(lower.front(), entry)) {
+      n_lower -= 1;
+    } else {
+      n_upper -= 1;
+    }
+    
+    prune();
+    balance();
+    
+  }
+  
+  // lower median if the number of observations is odd,
+  // otherwise average of the lower and upper medians
+  double median() const {
+    
+    if (n_lower > n_upper) {
+      return lower.front().value;
+    } else {
+      return (lower.front().value + upper.front().value) / 2;
+    }
+    
+  }
+  
+  void prune() {
+    
+    while (!lower.empty() && (lower.front().row < row_min)) {
+      std::pop_heap(lower.begin(), lower.end(), less);
+      lower.pop_back();
+    }
+    
+    while (!upper.empty() && (upper.front().row < row_min)) {
+      std::pop_heap(upper.begin(), upper.end(), greater);
+      upper.pop_back();
+    }
+    
+    // remove deleted entries if these are the majority
+    if ((int)lower.size() > 2 * n_lower + 16) {
+      compact(lower, less);
+    }
+    
+    if ((int)upper.size() > 2 * n_upper + 16) {
+      compact(upper, greater);
+    }
+    
+  }
+  
+  template <typename Compare>
+  void compact(std::vector<Entry>& heap, Compare compare) {
+    
+    int row_min = this->row_min;
+    
+    heap.erase(std::remove_if(heap.begin(), heap.end(),
+                              [row_min](const Entry& a) { return a.row < row_min; }),
+               heap.end());
+    std::make_heap(heap.begin(), heap.end(), compare);
+    
+  }
+  
+  // lower half has either the same or one more observation than the upper half
+  void balance() {
+    
+    if (n_lower > n_upper + 1) {
+      
+      upper.push_back(lower.front());
+      std::push_heap(upper.begin(), upper.end(), greater);
+      std::pop_heap(lower.begin(), lower.end(), less);
+      lower.pop_back();
+      n_lower -= 1;
+      n_upper += 1;
+      
+    } else if (n_lower < n_upper) {
+      
+      lower.push_back(upper.front());
+      std::push_heap(lower.begin(), lower.end(), less);
+      std::pop_heap(upper.begin(), upper.end(), greater);
+      upper.pop_back();
+      n_lower += 1;
+      n_upper -= 1;
+      
+    }
+    
+    prune();
+    
+  }
+  
+};
+
+}
+
+#endif
@@ -0,0 +1,1017 @@
+#ifndef ROLL_STATE_H
+#define ROLL_STATE_H
+
+#define ARMA_WARN_LEVEL 0
+
+#include <RcppArmadillo.h>
+#include <RcppParallel.h>
+#include "roll_order.h"
+using namespace Rcpp;
+using namespace RcppParallel;
+
+namespace roll {
+
+// running sums of the window of a pair of columns (i.e., 'x' and 'y' are the
+// same column for univariate statistics) that are updated in O(1) for each row
+// as in 'RollCovOnlineMatXX', where 'status_new' and 'status_old' are FALSE if
+// the new row or the row that leaves the window is missing, respectively
+struct RollMoments {
+  
+  int n_obs;
+  long double sum_w;
+  long double sum_x;
+  long double sum_y;
+  long double sumsq_w;
+  long double sumsq_x;
+  long double sumsq_y;
+  long double sumsq_xy;
+  long double mean_prev_x;
+  long double mean_prev_y;
+  long double mean_x;
+  long double mean_y;
+  
+  RollMoments()
+    : n_obs(0), sum_w(0), sum_x(0), sum_y(0),
+      sumsq_w(0), sumsq_x(0), sumsq_y(0), sumsq_xy(0),
+      mean_prev_x(0), mean_prev_y(0), mean_x(0), mean_y(0) { }
+  
+  // 'rolling' is FALSE for the expanding window (i.e., no row leaves the window)
+  void update(const bool status_new, const long double x_new, const long double y_new,
+              const bool status_old, const long double x_old, const long double y_old,
+              const long double w_new, const long double w_old,
+              const long double lambda, const bool rolling, const bool center) {
+    
+    long double w_in = status_new ? w_new : 0;
+    long double x_in = status_new ? x_new : 0;
+    long double y_in = status_new ? y_new : 0;
+    long double w_out = (rolling && status_old) ? w_old : 0;
+    long double x_out = (rolling && status_old) ? x_old : 0;
+    long double y_out = (rolling && status_old) ? y_old : 0;
+    bool status_out = rolling && status_old;
+    
+    if (status_new && !status_out) {
+      n_obs += 1;
+    } else if (!status_new && status_out) {
+      n_obs -= 1;
+    }
+    
+    sum_w = lambda * sum_w + w_in - lambda * w_out;
+    sum_x = lambda * sum_x + w_in * x_in - lambda * w_out * x_out;
+    sum_y = lambda * sum_y + w_in * y_in - lambda * w_out * y_out;
+    sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
+      pow(w_in, (long double)2.0) - pow(lambda * w_out, (long double)2.0);
+    
+    if (center && (n_obs > 0)) {
+      
+      // compute the mean
+      mean_prev_x = mean_x;
+      mean_prev_y = mean_y;
+      mean_x = sum_x / sum_w;
+      mean_y = sum_y / sum_w;
+      
+    }
+    
+    // compute the sum of squares
+    if (status_new && status_out) {
+      
+      sumsq_x = lambda * sumsq_x +
+        w_in * (x_in - mean_x) * (x_in - mean_prev_x) -
+        lambda * w_out * (x_out - mean_x) * (x_out - mean_prev_x);
+      sumsq_y = lambda * sumsq_y +
+        w_in * (y_in - mean_y) * (y_in - mean_prev_y) -
+        lambda * w_out * (y_out - mean_y) * (y_out - mean_prev_y);
+      sumsq_xy = lambda * sumsq_xy +
+        w_in * (x_in - mean_x) * (y_in - mean_prev_y) -
+        lambda * w_out * (x_out - mean_x) * (y_out - mean_prev_y);
+      
+    } else if (status_new && (rolling || (n_obs > 1))) {
+      
+      sumsq_x = lambda * sumsq_x +
+        w_in * (x_in - mean_x) * (x_in - mean_prev_x);
+      sumsq_y = lambda * sumsq_y +
+        w_in * (y_in - mean_y) * (y_in - mean_prev_y);
+      sumsq_xy = lambda * sumsq_xy +
+        w_in * (x_in - mean_x) * (y_in - mean_prev_y);
+      
+    } else if (status_out) {
+      
+      sumsq_x = lambda * sumsq_x -
+        lambda * w_out * (x_out - mean_x) * (x_out - mean_prev_x);
+      sumsq_y = lambda * sumsq_y -
+        lambda * w_out * (y_out - mean_y) * (y_out - mean_prev_y);
+      sumsq_xy = lambda * sumsq_xy -
+        lambda * w_out * (x_out - mean_x) * (y_out - mean_prev_y);
+      
+    } else if (!status_new) {
+      
+      sumsq_x = lambda * sumsq_x;
+      sumsq_y = lambda * sumsq_y;
+      sumsq_xy = lambda * sumsq_xy;
+      
+    } else if ((n_obs == 1) && !center) {
+      
+      sumsq_x = w_in * pow(x_in, (long double)2.0);
+      sumsq_y = w_in * pow(y_in, (long double)2.0);
+      sumsq_xy = w_in * x_in * y_in;
+      
+    }
+    
+  }
+  
+  // combine with the running sums of the next rows 'other' (i.e., an expanding
+  // window of a later partition), where 'lambda_n' is the decay over the rows
+  // of 'other', as in the parallel algorithm of Chan et al. (1979)
+  void merge(const RollMoments& other, const long double lambda_n, const bool center) {
+    
+    long double sum_w_prev = lambda_n * sum_w;
+    long double delta_x = 0;
+    long double delta_y = 0;
+    
+    if ((n_obs > 0) && (other.n_obs > 0)) {
+      
+      delta_x = other.sum_x / other.sum_w - sum_x / sum_w;
+      delta_y = other.sum_y / other.sum_w - sum_y / sum_w;
+      
+    }
+    
+    n_obs += other.n_obs;
+    sum_w = sum_w_prev + other.sum_w;
+    sum_x = lambda_n * sum_x + other.sum_x;
+    sum_y = lambda_n * sum_y + other.sum_y;
+    sumsq_w = pow(lambda_n, (long double)2.0) * sumsq_w + other.sumsq_w;
+    sumsq_x = lambda_n * sumsq_x + other.sumsq_x;
+    sumsq_y = lambda_n * sumsq_y + other.sumsq_y;
+    sumsq_xy = lambda_n * sumsq_xy + other.sumsq_xy;
+    
+    if (center && (n_obs > 0)) {
+      
+      // centered co-moments of the difference in the means
+      if ((sum_w_prev != 0) && (other.sum_w != 0)) {
+        
+        long double w_delta = sum_w_prev * other.sum_w / sum_w;
+        
+        sumsq_x += w_delta * delta_x * delta_x;
+        sumsq_y += w_delta * delta_y * delta_y;
+        sumsq_xy += w_delta * delta_x * delta_y;
+        
+      }
+      
+      mean_x = sum_x / sum_w;
+      mean_y = sum_y / sum_w;
+      mean_prev_x = mean_x;
+      mean_prev_y = mean_y;
+      
+    }
+    
+  }
+  
+};
+
+// state of an online algorithm between calls, i.e., the running sums of each
+// column (or pair of columns) and the ring buffer of the last 'width' rows of
+// 'x' and 'y' (i.e., to remove the row that leaves the window), so that new
+// rows are appended in O(1) for each row instead of the full history
+struct RollState {
+  
+  std::string type;
+  int width;
+  int min_obs;
+  bool complete_obs;
+  bool na_restore;
+  bool center;
+  bool scale;
+  bool intercept;
+  bool status_vec;                       // 'x' is a vector
+  bool symmetric;                        // 'y' is 'x'
+  int n_cols_x;
+  int n_cols_y;
+  int n_cols;                            // columns in the ring buffer
+  long double lambda;
+  long double w_new;
+  long double w_old;
+  int n_rows;                            // rows so far
+  std::vector<double> ring;
+  std::vector<int> ring_any_na;
+  std::vector<int> pair_x;               // column in the ring buffer of each pair
+  std::vector<int> pair_y;
+  std::vector<RollMoments> moments;
+  std::vector<RollMonotonicQueue> decks;
+  std::vector<int> n_obs;
+  std::vector<long double> x_last;       // last observation for 'scale'
+  std::vector<std::string> names_x;
+  std::vector<std::string> names_y;
+  
+  // empty state to load a checkpoint into (see 'load_state')
+  RollState()
+    : width(1), n_rows(0) { }
+  
+  RollState(const std::string type, const int width,
+            const arma::vec& weights, const bool center,
+            const bool scale, const bool intercept,
+            const int min_obs, const bool complete_obs,
+            const bool na_restore, const bool status_vec,
+            const bool symmetric, const int n_cols_x,
+            const int n_cols_y)
+    : type(type), width(width), min_obs(min_obs),
+      complete_obs(complete_obs), na_restore(na_restore),
+      center(center), scale(scale), intercept(intercept),
+      status_vec(status_vec), symmetric(symmetric),
+      n_cols_x(n_cols_x), n_cols_y(n_cols_y),
+      n_cols(symmetric ? n_cols_x : n_cols_x + n_cols_y),
+      n_rows(0) {
+    
+    int n = weights.size();
+    
+    w_new = weights[n - 1];
+    w_old = weights[n - width];
+    
+    if (weights[n - 1] == 0) {
+      lambda = 1;
+    } else if (width > 1) {
+      lambda = weights[n - 2] / weights[n - 1]; // check already passed
+    } else {
+      lambda = weights[n - 1];
+    }
+    
+    if ((type == "min") || (type == "max")) {
+      
+      decks.resize(n_cols_x, RollMonotonicQueue(std::min(width, 32)));
+      n_obs.resize(n_cols_x);
+      
+    } else if ((type == "cov") || (type == "crossprod") || (type == "lm")) {
+      
+      // lower triangle if 'symmetric'
+      for (int j = 0; j < n_cols_x; j++) {
+        
+        int n_cols_k = symmetric ? j + 1 : n_cols_y;
+        
+        for (int k = 0; k < n_cols_k; k++) {
+          
+          pair_x.push_back(j);
+          pair_y.push_back(symmetric ? k : n_cols_x + k);
+          
+        }
+        
+      }
+      
+    } else {
+      
+      for (int j = 0; j < n_cols_x; j++) {
+        
+        pair_x.push_back(j);
+        pair_y.push_back(j);
+        
+      }
+      
+      x_last.resize(n_cols_x);
+      
+    }
+    
+    moments.resize(pair_x.size());
+    
+  }
+  
+  // value of 'row' in column 'col' from the new rows 'data' (i.e., the rows
+  // from 'n_rows') or, otherwise, from the ring buffer
+  double value(const int row, const int col, const arma::mat& data) const {
+    
+    if (row >= n_rows) {
+      return data(row - n_rows, col);
+    }
+    
+    return ring[(row % width) * n_cols + col];
+    
+  }
+  
+  int any_na(const int row, const arma::uvec& data_any_na) const {
+    
+    if (row >= n_rows) {
+      return data_any_na[row - n_rows];
+    }
+    
+    return ring_any_na[row % width];
+    
+  }
+  
+  // keep the last 'width' rows of 'data' in the ring buffer
+  void push_back(const arma::mat& data, const arma::uvec& data_any_na) {
+    
+    int n_rows_data = data.n_rows;
+    int n_size = std::min(width, n_rows + n_rows_data);
+    
+    if ((int)ring_any_na.size() < n_size) {
+      
+      ring.resize(n_size * n_cols);
+      ring_any_na.resize(n_size);
+      
+    }
+    
+    for (int i = std::max(0, n_rows_data - width); i < n_rows_data; i++) {
+      
+      int slot = (n_rows + i) % width;
+      
+      for (int j = 0; j < n_cols; j++) {
+        ring[slot * n_cols + j] = data(i, j);
+      }
+      
+      ring_any_na[slot] = data_any_na[i];
+      
+    }
+    
+    n_rows += n_rows_data;
+    
+  }
+  
+};
+
+// combine the state with the state of the next rows 'other' in O(1) for each
+// column (or pair of columns), i.e., expanding windows of partitions of rows
+inline void merge_state(RollState& state, const RollState& other) {
+  
+  long double lambda_n = pow(state.lambda, (long double)other.n_rows);
+  
+  for (std::size_t z = 0; z < state.moments.size(); z++) {
+    state.moments[z].merge(other.moments[z], lambda_n, state.center);
+  }
+  
+  // rows of 'other' in the ring buffer (i.e., all rows of the expanding window)
+  int n_size = std::min(state.width, state.n_rows + other.n_rows);
+  
+  state.ring.resize(n_size * state.n_cols);
+  state.ring_any_na.resize(n_size);
+  
+  for (int i = 0; i < other.n_rows; i++) {
+    
+    int slot = (state.n_rows + i) % state.width;
+    int slot_other = i % other.width;
+    
+    std::copy(other.ring.begin() + slot_other * other.n_cols,
+              other.ring.begin() + (slot_other + 1) * other.n_cols,
+              state.ring.begin() + slot * state.n_cols);
+    state.ring_any_na[slot] = other.ring_any_na[slot_other];
+    
+  }
+  
+  state.n_rows += other.n_rows;
+  
+}
+
+// 'Worker' function for appending rows to the state of an online algorithm
+struct RollStateUpdate : public Worker {
+  
+  RollState& state;
+  const arma::mat& data;        // source
+  const arma::uvec& arma_any_na;
+  const bool status_out;
+  arma::mat& arma_value;        // destination (pass by reference)
+  arma::cube& arma_cov;
+  arma::vec& arma_n_obs;
+  arma::vec& arma_sum_w;
+  arma::mat& arma_mean;
+  
+  // initialize with source and destination
+  RollStateUpdate(RollState& state, const arma::mat& data,
+                  const arma::uvec& arma_any_na, const bool status_out,
+                  arma::mat& arma_value, arma::cube& arma_cov,
+                  arma::vec& arma_n_obs, arma::vec& arma_sum_w,
+                  arma::mat& arma_mean)
+    : state(state), data(data),
+      arma_any_na(arma_any_na), status_out(status_out),
+      arma_value(arma_value), arma_cov(arma_cov),
+      arma_n_obs(arma_n_obs), arma_sum_w(arma_sum_w),
+      arma_mean(arma_mean) { }
+  
+  // function call operator that iterates by column
+  void operator()(std::size_t begin_col, std::size_t end_col) {
+    for (std::size_t z = begin_col; z < end_col; z++) {
+      
+      if ((state.type == "min") || (state.type == "max")) {
+        update_deck(z);
+      } else {
+        update_moments(z);
+      }
+      
+    }
+  }
+  
+  // monotonic queue of the rows as in 'RollMinOnlineMat' and 'RollMaxOnlineMat'
+  void update_deck(const int j) {
+    
+    const int width = state.width;
+    const bool status_min = (state.type == "min");
+    int& n_obs = state.n_obs[j];
+    RollMonotonicQueue& deck = state.decks[j];
+    int n_rows_data = data.n_rows;
+    
+    for (int r = 0; r < n_rows_data; r++) {
+      
+      int i = state.n_rows + r;
+      bool status_new = (arma_any_na[r] == 0) && !std::isnan(data(r, j));
+      
+      // rolling window
+      if (i >= width) {
+        
+        bool status_old = (state.any_na(i - width, arma_any_na) == 0) &&
+          !std::isnan(state.value(i - width, j, data));
+        
+        if (status_new && !status_old) {
+          n_obs += 1;
+        } else if (!status_new && status_old) {
+          n_obs -= 1;
+        }
+        
+        // at most one row leaves the window
+        if (!deck.empty() && (deck.front() <= i - width)) {
+          deck.pop_front();
+        }
+        
+      } else if (status_new) {
+        n_obs += 1;
+      }
+      
+      // only valid observations are in the queue
+      if (status_new) {
+        
+        while (!deck.empty() &&
+               (status_min ? (data(r, j) < state.value(deck.back(), j, data)) :
+                  (data(r, j) > state.value(deck.back(), j, data)))) {
+          deck.pop_back();
+        }
+        
+        // the queue grows with the rows so far (i.e., at most 'width' rows)
+        if (deck.tail - deck.head > deck.mask) {
+          
+          RollMonotonicQueue deck_grow(deck.mask + 1);
+          
+          while (!deck.empty()) {
+            
+            deck_grow.push_back(deck.front());
+            deck.pop_front();
+            
+          }
+          
+          deck = deck_grow;
+          
+        }
+        
+        deck.push_back(i);
+        
+      }
+      
+      if (!status_out) {
+        continue;
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!state.na_restore) || (state.na_restore && !std::isnan(data(r, j)))) {
+        
+        if ((n_obs >= state.min_obs) && !deck.empty()) {
+          arma_value(r, j) = state.value(deck.front(), j, data);
+        } else {
+          arma_value(r, j) = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_value(r, j) = data(r, j);
+        
+      }
+      
+    }
+    
+  }
+  
+  // running sums of the pair of columns as in 'RollCovOnlineMatXX'
+  void update_moments(const int z) {
+    
+    const int width = state.width;
+    const int j = state.pair_x[z];
+    const int k = state.pair_y[z];
+    const bool status_sum = (state.type == "sum");
+    const bool status_mean = (state.type == "mean");
+    const bool status_var = (state.type == "var");
+    const bool status_sd = (state.type == "sd");
+    const bool status_scale = (state.type == "scale");
+    const bool status_cov = (state.type == "cov");
+    const bool status_lm = (state.type == "lm");
+    const bool status_pair = status_cov || status_lm || (state.type == "crossprod");
+    const int k_cov = k - (state.symmetric ? 0 : state.n_cols_x);
+    RollMoments& moments = state.moments[z];
+    int n_rows_data = data.n_rows;
+    
+    for (int r = 0; r < n_rows_data; r++) {
+      
+      int i = state.n_rows + r;
+      bool status_new = (arma_any_na[r] == 0) && !std::isnan(data(r, j)) &&
+        !std::isnan(data(r, k));
+      bool status_old = false;
+      long double x_old = 0;
+      long double y_old = 0;
+      
+      if ((i >= width) && (width > 1)) {
+        
+        x_old = state.value(i - width, j, data);
+        y_old = state.value(i - width, k, data);
+        status_old = (state.any_na(i - width, arma_any_na) == 0) &&
+          !std::isnan(x_old) && !std::isnan(y_old);
+        
+      }
+      
+      // window of the new row only
+      if (width == 1) {
+        moments = RollMoments();
+      }
+      
+      moments.update(status_new, data(r, j), data(r, k),
+                     status_old, x_old, y_old,
+                     state.w_new, state.w_old, state.lambda,
+                     (i >= width) && (width > 1), state.center);
+      
+      if (status_new && status_scale) {
+        state.x_last[j] = data(r, j);
+      }
+      
+      if (!status_out) {
+        continue;
+      }
+      
+      // degrees of freedom and intercept std.error
+      if (status_lm && (j == state.n_cols_x - 1) && (k == state.n_cols_x - 1)) {
+        
+        arma_n_obs[r] = moments.n_obs;
+        arma_sum_w[r] = moments.sum_w;
+        
+      }
+      
+      // intercept
+      if (status_lm && (j == k)) {
+        arma_mean(r, j) = moments.mean_x;
+      }
+      
+      bool status_na = std::isnan(data(r, j)) || std::isnan(data(r, k));
+      int n_obs = moments.n_obs;
+      long double sum_w = moments.sum_w;
+      long double var_x = moments.sumsq_x / (sum_w - moments.sumsq_w / sum_w);
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if (state.na_restore && status_na) {
+        
+        // can be either NA or NaN
+        if (status_pair) {
+          
+          if (std::isnan(data(r, j))) {
+            arma_cov(j, k_cov, r) = data(r, j);
+          } else {
+            arma_cov(j, k_cov, r) = data(r, k);
+          }
+          
+        } else {
+          arma_value(r, j) = data(r, j);
+        }
+        
+      } else if (status_sum || status_mean) {
+        
+        if (n_obs >= state.min_obs) {
+          arma_value(r, j) = status_sum ? moments.sum_x : moments.sum_x / sum_w;
+        } else {
+          arma_value(r, j) = NA_REAL;
+        }
+        
+      } else if (status_var || status_sd) {
+        
+        if ((n_obs > 1) && (n_obs >= state.min_obs)) {
+          arma_value(r, j) = status_var ? var_x : sqrt(var_x);
+        } else {
+          arma_value(r, j) = NA_REAL;
+        }
+        
+      } else if (status_scale) {
+        
+        long double x_ij = state.x_last[j];
+        
+        if (n_obs >= state.min_obs) {
+          
+          if (state.scale && ((n_obs <= 1) || (var_x < 0) ||
+              (sqrt(var_x) <= sqrt(arma::datum::eps)))) {
+            arma_value(r, j) = NA_REAL;
+          } else if (state.center && state.scale) {
+            arma_value(r, j) = (x_ij - moments.mean_x) / sqrt(var_x);
+          } else if (!state.center && state.scale) {
+            arma_value(r, j) = x_ij / sqrt(var_x);
+          } else if (state.center && !state.scale) {
+            arma_value(r, j) = x_ij - moments.mean_x;
+          } else if (!state.center && !state.scale) {
+            arma_value(r, j) = x_ij;
+          }
+          
+        } else {
+          arma_value(r, j) = NA_REAL;
+        }
+        
+      } else {
+        
+        long double sumsq_x = moments.sumsq_x;
+        long double sumsq_y = moments.sumsq_y;
+        long double sumsq_xy = moments.sumsq_xy;
+        
+        // covariances require more than one observation
+        if ((n_obs >= state.min_obs) && (!status_cov || (n_obs > 1))) {
+          
+          if (state.scale) {
+            
+            // don't compute if the standard deviation is zero
+            if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+              
+              arma_cov(j, k_cov, r) = NA_REAL;
+              
+            } else {
+              arma_cov(j, k_cov, r) = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+            }
+            
+          } else if (status_cov) {
+            arma_cov(j, k_cov, r) = sumsq_xy / (sum_w - moments.sumsq_w / sum_w);
+          } else {
+            arma_cov(j, k_cov, r) = sumsq_xy;
+          }
+          
+        } else {
+          arma_cov(j, k_cov, r) = NA_REAL;
+        }
+        
+      }
+      
+      // covariance matrix is symmetric
+      if (state.symmetric && status_pair) {
+        arma_cov(k, j, r) = arma_cov(j, k, r);
+      }
+      
+    }
+    
+  }
+  
+};
+
+// append the rows of 'data' (i.e., 'x' and 'y' by column) to the state, where
+// the statistics of the new rows are only computed if 'status_out'
+inline void update_state(RollState& state, const arma::mat& data,
+                         const bool status_out, arma::mat& arma_value,
+                         arma::cube& arma_cov, arma::vec& arma_n_obs,
+                         arma::vec& arma_sum_w, arma::mat& arma_mean) {
+  
+  int n_rows_data = data.n_rows;
+  arma::uvec arma_any_na(n_rows_data);
+  
+  // rows with any missing value if 'complete_obs' argument is TRUE
+  if (state.complete_obs) {
+    for (int i = 0; i < n_rows_data; i++) {
+      arma_any_na[i] = data.row(i).has_nan() ? 1 : 0;
+    }
+  } else {
+    arma_any_na.fill(0);
+  }
+  
+  RollStateUpdate roll_state_update(state, data, arma_any_na, status_out,
+                                    arma_value, arma_cov,
+                                    arma_n_obs, arma_sum_w, arma_mean);
+  
+  if ((state.type == "min") || (state.type == "max")) {
+    parallelFor(0, state.n_cols_x, roll_state_update);
+  } else {
+    parallelFor(0, state.moments.size(), roll_state_update);
+  }
+  
+  state.push_back(data, arma_any_na);
+  
+}
+
+// checkpoint of the state, i.e., the magic bytes, the version, the byte order
+// and the size of 'long double' (i.e., checked on load), then the fields in order
+const char ROLL_STATE_MAGIC[] = "roll_state";
+const int ROLL_STATE_VERSION = 1;
+const int ROLL_STATE_ORDER = 0x01020304;
+
+// bytes of the fields of the state, where the accumulators are copied as is
+// (i.e., not rounded to 'double') so that a checkpoint resumes bit-identical
+struct RollStateWriter {
+  
+  std::vector<unsigned char> bytes;
+  
+  template <typename T>
+  void field(const T& value) {
+    
+    const unsigned char* begin = reinterpret_cast<const unsigned char*>(&value);
+    bytes.insert(bytes.end(), begin, begin + sizeof(T));
+    
+  }
+  
+  // one byte for each 'bool' (i.e., either 0 or 1)
+  void field(const bool& value) {
+    bytes.push_back(value ? 1 : 0);
+  }
+  
+  void field(const std::string& value) {
+    
+    field((int)value.size());
+    bytes.insert(bytes.end(), value.begin(), value.end());
+    
+  }
+  
+  template <typename T>
+  void field(const std::vector<T>& value) {
+    
+    field((int)value.size());
+    
+    for (std::size_t i = 0; i < value.size(); i++) {
+      field(value[i]);
+    }
+    
+  }
+  
+  void field(const RollMoments& value) {
+    
+    field(value.n_obs);
+    field(value.sum_w);
+    field(value.sum_x);
+    field(value.sum_y);
+    field(value.sumsq_w);
+    field(value.sumsq_x);
+    field(value.sumsq_y);
+    field(value.sumsq_xy);
+    field(value.mean_prev_x);
+    field(value.mean_prev_y);
+    field(value.mean_x);
+    field(value.mean_y);
+    
+  }
+  
+  void field(const RollMonotonicQueue& value) {
+    
+    field(value.ring);
+    field(value.mask);
+    field(value.head);
+    field(value.tail);
+    
+  }
+  
+};
+
+// fields of the state from the bytes of 'RollStateWriter'
+struct RollStateReader {
+  
+  const unsigned char* bytes;
+  const std::size_t n_size;
+  std::size_t pos;
+  
+  RollStateReader(const unsigned char* bytes, const std::size_t n_size)
+    : bytes(bytes), n_size(n_size), pos(0) { }
+  
+  template <typename T>
+  void field(T& value) {
+    
+    if (n_size - pos < sizeof(T)) {
+      stop("checkpoint of 'state' is truncated");
+    }
+    
+    std::memcpy(&value, bytes + pos, sizeof(T));
+    pos += sizeof(T);
+    
+  }
+  
+  // not copied as is, i.e., any other byte than 0 or 1 is not a 'bool'
+  void field(bool& value) {
+    
+    unsigned char byte;
+    field(byte);
+    
+    if (byte > 1) {
+      stop("checkpoint of 'state' is corrupt");
+    }
+    
+    value = (byte == 1);
+    
+  }
+  
+  // number of elements, where each element is at least one byte
+  int field_size() {
+    
+    int value;
+    field(value);
+    
+    if ((value < 0) || ((std::size_t)value > n_size - pos)) {
+      stop("checkpoint of 'state' is truncated");
+    }
+    
+    return value;
+    
+  }
+  
+  void field(std::string& value) {
+    
+    int n = field_size();
+    value.assign(reinterpret_cast<const char*>(bytes + pos), n);
+    pos += n;
+    
+  }
+  
+  template <typename T>
+  void field(std::vector<T>& value) {
+    
+    value.resize(field_size());
+    
+    for (std::size_t i = 0; i < value.size(); i++) {
+      field(value[i]);
+    }
+    
+  }
+  
+  void field(std::vector<RollMonotonicQueue>& value) {
+    
+    value.resize(field_size(), RollMonotonicQueue(0));
+    
+    for (std::size_t i = 0; i < value.size(); i++) {
+      field(value[i]);
+    }
+    
+  }
+  
+  void field(RollMoments& value) {
+    
+    field(value.n_obs);
+    field(value.sum_w);
+    field(value.sum_x);
+    field(value.sum_y);
+    field(value.sumsq_w);
+    field(value.sumsq_x);
+    field(value.sumsq_y);
+    field(value.sumsq_xy);
+    field(value.mean_prev_x);
+    field(value.mean_prev_y);
+    field(value.mean_x);
+    field(value.mean_y);
+    
+  }
+  
+  void field(RollMonotonicQueue& value) {
+    
+    field(value.ring);
+    field(value.mask);
+    field(value.head);
+    field(value.tail);
+    
+    if ((value.ring.size() != value.mask + 1) || (value.tail - value.head > value.mask + 1)) {
+      stop("checkpoint of 'state' is corrupt");
+    }
+    
+  }
+  
+};
+
+// fields of the state in order for both 'RollStateWriter' and 'RollStateReader'
+template <typename T, typename S>
+inline void fields_state(T& bytes, S& state) {
+  
+  bytes.field(state.type);
+  bytes.field(state.width);
+  bytes.field(state.min_obs);
+  bytes.field(state.complete_obs);
+  bytes.field(state.na_restore);
+  bytes.field(state.center);
+  bytes.field(state.scale);
+  bytes.field(state.intercept);
+  bytes.field(state.status_vec);
+  bytes.field(state.symmetric);
+  bytes.field(state.n_cols_x);
+  bytes.field(state.n_cols_y);
+  bytes.field(state.n_cols);
+  bytes.field(state.lambda);
+  bytes.field(state.w_new);
+  bytes.field(state.w_old);
+  bytes.field(state.n_rows);
+  bytes.field(state.ring);
+  bytes.field(state.ring_any_na);
+  bytes.field(state.pair_x);
+  bytes.field(state.pair_y);
+  bytes.field(state.moments);
+  bytes.field(state.decks);
+  bytes.field(state.n_obs);
+  bytes.field(state.x_last);
+  bytes.field(state.names_x);
+  bytes.field(state.names_y);
+  
+}
+
+// invariants of the state that the updates rely on (i.e., the indices into the
+// ring buffer and of the columns) for a checkpoint that is loaded
+inline bool check_state(const RollState& state) {
+  
+  bool status_deck = (state.type == "min") || (state.type == "max");
+  bool status_pair = (state.type == "cov") || (state.type == "crossprod") ||
+    (state.type == "lm");
+  bool status_x = (state.type == "sum") || (state.type == "mean") ||
+    (state.type == "var") || (state.type == "sd") || (state.type == "scale");
+  
+  if ((!status_deck && !status_pair && !status_x) ||
+      (state.width < 1) || (state.min_obs < 1) || (state.n_rows < 0) ||
+      (state.n_cols_x < 1) || (state.n_cols_y < 0) ||
+      (state.n_cols != (state.symmetric ? state.n_cols_x : state.n_cols_x + state.n_cols_y))) {
+    return false;
+  }
+  
+  std::size_t n_size = std::min(state.width, state.n_rows);
+  
+  if ((state.ring.size() != n_size * state.n_cols) ||
+      (state.ring_any_na.size() != n_size) ||
+      (state.pair_x.size() != state.moments.size()) ||
+      (state.pair_y.size() != state.moments.size()) ||
+      (state.decks.size() != (status_deck ? (std::size_t)state.n_cols_x : 0)) ||
+      (state.n_obs.size() != state.decks.size()) ||
+      (state.x_last.size() != (status_x ? (std::size_t)state.n_cols_x : 0)) ||
+      (status_deck && !state.moments.empty())) {
+    return false;
+  }
+  
+  for (std::size_t z = 0; z < state.moments.size(); z++) {
+    
+    if ((state.pair_x[z] < 0) || (state.pair_x[z] >= state.n_cols_x) ||
+        (state.pair_y[z] < 0) || (state.pair_y[z] >= state.n_cols)) {
+      return false;
+    }
+    
+  }
+  
+  // rows of each queue are in the window of the last row
+  for (std::size_t j = 0; j < state.decks.size(); j++) {
+    
+    const RollMonotonicQueue& deck = state.decks[j];
+    
+    if ((state.n_obs[j] < 0) || (state.n_obs[j] > (int)n_size)) {
+      return false;
+    }
+    
+    for (unsigned int k = deck.head; k != deck.tail; k++) {
+      
+      int row = deck.ring[k & deck.mask];
+      
+      if ((row < state.n_rows - state.width) || (row < 0) || (row >= state.n_rows)) {
+        return false;
+      }
+      
+    }
+    
+  }
+  
+  return true;
+  
+}
+
+inline std::vector<unsigned char> save_state(const RollState& state) {
+  
+  RollStateWriter bytes;
+  
+  bytes.bytes.insert(bytes.bytes.end(), ROLL_STATE_MAGIC,
+                     ROLL_STATE_MAGIC + sizeof(ROLL_STATE_MAGIC) - 1);
+  bytes.field(ROLL_STATE_VERSION);
+  bytes.field(ROLL_STATE_ORDER);
+  bytes.field((int)sizeof(long double));
+  fields_state(bytes, state);
+  
+  return bytes.bytes;
+  
+}
+
+inline void load_state(RollState& state, const unsigned char* x, const std::size_t n_size) {
+  
+  const std::size_t n_magic = sizeof(ROLL_STATE_MAGIC) - 1;
+  
+  if ((n_size < n_magic) || (std::memcmp(x, ROLL_STATE_MAGIC, n_magic) != 0)) {
+    stop("value of 'x' must be a checkpoint of 'state'");
+  }
+  
+  RollStateReader bytes(x + n_magic, n_size - n_magic);
+  int version;
+  int order;
+  int n_long_double;
+  
+  bytes.field(version);
+  bytes.field(order);
+  bytes.field(n_long_double);
+  
+  if (version != ROLL_STATE_VERSION) {
+    stop("version of the checkpoint of 'state' is not supported");
+  } else if ((order != ROLL_STATE_ORDER) || (n_long_double != (int)sizeof(long double))) {
+    stop("checkpoint of 'state' must be from the same platform");
+  }
+  
+  fields_state(bytes, state);
+  
+  if ((bytes.pos != bytes.n_size) || !check_state(state)) {
+    stop("checkpoint of 'state' is corrupt");
+  }
+  
+}
+
+}
+
+#endif
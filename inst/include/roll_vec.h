@@ -5,6 +5,8 @@
 
 #include <RcppArmadillo.h>
 #include <RcppParallel.h>
+#include "roll_order.h"
+#include "roll_accum.h"
 using namespace Rcpp;
 using namespace RcppParallel;
 
@@ -391,133 +393,182 @@ struct RollAllOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollSumOnlineVec {
+template <typename Accum>
+struct RollSumOnlineVec : public Worker {
+  
+  typedef typename Accum::value_type value_type;
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
+  const int reanchor;
   arma::vec& arma_sum;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollSumOnlineVec(const NumericVector x, const int n,
-                   const int n_rows_x, const int width,
-                   const arma::vec arma_weights, const int min_obs,
-                   const bool na_restore, arma::vec& arma_sum)
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const int min_obs, const bool na_restore,
+                   const int reanchor, arma::vec& arma_sum,
+                   arma::vec& arma_reanchor)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), arma_sum(arma_sum) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      reanchor(reanchor), arma_sum(arma_sum),
+      arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by column
-  void operator()() {
-    
-    int n_obs = 0;
-    long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0;
-    long double x_new = 0;
-    long double x_old = 0;
-    long double sum_x = 0;
-    
-    if (arma_weights[n - 1] == 0) {
-      lambda = 1;
-    } else if (width > 1) {
-      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-    } else {
-      lambda = arma_weights[n - 1];
-    }
-    
-    for (int i = 0; i < n_rows_x; i++) {
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
       
-      if (std::isnan(x[i])) {
-        
-        w_new = 0;
-        x_new = 0;
-        
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      int n_obs = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0;
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_x;
+      
+      if (arma_weights[n - 1] == 0) {
+        lambda = 1;
+      } else if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
       } else {
-        
-        w_new = arma_weights[n - 1];
-        x_new = x[i];
-        
+        lambda = arma_weights[n - 1];
       }
       
-      // expanding window
-      if (i < width) {
-        
-        // don't include if missing value
-        if (!std::isnan(x[i])) {
-          n_obs += 1;
-        }
+      for (int i = offset; i < end_row; i++) {
         
-        if (width > 1) {
-          sum_x = lambda * sum_x + w_new * x_new;
+        if (std::isnan(x[i])) {
+          
+          w_new = 0;
+          x_new = 0;
+          
         } else {
-          sum_x = w_new * x_new;
+          
+          w_new = arma_weights[n - 1];
+          x_new = x[i];
+          
         }
         
-      }
-      
-      // rolling window
-      if (i >= width) {
+        // expanding window
+        if (i < offset + width) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i])) {
+            n_obs += 1;
+          }
+          
+          if (width > 1) {
+            
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            
+          } else {
+            
+            sum_x.set(w_new * x_new);
+            
+          }
+          
+        }
         
-        // don't include if missing value
-        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+        // rolling window
+        if (i >= offset + width) {
           
-          n_obs += 1;
+          // don't include if missing value
+          if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            n_obs += 1;
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            n_obs -= 1;
+            
+          }
           
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+          if (std::isnan(x[i - width])) {
+            
+            w_old = 0;
+            x_old = 0;
+            
+          } else {
+            
+            w_old = arma_weights[n - width];
+            x_old = x[i - width];
+            
+          }
           
-          n_obs -= 1;
+          if (width > 1) {
+            
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            
+          } else {
+            
+            sum_x.set(w_new * x_new);
+            
+          }
           
         }
         
-        if (std::isnan(x[i - width])) {
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
           
-          w_old = 0;
-          x_old = 0;
+          RollReanchor exact(x.begin(), x.begin(), NULL,
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, false);
           
-        } else {
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sum_x.value() - exact.sum_x));
+          }
           
-          w_old = arma_weights[n - width];
-          x_old = x[i - width];
+          sum_x.set(exact.sum_x);
           
         }
         
-        if (width > 1) {
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-        } else {
-          sum_x = w_new * x_new;
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
-      }
-      
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
-        
-        if (n_obs >= min_obs) {
-          arma_sum[i] = sum_x;
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          if (n_obs >= min_obs) {
+            arma_sum[i] = sum_x.value();
+          } else {
+            arma_sum[i] = NA_REAL;
+          }
+          
         } else {
-          arma_sum[i] = NA_REAL;
+          
+          // can be either NA or NaN
+          arma_sum[i] = x[i];
+          
         }
         
-      } else {
-        
-        // can be either NA or NaN
-        arma_sum[i] = x[i];
-        
       }
       
     }
-    
   }
   
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
+template <typename Accum>
 struct RollSumOfflineVec : public Worker {
   
   const RVector<double> x;      // source
@@ -548,7 +599,7 @@ struct RollSumOfflineVec : public Worker {
       
       int count = 0;
       int n_obs = 0;
-      long double sum_x = 0;
+      Accum sum_x;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
@@ -561,7 +612,7 @@ struct RollSumOfflineVec : public Worker {
           if (!std::isnan(x[i - count])) {
             
             // compute the sum
-            sum_x += arma_weights[n - count - 1] * x[i - count];
+            sum_x.add(arma_weights[n - count - 1] * x[i - count]);
             n_obs += 1;
             
           }
@@ -571,7 +622,7 @@ struct RollSumOfflineVec : public Worker {
         }
         
         if (n_obs >= min_obs) {
-          arma_sum[i] = sum_x;
+          arma_sum[i] = sum_x.value();
         } else {
           arma_sum[i] = NA_REAL;
         }
@@ -588,263 +639,270 @@ struct RollSumOfflineVec : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollProdOnlineVec {
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollSumPrefixVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_prod;         // destination (pass by reference)
+  arma::vec& arma_sum;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollProdOnlineVec(const NumericVector x, const int n,
-                    const int n_rows_x, const int width,
-                    const arma::vec arma_weights, const int min_obs,
-                    const bool na_restore, arma::vec& arma_prod)
+  RollSumPrefixVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const int min_obs, const bool na_restore,
+                   arma::vec& arma_sum)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), arma_prod(arma_prod) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_sum(arma_sum) { }
   
-  // function call operator that iterates by column
-  void operator()() {
-    
-    int n_obs = 0;
-    int n_zero = 0;
-    long double lambda = 0;
-    long double n_new = 0;
-    long double n_old = 0;
-    long double n_exp = 0;
-    long double w_new = 0;
-    long double w_old = 0;
-    long double x_new = 0;
-    long double x_old = 0;
-    long double prod_w = 1;
-    long double prod_x = 1;
-    
-    if (arma_weights[n - 1] == 0) {
-      lambda = 1;
-    } else if (width > 1) {
-      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-    } else {
-      lambda = arma_weights[n - 1];
-    }
-    
-    for (int i = 0; i < n_rows_x; i++) {
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // expanding window
-      if (i < width) {
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double value[1];
+      long double sum[1];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 1, offset);
+      
+      for (int i = offset; i < end_row; i++) {
         
         // don't include if missing value
         if (!std::isnan(x[i])) {
-          n_obs += 1;
-        }
-        
-        if (std::isnan(x[i])) {
           
-          n_new = n_obs;
-          w_new = 1;
-          x_new = 1;
+          value[0] = x[i];
+          prefix.push_back(i, value);
           
         } else {
-          
-          n_new = n_obs - 1;
-          w_new = arma_weights[n - 1];
-          
-          if (x[i] == 0) {
-            
-            x_new = 1;
-            n_zero += 1;
-            
-          } else {
-            x_new = x[i];
-          }
-          
+          prefix.push_back(i, NULL);
         }
         
-        if (n_new == 0) {
-          n_exp = 1;
-        } else if (n_new > n_old) {
-          n_exp = n_exp * lambda;
-        } else if (n_new < n_old) {
-          n_exp = n_exp / lambda;
-        }
-        
-        n_old = n_new;
-        prod_w *= w_new * n_exp;
-        prod_x *= x_new;
-        
-      }
-      
-      // rolling window
-      if (i >= width) {
-        
-        // don't include if missing value
-        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
-          
-          n_obs += 1;
-          
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
-          
-          n_obs -= 1;
-          
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
-        if (std::isnan(x[i])) {
-          
-          n_new = n_obs;
-          w_new = 1;
-          x_new = 1;
-          
-        } else {
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
           
-          n_new = n_obs - 1;
-          w_new = arma_weights[n - 1];
+          int n_obs = prefix.window(i, i - width, sum);
           
-          if (x[i] == 0) {
-            
-            x_new = 1;
-            n_zero += 1;
-            
+          if (n_obs >= min_obs) {
+            arma_sum[i] = w * sum[0];
           } else {
-            x_new = x[i];
+            arma_sum[i] = NA_REAL;
           }
           
-        }
-        
-        if (std::isnan(x[i - width])) {
-          
-          w_old = 1;
-          x_old = 1;
-          
         } else {
           
-          if (x[i - width] == 0) {
-            
-            x_old = 1;
-            n_zero -= 1;
-            
-          } else {
-            x_old = x[i - width];
-          }
-          
-          if (arma_weights[n - width] == 0) {
-            w_old = 1;
-          } else {
-            w_old = arma_weights[n - width];
-          }
-          
-        }
-        
-        if (n_new == 0) {
-          n_exp = 1;
-        } else if (n_new > n_old) {
-          n_exp = n_exp * lambda;
-        } else if (n_new < n_old) {
-          n_exp = n_exp / lambda;
-        }
-        
-        n_old = n_new;
-        prod_w *= w_new * n_exp / w_old;
-        prod_x *= x_new / x_old;
-        
-      }
-      
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
-        
-        if (n_obs >= min_obs) {
-          
-          if (n_zero == 0) {
-            arma_prod[i] = prod_w * prod_x;
-          } else {
-            arma_prod[i]= 0;
-          }
+          // can be either NA or NaN
+          arma_sum[i] = x[i];
           
-        } else {
-          arma_prod[i] = NA_REAL;
         }
         
-      } else {
-        
-        // can be either NA or NaN
-        arma_prod[i] = x[i];
-        
       }
       
     }
-    
   }
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollProdOfflineVec : public Worker {
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollSumLinearVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_prod;         // destination (pass by reference)
+  arma::vec& arma_sum;          // destination (pass by reference)
   
   // initialize with source and destination
-  RollProdOfflineVec(const NumericVector x, const int n,
-                     const int n_rows_x, const int width,
-                     const arma::vec arma_weights, const int min_obs,
-                     const bool na_restore, arma::vec& arma_prod)
+  RollSumLinearVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const int min_obs, const bool na_restore,
+                   arma::vec& arma_sum)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), arma_prod(arma_prod) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_sum(arma_sum) { }
   
-  // function call operator that iterates by index
+  // function call operator that iterates by chunk of rows
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 2D array
-      int i = z;
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
-      int count = 0;
-      int n_obs = 0;
-      long double prod_x = 1;
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double value[1];
+      long double sum[1];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 1, offset,
+                            arma_weights[n - 1], delta);
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+      for (int i = offset; i < end_row; i++) {
         
-        // number of observations is either the window size or,
-        // for partial results, the number of the current row
-        while ((width > count) && (i >= count)) {
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
           
-          // don't include if missing value
-          if (!std::isnan(x[i - count])) {
-            
-            // compute the product
-            prod_x *= arma_weights[n - count - 1] * x[i - count];
-            n_obs += 1;
-            
+          value[0] = x[i];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if (n_obs >= min_obs) {
+            arma_sum[i] = sum[0];
+          } else {
+            arma_sum[i] = NA_REAL;
           }
           
-          count += 1;
+        } else {
+          
+          // can be either NA or NaN
+          arma_sum[i] = x[i];
           
         }
         
-        if (n_obs >= min_obs) {
-          arma_prod[i] = prod_x;
-        } else {
-          arma_prod[i] = NA_REAL;
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using the fast Fourier
+// transform, i.e., blocks of 'n_fft' rows that overlap by 'width' - 1 rows are
+// multiplied by the transform of the weights (overlap-save)
+struct RollSumFFTVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_fft;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  arma::cx_vec arma_weights_fft;
+  arma::vec& arma_sum;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollSumFFTVec(const NumericVector x, const int n,
+                const int n_rows_x, const int n_fft,
+                const int width, const arma::vec arma_weights,
+                const int min_obs, const bool na_restore,
+                arma::vec& arma_sum)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_fft(n_fft),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_sum(arma_sum) {
+    
+    // weights by lag (i.e., the current row has the last weight)
+    int n_size_x = std::min(width, n_rows_x);
+    arma::cx_vec arma_lag(n_fft, arma::fill::zeros);
+    
+    for (int count = 0; count < n_size_x; count++) {
+      arma_lag[count] = arma_weights[n - count - 1];
+    }
+    
+    arma_weights_fft = arma::fft(arma_lag);
+    
+  }
+  
+  // function call operator that iterates by block of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each block includes the previous 'width' - 1 rows
+      int n_size_x = std::min(width, n_rows_x);
+      int n_step = n_fft - n_size_x + 1;
+      int begin_row = z * n_step;
+      int end_row = std::min(begin_row + n_step, n_rows_x);
+      int offset = begin_row - n_size_x + 1;
+      
+      int n_obs = 0;
+      arma::cx_vec arma_block(n_fft, arma::fill::zeros);
+      
+      for (int i = std::max(0, offset); i < std::min(offset + n_fft, n_rows_x); i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          arma_block[i - offset] = x[i];
         }
         
-      } else {
+      }
+      
+      // number of observations in the window of the previous row
+      for (int i = std::max(0, begin_row - n_size_x); i < begin_row; i++) {
+        if (!std::isnan(x[i])) {
+          n_obs += 1;
+        }
+      }
+      
+      // circular convolution, where the first 'width' - 1 rows wrap around
+      convolve_block(arma_block, arma_weights_fft, arma_weights, n, n_size_x);
+      
+      for (int i = begin_row; i < end_row; i++) {
         
-        // can be either NA or NaN
-        arma_prod[i] = x[i];
+        if (!std::isnan(x[i])) {
+          n_obs += 1;
+        }
+        
+        if ((i >= n_size_x) && !std::isnan(x[i - n_size_x])) {
+          n_obs -= 1;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          if (n_obs >= min_obs) {
+            arma_sum[i] = std::real(arma_block[i - offset]);
+          } else {
+            arma_sum[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sum[i] = x[i];
+          
+        }
         
       }
       
@@ -854,7 +912,7 @@ struct RollProdOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMeanOnlineVec {
+struct RollProdOnlineVec {
   
   const RVector<double> x;      // source
   const int n;
@@ -863,31 +921,29 @@ struct RollMeanOnlineVec {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_mean;         // destination (pass by reference)
+  arma::vec& arma_prod;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMeanOnlineVec(const NumericVector x, const int n,
+  RollProdOnlineVec(const NumericVector x, const int n,
                     const int n_rows_x, const int width,
                     const arma::vec arma_weights, const int min_obs,
-                    const bool na_restore, arma::vec& arma_mean)
+                    const bool na_restore, arma::vec& arma_prod)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), arma_mean(arma_mean) { }
+      na_restore(na_restore), arma_prod(arma_prod) { }
   
-  // function call operator that iterates by index
+  // function call operator that iterates by column
   void operator()() {
     
     int n_obs = 0;
     long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0;
-    long double x_new = 0;
-    long double x_old = 0;
-    long double sum_w = 0;
-    long double sum_x = 0;
+    long double sum_rows = 0;
+    RollTwoStacks<RollProdMonoid> stacks(std::min(width, n_rows_x));
     
-    if (width > 1) {
+    if (arma_weights[n - 1] == 0) {
+      lambda = 1;
+    } else if (width > 1) {
       lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
     } else {
       lambda = arma_weights[n - 1];
@@ -895,18 +951,6 @@ struct RollMeanOnlineVec {
     
     for (int i = 0; i < n_rows_x; i++) {
       
-      if (std::isnan(x[i])) {
-        
-        w_new = 0;
-        x_new = 0;
-        
-      } else {
-        
-        w_new = arma_weights[n - 1];
-        x_new = x[i];
-        
-      }
-      
       // expanding window
       if (i < width) {
         
@@ -915,18 +959,6 @@ struct RollMeanOnlineVec {
           n_obs += 1;
         }
         
-        if (width > 1) {
-          
-          sum_w = lambda * sum_w + w_new;
-          sum_x = lambda * sum_x + w_new * x_new;
-          
-        } else {
-          
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          
-        }
-        
       }
       
       // rolling window
@@ -943,29 +975,20 @@ struct RollMeanOnlineVec {
           
         }
         
-        if (std::isnan(x[i - width])) {
-          
-          w_old = 0;
-          x_old = 0;
+        // at most one row leaves the window
+        if (!stacks.empty() && (stacks.row() <= i - width)) {
           
-        } else {
-          
-          w_old = arma_weights[n - width];
-          x_old = x[i - width];
+          sum_rows -= stacks.row();
+          stacks.pop_front();
           
         }
         
-        if (width > 1) {
-          
-          sum_w = lambda * sum_w + w_new - lambda * w_old;
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-          
-        } else {
-          
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          
-        }
+      }
+      
+      if (!std::isnan(x[i])) {
+        
+        sum_rows += i;
+        stacks.push_back(x[i], i);
         
       }
       
@@ -973,15 +996,23 @@ struct RollMeanOnlineVec {
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
         if (n_obs >= min_obs) {
-          arma_mean[i] = sum_x / sum_w;
+          
+          // weight of each observation is the last weight times 'lambda'
+          // to the power of its age (i.e., the sum of the ages is the
+          // number of observations times the current row less the rows)
+          long double prod_w = std::pow((long double)arma_weights[n - 1], n_obs) *
+            std::pow(lambda, n_obs * (long double)i - sum_rows);
+          
+          arma_prod[i] = prod_w * stacks.query();
+          
         } else {
-          arma_mean[i] = NA_REAL;
+          arma_prod[i] = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        arma_mean[i] = x[i];
+        arma_prod[i] = x[i];
         
       }
       
@@ -992,7 +1023,7 @@ struct RollMeanOnlineVec {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMeanOfflineVec : public Worker {
+struct RollProdOfflineVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
@@ -1001,28 +1032,28 @@ struct RollMeanOfflineVec : public Worker {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_mean;         // destination (pass by reference)
+  arma::vec& arma_prod;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMeanOfflineVec(const NumericVector x, const int n,
+  RollProdOfflineVec(const NumericVector x, const int n,
                      const int n_rows_x, const int width,
                      const arma::vec arma_weights, const int min_obs,
-                     const bool na_restore, arma::vec& arma_mean)
+                     const bool na_restore, arma::vec& arma_prod)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), arma_mean(arma_mean) { }
+      na_restore(na_restore), arma_prod(arma_prod) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
+      // from 1D to 2D array
       int i = z;
       
       int count = 0;
       int n_obs = 0;
-      long double sum_w = 0;
-      long double sum_x = 0;
+      long double prod_x = 1;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
@@ -1034,8 +1065,8 @@ struct RollMeanOfflineVec : public Worker {
           // don't include if missing value
           if (!std::isnan(x[i - count])) {
             
-            sum_w += arma_weights[n - count - 1];
-            sum_x += arma_weights[n - count - 1] * x[i - count];
+            // compute the product
+            prod_x *= arma_weights[n - count - 1] * x[i - count];
             n_obs += 1;
             
           }
@@ -1045,16 +1076,15 @@ struct RollMeanOfflineVec : public Worker {
         }
         
         if (n_obs >= min_obs) {
-          arma_mean[i] = sum_x / sum_w;
+          arma_prod[i] = prod_x;
         } else {
-          arma_mean[i] = NA_REAL;
+          arma_prod[i] = NA_REAL;
         }
         
-        
       } else {
         
         // can be either NA or NaN
-        arma_mean[i] = x[i];
+        arma_prod[i] = x[i];
         
       }
       
@@ -1064,122 +1094,190 @@ struct RollMeanOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMinOnlineVec {
+template <typename Accum>
+struct RollMeanOnlineVec : public Worker {
+  
+  typedef typename Accum::value_type value_type;
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<double> rcpp_min;     // destination (pass by reference)
+  const int reanchor;
+  arma::vec& arma_mean;         // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
-  RollMinOnlineVec(const NumericVector x, const int n,
-                   const int n_rows_x, const int width,
-                   const arma::vec arma_weights, const int min_obs,
-                   const bool na_restore, NumericVector rcpp_min)
+  RollMeanOnlineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int n_rows_chunk,
+                    const int width, const arma::vec arma_weights,
+                    const int min_obs, const bool na_restore,
+                    const int reanchor, arma::vec& arma_mean,
+                    arma::vec& arma_reanchor)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_min(rcpp_min) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      reanchor(reanchor), arma_mean(arma_mean),
+      arma_reanchor(arma_reanchor) { }
   
-  // function call operator that iterates by index
-  void operator()() {
-    
-    int n_obs = 0;
-    int idxmin_x = 0;
-    std::deque<int> deck(width);
-    
-    for (int i = 0; i < n_rows_x; i++) {
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // expanding window
-      if (i < width) {
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      int n_obs = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0;
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
+      
+      if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      } else {
+        lambda = arma_weights[n - 1];
+      }
+      
+      for (int i = offset; i < end_row; i++) {
         
-        // don't include if missing value
-        if (!std::isnan(x[i])) {
-          n_obs += 1;
+        if (std::isnan(x[i])) {
+          
+          w_new = 0;
+          x_new = 0;
+          
+        } else {
+          
+          w_new = arma_weights[n - 1];
+          x_new = x[i];
+          
         }
         
-        if (!std::isnan(x[i])) {
+        // expanding window
+        if (i < offset + width) {
           
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] < x[deck.back()]))) {
-            deck.pop_back();
+          // don't include if missing value
+          if (!std::isnan(x[i])) {
+            n_obs += 1;
           }
           
-          deck.push_back(i);
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            
+          }
           
         }
         
-        if (width > 1) {
-          idxmin_x = deck.front();
-        } else {
-          idxmin_x = i;
-        }
-        
-      }
-      
-      // rolling window
-      if (i >= width) {
-        
-        // don't include if missing value
-        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+        // rolling window
+        if (i >= offset + width) {
           
-          n_obs += 1;
+          // don't include if missing value
+          if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            n_obs += 1;
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            n_obs -= 1;
+            
+          }
           
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+          if (std::isnan(x[i - width])) {
+            
+            w_old = 0;
+            x_old = 0;
+            
+          } else {
+            
+            w_old = arma_weights[n - width];
+            x_old = x[i - width];
+            
+          }
           
-          n_obs -= 1;
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            
+          }
           
         }
         
-        if (!std::isnan(x[i])) {
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(x.begin(), x.begin(), NULL,
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, false);
           
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] < x[deck.back()]))) {
-            deck.pop_back();
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sum_x.value() - exact.sum_x));
           }
           
-          deck.push_back(i);
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
           
         }
         
-        while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
-          deck.pop_front();
-        }
-        
-        if (width > 1) {
-          idxmin_x = deck.front();
-        } else {
-          idxmin_x = i;
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
-      }
-      
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
-        
-        if (n_obs >= min_obs) {
-          rcpp_min[i] = x[idxmin_x];
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          if (n_obs >= min_obs) {
+            arma_mean[i] = sum_x.value() / sum_w.value();
+          } else {
+            arma_mean[i] = NA_REAL;
+          }
+          
         } else {
-          rcpp_min[i] = NA_REAL;
+          
+          // can be either NA or NaN
+          arma_mean[i] = x[i];
+          
         }
         
-      } else {
-        
-        // can be either NA or NaN
-        rcpp_min[i] = x[i];
-        
       }
       
     }
-    
   }
   
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMinOfflineVec : public Worker {
+template <typename Accum>
+struct RollMeanOfflineVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
@@ -1188,28 +1286,28 @@ struct RollMinOfflineVec : public Worker {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<double> rcpp_min;     // destination (pass by reference)
+  arma::vec& arma_mean;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMinOfflineVec(const NumericVector x, const int n,
-                    const int n_rows_x, const int width,
-                    const arma::vec arma_weights, const int min_obs,
-                    const bool na_restore, NumericVector rcpp_min)
+  RollMeanOfflineVec(const NumericVector x, const int n,
+                     const int n_rows_x, const int width,
+                     const arma::vec arma_weights, const int min_obs,
+                     const bool na_restore, arma::vec& arma_mean)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_min(rcpp_min) { }
+      na_restore(na_restore), arma_mean(arma_mean) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 2D array
       int i = z;
       
       int count = 0;
       int n_obs = 0;
-      int idxmin_x = i;
+      Accum sum_w;
+      Accum sum_x;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
@@ -1221,12 +1319,8 @@ struct RollMinOfflineVec : public Worker {
           // don't include if missing value
           if (!std::isnan(x[i - count])) {
             
-            // last element of sorted array
-            // note: 'weights' must be greater than 0
-            if (std::isnan(x[idxmin_x]) || (x[i - count] <= x[idxmin_x])) {
-              idxmin_x = i - count;
-            }
-            
+            sum_w.add(arma_weights[n - count - 1]);
+            sum_x.add(arma_weights[n - count - 1] * x[i - count]);
             n_obs += 1;
             
           }
@@ -1235,16 +1329,17 @@ struct RollMinOfflineVec : public Worker {
           
         }
         
-        if ((n_obs >= min_obs)) {
-          rcpp_min[i] = x[idxmin_x];
+        if (n_obs >= min_obs) {
+          arma_mean[i] = sum_x.value() / sum_w.value();
         } else {
-          rcpp_min[i] = NA_REAL;
+          arma_mean[i] = NA_REAL;
         }
         
+        
       } else {
         
         // can be either NA or NaN
-        rcpp_min[i] = x[i];
+        arma_mean[i] = x[i];
         
       }
       
@@ -1253,188 +1348,164 @@ struct RollMinOfflineVec : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollMaxOnlineVec {
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollMeanPrefixVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<double> rcpp_max;     // destination (pass by reference)
+  arma::vec& arma_mean;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMaxOnlineVec(const NumericVector x, const int n,
-                   const int n_rows_x, const int width,
-                   const arma::vec arma_weights, const int min_obs,
-                   const bool na_restore, NumericVector rcpp_max)
+  RollMeanPrefixVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int n_rows_chunk,
+                    const int width, const arma::vec arma_weights,
+                    const int min_obs, const bool na_restore,
+                    arma::vec& arma_mean)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_max(rcpp_max) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_mean(arma_mean) { }
   
-  // function call operator that iterates by index
-  void operator()() {
-    
-    int n_obs = 0;
-    int idxmax_x = 0;
-    std::deque<int> deck(width);
-    
-    for (int i = 0; i < n_rows_x; i++) {
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // expanding window
-      if (i < width) {
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double value[1];
+      long double sum[1];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 1, offset);
+      
+      for (int i = offset; i < end_row; i++) {
         
         // don't include if missing value
         if (!std::isnan(x[i])) {
-          n_obs += 1;
-        }
-        
-        if (!std::isnan(x[i])) {
-          
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] > x[deck.back()]))) {
-            deck.pop_back();
-          }
           
-          deck.push_back(i);
+          value[0] = x[i];
+          prefix.push_back(i, value);
           
-        }
-        
-        if (width > 1) {
-          idxmax_x = deck.front();
         } else {
-          idxmax_x = i;
+          prefix.push_back(i, NULL);
         }
         
-      }
-      
-      // rolling window
-      if (i >= width) {
-        
-        // don't include if missing value
-        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
-          
-          n_obs += 1;
-          
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
-          
-          n_obs -= 1;
-          
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
         }
         
-        if (!std::isnan(x[i])) {
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
           
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] > x[deck.back()]))) {
-            deck.pop_back();
-          }
+          int n_obs = prefix.window(i, i - width, sum);
           
-          deck.push_back(i);
+          if (n_obs >= min_obs) {
+            arma_mean[i] = (w * sum[0]) / (w * n_obs);
+          } else {
+            arma_mean[i] = NA_REAL;
+          }
           
-        }
-        
-        while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
-          deck.pop_front();
-        }
-        
-        if (width > 1) {
-          idxmax_x = deck.front();
-        } else {
-          idxmax_x = i;
-        }
-        
-      }
-      
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
-        
-        if (n_obs >= min_obs) {
-          rcpp_max[i] = x[idxmax_x];
         } else {
-          rcpp_max[i] = NA_REAL;
+          
+          // can be either NA or NaN
+          arma_mean[i] = x[i];
+          
         }
         
-      } else {
-        
-        // can be either NA or NaN
-        rcpp_max[i] = x[i];
-        
       }
       
     }
-    
   }
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollMaxOfflineVec : public Worker {
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollMeanLinearVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_rows_chunk;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<double> rcpp_max;     // destination (pass by reference)
+  arma::vec& arma_mean;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollMaxOfflineVec(const NumericVector x, const int n,
-                    const int n_rows_x, const int width,
-                    const arma::vec arma_weights, const int min_obs,
-                    const bool na_restore, NumericVector rcpp_max)
+  RollMeanLinearVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int n_rows_chunk,
+                    const int width, const arma::vec arma_weights,
+                    const int min_obs, const bool na_restore,
+                    arma::vec& arma_mean)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_max(rcpp_max) { }
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_mean(arma_mean) { }
   
-  // function call operator that iterates by index
+  // function call operator that iterates by chunk of rows
   void operator()(std::size_t begin_index, std::size_t end_index) {
     for (std::size_t z = begin_index; z < end_index; z++) {
       
-      // from 1D to 2D array
-      int i = z;
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
       
-      int count = 0;
-      int n_obs = 0;
-      int idxmax_x = i;
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double value[1];
+      long double sum[1];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 1, offset,
+                            arma_weights[n - 1], delta);
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+      for (int i = offset; i < end_row; i++) {
         
-        // number of observations is either the window size or,
-        // for partial results, the number of the current row
-        while ((width > count) && (i >= count)) {
-          
-          // don't include if missing value
-          if (!std::isnan(x[i - count])) {
-            
-            // first element of sorted array
-            // note: 'weights' must be greater than 0
-            if (std::isnan(x[idxmax_x]) || (x[i - count] >= x[idxmax_x])) {
-              idxmax_x = i - count;
-            }
-            
-            n_obs += 1;
-            
-          }
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
           
-          count += 1;
+          value[0] = x[i];
+          linear.push_back(i, value);
           
-        }
-        
-        if ((n_obs >= min_obs)) {
-          rcpp_max[i] = x[idxmax_x];
         } else {
-          rcpp_max[i] = NA_REAL;
+          linear.push_back(i, NULL);
         }
         
-      } else {
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
         
-        // can be either NA or NaN
-        rcpp_max[i] = x[i];
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if (n_obs >= min_obs) {
+            arma_mean[i] = sum[0] / sum_w;
+          } else {
+            arma_mean[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_mean[i] = x[i];
+          
+        }
         
       }
       
@@ -1443,59 +1514,151 @@ struct RollMaxOfflineVec : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollIdxMinOnlineVec {
+// 'Worker' function for computing the rolling statistic using the fast Fourier
+// transform, i.e., blocks of 'n_fft' rows that overlap by 'width' - 1 rows are
+// multiplied by the transform of the weights (overlap-save)
+struct RollMeanFFTVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
+  const int n_fft;
   const int width;
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<int> rcpp_idxmin;     // destination (pass by reference)
+  arma::cx_vec arma_weights_fft;
+  arma::vec& arma_mean;         // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMinOnlineVec(const NumericVector x, const int n,
-                      const int n_rows_x, const int width,
-                      const arma::vec arma_weights, const int min_obs,
-                      const bool na_restore, IntegerVector rcpp_idxmin)
+  RollMeanFFTVec(const NumericVector x, const int n,
+                 const int n_rows_x, const int n_fft,
+                 const int width, const arma::vec arma_weights,
+                 const int min_obs, const bool na_restore,
+                 arma::vec& arma_mean)
     : x(x), n(n),
-      n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
-  
-  // function call operator that iterates by index
-  void operator()() {
+      n_rows_x(n_rows_x), n_fft(n_fft),
+      width(width), arma_weights(arma_weights),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_mean(arma_mean) {
     
-    int n_obs = 0;
-    int idxmin_x = 0;
-    std::deque<int> deck(width);
+    // weights by lag (i.e., the current row has the last weight)
+    int n_size_x = std::min(width, n_rows_x);
+    arma::cx_vec arma_lag(n_fft, arma::fill::zeros);
     
-    for (int i = 0; i < n_rows_x; i++) {
-      
-      // expanding window
-      if (i < width) {
-        
-        // don't include if missing value
+    for (int count = 0; count < n_size_x; count++) {
+      arma_lag[count] = arma_weights[n - count - 1];
+    }
+    
+    arma_weights_fft = arma::fft(arma_lag);
+    
+  }
+  
+  // function call operator that iterates by block of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each block includes the previous 'width' - 1 rows
+      int n_size_x = std::min(width, n_rows_x);
+      int n_step = n_fft - n_size_x + 1;
+      int begin_row = z * n_step;
+      int end_row = std::min(begin_row + n_step, n_rows_x);
+      int offset = begin_row - n_size_x + 1;
+      
+      int n_obs = 0;
+      arma::cx_vec arma_block(n_fft, arma::fill::zeros);
+      
+      for (int i = std::max(0, offset); i < std::min(offset + n_fft, n_rows_x); i++) {
+        
+        // don't include if missing value
+        // the weights of the observations are the imaginary part
+        if (!std::isnan(x[i])) {
+          arma_block[i - offset] = std::complex<double>(x[i], 1);
+        }
+        
+      }
+      
+      // number of observations in the window of the previous row
+      for (int i = std::max(0, begin_row - n_size_x); i < begin_row; i++) {
         if (!std::isnan(x[i])) {
           n_obs += 1;
         }
+      }
+      
+      // circular convolution, where the first 'width' - 1 rows wrap around
+      convolve_block(arma_block, arma_weights_fft, arma_weights, n, n_size_x);
+      
+      for (int i = begin_row; i < end_row; i++) {
         
         if (!std::isnan(x[i])) {
+          n_obs += 1;
+        }
+        
+        if ((i >= n_size_x) && !std::isnan(x[i - n_size_x])) {
+          n_obs -= 1;
+        }
+        
+        // don't compute if missing value and 'na_restore' argument is TRUE
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
           
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] < x[deck.back()]))) {
-            deck.pop_back();
+          if (n_obs >= min_obs) {
+            arma_mean[i] = std::real(arma_block[i - offset]) /
+              std::imag(arma_block[i - offset]);
+          } else {
+            arma_mean[i] = NA_REAL;
           }
           
-          deck.push_back(i);
+        } else {
+          
+          // can be either NA or NaN
+          arma_mean[i] = x[i];
           
         }
         
-        if (width > 1) {
-          idxmin_x = deck.front() + 1;
-        } else {
-          idxmin_x = 1;
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollMinOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_min;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMinOnlineVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int width,
+                   const arma::vec arma_weights, const int min_obs,
+                   const bool na_restore, NumericVector rcpp_min)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_min(rcpp_min) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_obs = 0;
+    int idxmin_x = 0;
+    RollMonotonicQueue deck(std::min(width, n_rows_x));
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      if (i < width) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          n_obs += 1;
         }
         
       }
@@ -1514,41 +1677,41 @@ struct RollIdxMinOnlineVec {
           
         }
         
-        if (!std::isnan(x[i])) {
-          
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] < x[deck.back()]))) {
-            deck.pop_back();
-          }
-          
-          deck.push_back(i);
-          
-        }
-        
-        while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
+        // at most one row leaves the window
+        if (!deck.empty() && (deck.front() <= i - width)) {
           deck.pop_front();
         }
         
-        if (width > 1) {
-          idxmin_x = width - (i - deck.front());
-        } else {
-          idxmin_x = 1;
+      }
+      
+      // only valid observations are in the queue
+      if (!std::isnan(x[i])) {
+        
+        while (!deck.empty() && (x[i] < x[deck.back()])) {
+          deck.pop_back();
         }
         
+        deck.push_back(i);
+        
+      }
+      
+      if (!deck.empty()) {
+        idxmin_x = deck.front();
       }
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
         if (n_obs >= min_obs) {
-          rcpp_idxmin[i] = idxmin_x;
+          rcpp_min[i] = x[idxmin_x];
         } else {
-          rcpp_idxmin[i] = NA_INTEGER;
+          rcpp_min[i] = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmin[i] = (int)x[i];
+        rcpp_min[i] = x[i];
         
       }
       
@@ -1559,7 +1722,7 @@ struct RollIdxMinOnlineVec {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollIdxMinOfflineVec : public Worker {
+struct RollMinOfflineVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
@@ -1568,17 +1731,17 @@ struct RollIdxMinOfflineVec : public Worker {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<int> rcpp_idxmin;     // destination (pass by reference)
+  RVector<double> rcpp_min;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMinOfflineVec(const NumericVector x, const int n,
-                       const int n_rows_x, const int width,
-                       const arma::vec arma_weights, const int min_obs,
-                       const bool na_restore, IntegerVector rcpp_idxmin)
+  RollMinOfflineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int width,
+                    const arma::vec arma_weights, const int min_obs,
+                    const bool na_restore, NumericVector rcpp_min)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
+      na_restore(na_restore), rcpp_min(rcpp_min) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1616,21 +1779,15 @@ struct RollIdxMinOfflineVec : public Worker {
         }
         
         if ((n_obs >= min_obs)) {
-          
-          if (i < width) {
-            rcpp_idxmin[i] = idxmin_x + 1;
-          } else if (i >= width) {
-            rcpp_idxmin[i] = width - (i - idxmin_x);
-          }
-          
+          rcpp_min[i] = x[idxmin_x];
         } else {
-          rcpp_idxmin[i] = NA_INTEGER;
+          rcpp_min[i] = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmin[i] = (int)x[i];
+        rcpp_min[i] = x[i];
         
       }
       
@@ -1640,7 +1797,7 @@ struct RollIdxMinOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollIdxMaxOnlineVec {
+struct RollMaxOnlineVec {
   
   const RVector<double> x;      // source
   const int n;
@@ -1649,24 +1806,24 @@ struct RollIdxMaxOnlineVec {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<int> rcpp_idxmax;     // destination (pass by reference)
+  RVector<double> rcpp_max;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMaxOnlineVec(const NumericVector x, const int n,
-                      const int n_rows_x, const int width,
-                      const arma::vec arma_weights, const int min_obs,
-                      const bool na_restore, IntegerVector rcpp_idxmax)
+  RollMaxOnlineVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int width,
+                   const arma::vec arma_weights, const int min_obs,
+                   const bool na_restore, NumericVector rcpp_max)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
+      na_restore(na_restore), rcpp_max(rcpp_max) { }
   
   // function call operator that iterates by index
   void operator()() {
     
     int n_obs = 0;
     int idxmax_x = 0;
-    std::deque<int> deck(width);
+    RollMonotonicQueue deck(std::min(width, n_rows_x));
     
     for (int i = 0; i < n_rows_x; i++) {
       
@@ -1678,22 +1835,6 @@ struct RollIdxMaxOnlineVec {
           n_obs += 1;
         }
         
-        if (!std::isnan(x[i])) {
-          
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] > x[deck.back()]))) {
-            deck.pop_back();
-          }
-          
-          deck.push_back(i);
-          
-        }
-        
-        if (width > 1) {
-          idxmax_x = deck.front() + 1;
-        } else {
-          idxmax_x = 1;
-        }
-        
       }
       
       // rolling window
@@ -1710,41 +1851,41 @@ struct RollIdxMaxOnlineVec {
           
         }
         
-        if (!std::isnan(x[i])) {
-          
-          while (!deck.empty() && (std::isnan(x[deck.back()]) || (x[i] > x[deck.back()]))) {
-            deck.pop_back();
-          }
-          
-          deck.push_back(i);
-          
-        }
-        
-        while (!deck.empty() && (n_obs > 0) && (deck.front() <= i - width)) {
+        // at most one row leaves the window
+        if (!deck.empty() && (deck.front() <= i - width)) {
           deck.pop_front();
         }
         
-        if (width > 1) {
-          idxmax_x = width - (i - deck.front());
-        } else {
-          idxmax_x = 1;
+      }
+      
+      // only valid observations are in the queue
+      if (!std::isnan(x[i])) {
+        
+        while (!deck.empty() && (x[i] > x[deck.back()])) {
+          deck.pop_back();
         }
         
+        deck.push_back(i);
+        
+      }
+      
+      if (!deck.empty()) {
+        idxmax_x = deck.front();
       }
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
         if (n_obs >= min_obs) {
-          rcpp_idxmax[i] = idxmax_x;
+          rcpp_max[i] = x[idxmax_x];
         } else {
-          rcpp_idxmax[i] = NA_INTEGER;
+          rcpp_max[i] = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmax[i] = (int)x[i];
+        rcpp_max[i] = x[i];
         
       }
       
@@ -1755,7 +1896,7 @@ struct RollIdxMaxOnlineVec {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollIdxMaxOfflineVec : public Worker {
+struct RollMaxOfflineVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
@@ -1764,17 +1905,17 @@ struct RollIdxMaxOfflineVec : public Worker {
   const arma::vec arma_weights;
   const int min_obs;
   const bool na_restore;
-  RVector<int> rcpp_idxmax;     // destination (pass by reference)
+  RVector<double> rcpp_max;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollIdxMaxOfflineVec(const NumericVector x, const int n,
-                       const int n_rows_x, const int width,
-                       const arma::vec arma_weights, const int min_obs,
-                       const bool na_restore, IntegerVector rcpp_idxmax)
+  RollMaxOfflineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int width,
+                    const arma::vec arma_weights, const int min_obs,
+                    const bool na_restore, NumericVector rcpp_max)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
       arma_weights(arma_weights), min_obs(min_obs),
-      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
+      na_restore(na_restore), rcpp_max(rcpp_max) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -1812,21 +1953,15 @@ struct RollIdxMaxOfflineVec : public Worker {
         }
         
         if ((n_obs >= min_obs)) {
-          
-          if (i < width) {
-            rcpp_idxmax[i] = idxmax_x + 1;
-          } else if (i >= width) {
-            rcpp_idxmax[i] = width - (i - idxmax_x);
-          }
-          
+          rcpp_max[i] = x[idxmax_x];
         } else {
-          rcpp_idxmax[i] = NA_INTEGER;
+          rcpp_max[i] = NA_REAL;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_idxmax[i] = (int)x[i];
+        rcpp_max[i] = x[i];
         
       }
       
@@ -1835,102 +1970,158 @@ struct RollIdxMaxOfflineVec : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollQuantileOfflineVec : public Worker {
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollIdxMinOnlineVec {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
   const int width;
   const arma::vec arma_weights;
-  const double p;
   const int min_obs;
   const bool na_restore;
-  RVector<double> rcpp_quantile;// destination (pass by reference)
+  RVector<int> rcpp_idxmin;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollQuantileOfflineVec(const NumericVector x, const int n,
-                         const int n_rows_x, const int width,
-                         const arma::vec arma_weights, const double p, 
-                         const int min_obs, const bool na_restore,
-                         NumericVector rcpp_quantile)
+  RollIdxMinOnlineVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, IntegerVector rcpp_idxmin)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), p(p),
-      min_obs(min_obs), na_restore(na_restore),
-      rcpp_quantile(rcpp_quantile) { }
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
   
   // function call operator that iterates by index
-  void operator()(std::size_t begin_index, std::size_t end_index) {
-    for (std::size_t z = begin_index; z < end_index; z++) {
-      
-      // from 1D to 2D array
-      int i = z;
+  void operator()() {
+    
+    int n_obs = 0;
+    int idxmin_x = 0;
+    RollMonotonicQueue deck(std::min(width, n_rows_x));
+    
+    for (int i = 0; i < n_rows_x; i++) {
       
-      // don't compute if missing value and 'na_restore' argument is TRUE
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
-        
-        int k = 0;
-        int count = 0;
-        long double sum_w = 0;
-        
-        int offset = std::max(0, i - width + 1);
-        int n_size_x = i - offset + 1;
-        arma::vec x_subset(n_size_x);
-        arma::vec arma_weights_subset(n_size_x);
+      // expanding window
+      if (i < width) {
         
-        std::copy(x.begin() + offset, x.begin() + i + 1,
-                  x_subset.begin());
-        std::copy(arma_weights.begin() + n - n_size_x, arma_weights.begin() + n,
-                  arma_weights_subset.begin());
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          n_obs += 1;
+        }
         
-        // similar to R's sort with 'index.return = TRUE'
-        arma::ivec sort_ix = stl_sort_index(x_subset);
+      }
+      
+      // rolling window
+      if (i >= width) {
         
-        // number of observations is either the window size or,
-        // for partial results, the number of the current row
-        while ((width > count) && (n_size_x - 1 >= count)) {
+        // don't include if missing value
+        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
           
-          k = sort_ix[n_size_x - count - 1];
+          n_obs += 1;
           
-          // don't include if missing value
-          if (!std::isnan(x_subset[k])) {
-            
-            // compute the sum
-            sum_w += arma_weights_subset[k];
-            
-          }
+        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
           
-          count += 1;
+          n_obs -= 1;
           
         }
         
-        count = 0;
-        int n_obs = 0;
-        int idxquantile_x = 0;
-        bool status = false;
-        long double sum_upper_w = 0;
-        long double sum_upper_w_temp = 0;
+        // at most one row leaves the window
+        if (!deck.empty() && (deck.front() <= i - width)) {
+          deck.pop_front();
+        }
+        
+      }
+      
+      // only valid observations are in the queue
+      if (!std::isnan(x[i])) {
+        
+        while (!deck.empty() && (x[i] < x[deck.back()])) {
+          deck.pop_back();
+        }
+        
+        deck.push_back(i);
+        
+      }
+      
+      if (!deck.empty()) {
+        
+        if (i < width) {
+          idxmin_x = deck.front() + 1;
+        } else {
+          idxmin_x = width - (i - deck.front());
+        }
+        
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (n_obs >= min_obs) {
+          rcpp_idxmin[i] = idxmin_x;
+        } else {
+          rcpp_idxmin[i] = NA_INTEGER;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_idxmin[i] = (int)x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollIdxMinOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  RVector<int> rcpp_idxmin;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxMinOfflineVec(const NumericVector x, const int n,
+                       const int n_rows_x, const int width,
+                       const arma::vec arma_weights, const int min_obs,
+                       const bool na_restore, IntegerVector rcpp_idxmin)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_idxmin(rcpp_idxmin) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      int count = 0;
+      int n_obs = 0;
+      int idxmin_x = i;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
         // number of observations is either the window size or,
         // for partial results, the number of the current row
-        while ((width > count) && (n_size_x - 1 >= count)) {
-          
-          k = sort_ix[n_size_x - count - 1];
+        while ((width > count) && (i >= count)) {
           
           // don't include if missing value
-          if (!std::isnan(x_subset[k])) {
-            
-            sum_upper_w += arma_weights_subset[k];
+          if (!std::isnan(x[i - count])) {
             
-            // last element of sorted array that is 'p' of 'weights'
+            // last element of sorted array
             // note: 'weights' must be greater than 0
-            if (!status && (sum_upper_w / sum_w >= p)) {
-              
-              status = true;
-              idxquantile_x = n_size_x - count - 1;
-              sum_upper_w_temp = sum_upper_w;
-              
+            if (std::isnan(x[idxmin_x]) || (x[i - count] <= x[idxmin_x])) {
+              idxmin_x = i - count;
             }
             
             n_obs += 1;
@@ -1943,26 +2134,20 @@ struct RollQuantileOfflineVec : public Worker {
         
         if ((n_obs >= min_obs)) {
           
-          k = sort_ix[idxquantile_x];
-          
-          // average if upper and lower weight is equal
-          if (std::fabs(sum_upper_w_temp / sum_w - p) <= sqrt(arma::datum::eps)) {
-            
-            int k_lower = sort_ix[idxquantile_x - 1];
-            rcpp_quantile[i] = (x_subset[k] + x_subset[k_lower]) / 2;
-            
-          } else {
-            rcpp_quantile[i] = x_subset[k];
+          if (i < width) {
+            rcpp_idxmin[i] = idxmin_x + 1;
+          } else if (i >= width) {
+            rcpp_idxmin[i] = width - (i - idxmin_x);
           }
           
         } else {
-          rcpp_quantile[i] = NA_REAL;
+          rcpp_idxmin[i] = NA_INTEGER;
         }
         
       } else {
         
         // can be either NA or NaN
-        rcpp_quantile[i] = x[i];
+        rcpp_idxmin[i] = (int)x[i];
         
       }
       
@@ -1972,66 +2157,36 @@ struct RollQuantileOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollVarOnlineVec {
+struct RollIdxMaxOnlineVec {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
   const int width;
   const arma::vec arma_weights;
-  const bool center;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_var;          // destination (pass by reference)
+  RVector<int> rcpp_idxmax;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollVarOnlineVec(const NumericVector x, const int n,
-                   const int n_rows_x, const int width,
-                   const arma::vec arma_weights, const bool center,
-                   const int min_obs, const bool na_restore,
-                   arma::vec& arma_var)
+  RollIdxMaxOnlineVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, IntegerVector rcpp_idxmax)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), center(center),
-      min_obs(min_obs), na_restore(na_restore),
-      arma_var(arma_var) { }
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
   
   // function call operator that iterates by index
   void operator()() {
     
     int n_obs = 0;
-    long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0; 
-    long double x_new = 0;
-    long double x_old = 0;
-    long double sum_w = 0;
-    long double sum_x = 0;
-    long double sumsq_w = 0;
-    long double sumsq_x = 0;
-    long double mean_prev_x = 0;
-    long double mean_x = 0;
-    
-    if (width > 1) {
-      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-    } else {
-      lambda = arma_weights[n - 1];
-    }
+    int idxmax_x = 0;
+    RollMonotonicQueue deck(std::min(width, n_rows_x));
     
     for (int i = 0; i < n_rows_x; i++) {
       
-      if (std::isnan(x[i])) {
-        
-        w_new = 0;
-        x_new = 0;
-        
-      } else {
-        
-        w_new = arma_weights[n - 1];
-        x_new = x[i];
-        
-      }
-      
       // expanding window
       if (i < width) {
         
@@ -2040,44 +2195,6 @@ struct RollVarOnlineVec {
           n_obs += 1;
         }
         
-        if (width > 1) {
-          
-          sum_w = lambda * sum_w + w_new;
-          sum_x = lambda * sum_x + w_new * x_new;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
-          
-        } else {
-          
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
-          
-        }
-        
-        if (center && (n_obs > 0)) {
-          
-          // compute the mean
-          mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
-          
-        }
-        
-        // compute the sum of squares
-        if (!std::isnan(x[i]) && (n_obs > 1)) {
-          
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-          
-        } else if (std::isnan(x[i])) {
-          
-          sumsq_x = lambda * sumsq_x;
-          
-        } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
-          
-          sumsq_x = w_new * pow(x_new, (long double)2.0);
-          
-        }
-        
       }
       
       // rolling window
@@ -2094,79 +2211,47 @@ struct RollVarOnlineVec {
           
         }
         
-        if (std::isnan(x[i - width])) {
-          
-          w_old = 0;
-          x_old = 0;
-          
-        } else {
-          
-          w_old = arma_weights[n - width];
-          x_old = x[i - width];
-          
+        // at most one row leaves the window
+        if (!deck.empty() && (deck.front() <= i - width)) {
+          deck.pop_front();
         }
         
-        if (width > 1) {
-          
-          sum_w = lambda * sum_w + w_new - lambda * w_old;
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-            pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
-          
-        } else {
-          
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
-          
-        }
+      }
+      
+      // only valid observations are in the queue
+      if (!std::isnan(x[i])) {
         
-        if (center && (n_obs > 0)) {
-          
-          // compute the mean
-          mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
-          
+        while (!deck.empty() && (x[i] > x[deck.back()])) {
+          deck.pop_back();
         }
         
-        // compute the sum of squares
-        if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-          
-        } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-          
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-          
-        } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x;
-          
-        }
+        deck.push_back(i);
         
       }
       
-      // don't compute if missing value
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+      if (!deck.empty()) {
         
-        if ((n_obs > 1) && (n_obs >= min_obs)) {
-          arma_var[i] = sumsq_x / (sum_w - sumsq_w / sum_w);
+        if (i < width) {
+          idxmax_x = deck.front() + 1;
         } else {
-          arma_var[i] = NA_REAL;
+          idxmax_x = width - (i - deck.front());
         }
         
-      } else {
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (n_obs >= min_obs) {
+          rcpp_idxmax[i] = idxmax_x;
+        } else {
+          rcpp_idxmax[i] = NA_INTEGER;
+        }
+        
+      } else {
         
         // can be either NA or NaN
-        arma_var[i] = x[i];
+        rcpp_idxmax[i] = (int)x[i];
         
       }
       
@@ -2177,29 +2262,26 @@ struct RollVarOnlineVec {
 };
 
 // 'Worker' function for computing the rolling statistic using an offline algorithm
-struct RollVarOfflineVec : public Worker {
+struct RollIdxMaxOfflineVec : public Worker {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
   const int width;
   const arma::vec arma_weights;
-  const bool center;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_var;          // destination (pass by reference)
+  RVector<int> rcpp_idxmax;     // destination (pass by reference)
   
   // initialize with source and destination
-  RollVarOfflineVec(const NumericVector x, const int n,
-                    const int n_rows_x, const int width,
-                    const arma::vec arma_weights, const bool center,
-                    const int min_obs, const bool na_restore,
-                    arma::vec& arma_var)
+  RollIdxMaxOfflineVec(const NumericVector x, const int n,
+                       const int n_rows_x, const int width,
+                       const arma::vec arma_weights, const int min_obs,
+                       const bool na_restore, IntegerVector rcpp_idxmax)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), center(center),
-      min_obs(min_obs), na_restore(na_restore),
-      arma_var(arma_var) { }
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_idxmax(rcpp_idxmax) { }
   
   // function call operator that iterates by index
   void operator()(std::size_t begin_index, std::size_t end_index) {
@@ -2208,45 +2290,13 @@ struct RollVarOfflineVec : public Worker {
       // from 1D to 2D array
       int i = z;
       
-      long double mean_x = 0;
+      int count = 0;
+      int n_obs = 0;
+      int idxmax_x = i;
       
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
-        if (center) {
-          
-          int count = 0;
-          long double sum_w = 0;
-          long double sum_x = 0;
-          
-          // number of observations is either the window size or,
-          // for partial results, the number of the current row
-          while ((width > count) && (i >= count)) {
-            
-            // don't include if missing value
-            if (!std::isnan(x[i - count])) {
-              
-              // compute the sum
-              sum_w += arma_weights[n - count - 1];
-              sum_x += arma_weights[n - count - 1] * x[i - count];
-              
-            }
-            
-            count += 1;
-            
-          }
-          
-          // compute the mean
-          mean_x = sum_x / sum_w;
-          
-        }
-        
-        int count = 0;
-        int n_obs = 0;
-        long double sum_w = 0;
-        long double sumsq_w = 0;
-        long double sumsq_x = 0;
-        
         // number of observations is either the window size or,
         // for partial results, the number of the current row
         while ((width > count) && (i >= count)) {
@@ -2254,16 +2304,10 @@ struct RollVarOfflineVec : public Worker {
           // don't include if missing value
           if (!std::isnan(x[i - count])) {
             
-            sum_w += arma_weights[n - count - 1];
-            sumsq_w += pow(arma_weights[n - count - 1], 2.0);
-            
-            // compute the sum of squares with 'center' argument
-            if (center) {
-              sumsq_x += arma_weights[n - count - 1] *
-                pow(x[i - count] - mean_x, (long double)2.0);
-            } else if (!center) {
-              sumsq_x += arma_weights[n - count - 1] *
-                pow(x[i - count], 2.0);
+            // first element of sorted array
+            // note: 'weights' must be greater than 0
+            if (std::isnan(x[idxmax_x]) || (x[i - count] >= x[idxmax_x])) {
+              idxmax_x = i - count;
             }
             
             n_obs += 1;
@@ -2274,16 +2318,22 @@ struct RollVarOfflineVec : public Worker {
           
         }
         
-        if ((n_obs > 1) && (n_obs >= min_obs)) {
-          arma_var[i] = sumsq_x / (sum_w - sumsq_w / sum_w);
+        if ((n_obs >= min_obs)) {
+          
+          if (i < width) {
+            rcpp_idxmax[i] = idxmax_x + 1;
+          } else if (i >= width) {
+            rcpp_idxmax[i] = width - (i - idxmax_x);
+          }
+          
         } else {
-          arma_var[i] = NA_REAL;
+          rcpp_idxmax[i] = NA_INTEGER;
         }
         
       } else {
         
         // can be either NA or NaN
-        arma_var[i] = x[i];
+        rcpp_idxmax[i] = (int)x[i];
         
       }
       
@@ -2292,68 +2342,56 @@ struct RollVarOfflineVec : public Worker {
   
 };
 
-// 'Worker' function for computing the rolling statistic using an online algorithm
-struct RollSdOnlineVec {
+// 'Worker' function for computing the rolling statistics using an online algorithm
+struct RollRangeOnlineVec {
   
   const RVector<double> x;      // source
   const int n;
   const int n_rows_x;
   const int width;
   const arma::vec arma_weights;
-  const bool center;
   const int min_obs;
   const bool na_restore;
-  arma::vec& arma_sd;          // destination (pass by reference)
+  const bool status_min;
+  const bool status_max;
+  const bool status_idxmin;
+  const bool status_idxmax;
+  RVector<double> rcpp_min;     // destination (pass by reference)
+  RVector<double> rcpp_max;
+  RVector<int> rcpp_idxmin;
+  RVector<int> rcpp_idxmax;
   
   // initialize with source and destination
-  RollSdOnlineVec(const NumericVector x, const int n,
-                  const int n_rows_x, const int width,
-                  const arma::vec arma_weights, const bool center,
-                  const int min_obs, const bool na_restore,
-                  arma::vec& arma_sd)
+  RollRangeOnlineVec(const NumericVector x, const int n,
+                     const int n_rows_x, const int width,
+                     const arma::vec arma_weights, const int min_obs,
+                     const bool na_restore, const bool status_min,
+                     const bool status_max, const bool status_idxmin,
+                     const bool status_idxmax, NumericVector rcpp_min,
+                     NumericVector rcpp_max, IntegerVector rcpp_idxmin,
+                     IntegerVector rcpp_idxmax)
     : x(x), n(n),
       n_rows_x(n_rows_x), width(width),
-      arma_weights(arma_weights), center(center),
-      min_obs(min_obs), na_restore(na_restore),
-      arma_sd(arma_sd) { }
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), status_min(status_min),
+      status_max(status_max), status_idxmin(status_idxmin),
+      status_idxmax(status_idxmax), rcpp_min(rcpp_min),
+      rcpp_max(rcpp_max), rcpp_idxmin(rcpp_idxmin),
+      rcpp_idxmax(rcpp_idxmax) { }
   
   // function call operator that iterates by index
   void operator()() {
     
-    int n_obs = 0;
-    long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0; 
-    long double x_new = 0;
-    long double x_old = 0;
-    long double sum_w = 0;
-    long double sum_x = 0;
-    long double sumsq_w = 0;
-    long double sumsq_x = 0;
-    long double mean_prev_x = 0;
-    long double mean_x = 0;
-    long double var_x = 0;
+    // only the queues of the requested statistics are updated
+    bool status_deck_min = status_min || status_idxmin;
+    bool status_deck_max = status_max || status_idxmax;
     
-    if (width > 1) {
-      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
-    } else {
-      lambda = arma_weights[n - 1];
-    }
+    int n_obs = 0;
+    RollMonotonicQueue deck_min(std::min(width, n_rows_x));
+    RollMonotonicQueue deck_max(std::min(width, n_rows_x));
     
     for (int i = 0; i < n_rows_x; i++) {
       
-      if (std::isnan(x[i])) {
-        
-        w_new = 0;
-        x_new = 0;
-        
-      } else {
-        
-        w_new = arma_weights[n - 1];
-        x_new = x[i];
-        
-      }
-      
       // expanding window
       if (i < width) {
         
@@ -2362,148 +2400,3126 @@ struct RollSdOnlineVec {
           n_obs += 1;
         }
         
-        if (width > 1) {
+      }
+      
+      // rolling window
+      if (i >= width) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
           
-          sum_w = lambda * sum_w + w_new;
-          sum_x = lambda * sum_x + w_new * x_new;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+          n_obs += 1;
           
-        } else {
+        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          n_obs -= 1;
           
         }
         
-        if (center && (n_obs > 0)) {
-          
-          // compute the mean
-          mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
-          
+        // at most one row leaves the window
+        if (!deck_min.empty() && (deck_min.front() <= i - width)) {
+          deck_min.pop_front();
         }
         
-        // compute the sum of squares
-        if (!std::isnan(x[i]) && (n_obs > 1)) {
+        if (!deck_max.empty() && (deck_max.front() <= i - width)) {
+          deck_max.pop_front();
+        }
+        
+      }
+      
+      // only valid observations are in the queues
+      if (!std::isnan(x[i])) {
+        
+        if (status_deck_min) {
           
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+          while (!deck_min.empty() && (x[i] < x[deck_min.back()])) {
+            deck_min.pop_back();
+          }
           
-        } else if (std::isnan(x[i])) {
+          deck_min.push_back(i);
           
-          sumsq_x = lambda * sumsq_x;
+        }
+        
+        if (status_deck_max) {
           
-        } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
+          while (!deck_max.empty() && (x[i] > x[deck_max.back()])) {
+            deck_max.pop_back();
+          }
           
-          sumsq_x = w_new * pow(x_new, (long double)2.0);
+          deck_max.push_back(i);
           
         }
         
-        var_x = sumsq_x / (sum_w - sumsq_w / sum_w);
-        
       }
       
-      // rolling window
-      if (i >= width) {
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
-        // don't include if missing value
-        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
-          
-          n_obs += 1;
+        // first row of the window
+        int offset = std::max(0, i - width + 1);
+        
+        if (n_obs >= min_obs) {
           
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+          if (status_min) {
+            rcpp_min[i] = x[deck_min.front()];
+          }
           
-          n_obs -= 1;
+          if (status_max) {
+            rcpp_max[i] = x[deck_max.front()];
+          }
           
-        }
-        
-        if (std::isnan(x[i - width])) {
+          if (status_idxmin) {
+            rcpp_idxmin[i] = deck_min.front() - offset + 1;
+          }
           
-          w_old = 0;
-          x_old = 0;
+          if (status_idxmax) {
+            rcpp_idxmax[i] = deck_max.front() - offset + 1;
+          }
           
         } else {
           
-          w_old = arma_weights[n - width];
-          x_old = x[i - width];
-          
-        }
-        
-        if (width > 1) {
+          if (status_min) {
+            rcpp_min[i] = NA_REAL;
+          }
           
-          sum_w = lambda * sum_w + w_new - lambda * w_old;
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-            pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+          if (status_max) {
+            rcpp_max[i] = NA_REAL;
+          }
           
-        } else {
+          if (status_idxmin) {
+            rcpp_idxmin[i] = NA_INTEGER;
+          }
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          if (status_idxmax) {
+            rcpp_idxmax[i] = NA_INTEGER;
+          }
           
         }
         
-        if (center && (n_obs > 0)) {
+      } else {
+        
+        // can be either NA or NaN
+        if (status_min) {
+          rcpp_min[i] = x[i];
+        }
+        
+        if (status_max) {
+          rcpp_max[i] = x[i];
+        }
+        
+        if (status_idxmin) {
+          rcpp_idxmin[i] = (int)x[i];
+        }
+        
+        if (status_idxmax) {
+          rcpp_idxmax[i] = (int)x[i];
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistics using an offline algorithm
+struct RollRangeOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  const bool status_min;
+  const bool status_max;
+  const bool status_idxmin;
+  const bool status_idxmax;
+  RVector<double> rcpp_min;     // destination (pass by reference)
+  RVector<double> rcpp_max;
+  RVector<int> rcpp_idxmin;
+  RVector<int> rcpp_idxmax;
+  
+  // initialize with source and destination
+  RollRangeOfflineVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, const bool status_min,
+                      const bool status_max, const bool status_idxmin,
+                      const bool status_idxmax, NumericVector rcpp_min,
+                      NumericVector rcpp_max, IntegerVector rcpp_idxmin,
+                      IntegerVector rcpp_idxmax)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), status_min(status_min),
+      status_max(status_max), status_idxmin(status_idxmin),
+      status_idxmax(status_idxmax), rcpp_min(rcpp_min),
+      rcpp_max(rcpp_max), rcpp_idxmin(rcpp_idxmin),
+      rcpp_idxmax(rcpp_idxmax) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      int count = 0;
+      int n_obs = 0;
+      int idxmin_x = i;
+      int idxmax_x = i;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (i >= count)) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i - count])) {
+            
+            // first and last elements of sorted array
+            if (std::isnan(x[idxmin_x]) || (x[i - count] <= x[idxmin_x])) {
+              idxmin_x = i - count;
+            }
+            
+            if (std::isnan(x[idxmax_x]) || (x[i - count] >= x[idxmax_x])) {
+              idxmax_x = i - count;
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        // first row of the window
+        int offset = std::max(0, i - width + 1);
+        
+        if (n_obs >= min_obs) {
+          
+          if (status_min) {
+            rcpp_min[i] = x[idxmin_x];
+          }
+          
+          if (status_max) {
+            rcpp_max[i] = x[idxmax_x];
+          }
+          
+          if (status_idxmin) {
+            rcpp_idxmin[i] = idxmin_x - offset + 1;
+          }
+          
+          if (status_idxmax) {
+            rcpp_idxmax[i] = idxmax_x - offset + 1;
+          }
+          
+        } else {
+          
+          if (status_min) {
+            rcpp_min[i] = NA_REAL;
+          }
+          
+          if (status_max) {
+            rcpp_max[i] = NA_REAL;
+          }
+          
+          if (status_idxmin) {
+            rcpp_idxmin[i] = NA_INTEGER;
+          }
+          
+          if (status_idxmax) {
+            rcpp_idxmax[i] = NA_INTEGER;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        if (status_min) {
+          rcpp_min[i] = x[i];
+        }
+        
+        if (status_max) {
+          rcpp_max[i] = x[i];
+        }
+        
+        if (status_idxmin) {
+          rcpp_idxmin[i] = (int)x[i];
+        }
+        
+        if (status_idxmax) {
+          rcpp_idxmax[i] = (int)x[i];
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollDrawdownOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool runup;
+  const bool index;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_drawdown;     // destination (pass by reference)
+  RVector<int> rcpp_peak;
+  RVector<int> rcpp_trough;
+  
+  // initialize with source and destination
+  RollDrawdownOnlineVec(const NumericVector x, const int n,
+                        const int n_rows_x, const int width,
+                        const arma::vec arma_weights, const bool runup,
+                        const bool index, const int min_obs,
+                        const bool na_restore, NumericVector rcpp_drawdown,
+                        IntegerVector rcpp_peak, IntegerVector rcpp_trough)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), runup(runup),
+      index(index), min_obs(min_obs),
+      na_restore(na_restore), rcpp_drawdown(rcpp_drawdown),
+      rcpp_peak(rcpp_peak), rcpp_trough(rcpp_trough) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_obs = 0;
+    RollTwoStacks<RollDrawdownMonoid> queue(std::min(width, n_rows_x));
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      if (i < width) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          n_obs += 1;
+        }
+        
+      }
+      
+      // rolling window
+      if (i >= width) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+          
+          n_obs += 1;
+          
+        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+          
+          n_obs -= 1;
+          
+        }
+        
+        // at most one row leaves the window
+        if (!queue.empty() && (queue.row() <= i - width)) {
+          queue.pop_front();
+        }
+        
+      }
+      
+      // run-up is the drawdown of the negative values
+      if (!std::isnan(x[i])) {
+        
+        if (runup) {
+          queue.push_back(RollDrawdownMonoid::single(-x[i], i), i);
+        } else {
+          queue.push_back(RollDrawdownMonoid::single(x[i], i), i);
+        }
+        
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (n_obs >= min_obs) {
+          
+          RollDrawdownMonoid::Entry entry = queue.query();
+          rcpp_drawdown[i] = entry.drawdown;
+          
+          if (index) {
+            
+            // first row of the window
+            int offset = std::max(0, i - width + 1);
+            
+            if (runup) {
+              
+              rcpp_peak[i] = entry.trough - offset + 1;
+              rcpp_trough[i] = entry.peak - offset + 1;
+              
+            } else {
+              
+              rcpp_peak[i] = entry.peak - offset + 1;
+              rcpp_trough[i] = entry.trough - offset + 1;
+              
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_drawdown[i] = NA_REAL;
+          
+          if (index) {
+            
+            rcpp_peak[i] = NA_INTEGER;
+            rcpp_trough[i] = NA_INTEGER;
+            
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_drawdown[i] = x[i];
+        
+        if (index) {
+          
+          rcpp_peak[i] = (int)x[i];
+          rcpp_trough[i] = (int)x[i];
+          
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollDrawdownOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool runup;
+  const bool index;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_drawdown;     // destination (pass by reference)
+  RVector<int> rcpp_peak;
+  RVector<int> rcpp_trough;
+  
+  // initialize with source and destination
+  RollDrawdownOfflineVec(const NumericVector x, const int n,
+                         const int n_rows_x, const int width,
+                         const arma::vec arma_weights, const bool runup,
+                         const bool index, const int min_obs,
+                         const bool na_restore, NumericVector rcpp_drawdown,
+                         IntegerVector rcpp_peak, IntegerVector rcpp_trough)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), runup(runup),
+      index(index), min_obs(min_obs),
+      na_restore(na_restore), rcpp_drawdown(rcpp_drawdown),
+      rcpp_peak(rcpp_peak), rcpp_trough(rcpp_trough) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // first row of the window
+      int offset = std::max(0, i - width + 1);
+      
+      int n_obs = 0;
+      int idxmax_x = offset;
+      int peak_x = offset;
+      int trough_x = offset;
+      double max_x = 0;
+      double drawdown_x = 0;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        // run-up is the drawdown of the negative values, where each row is
+        // a trough of the running maximum (i.e., the peak)
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[k])) {
+            
+            double value = runup ? -x[k] : x[k];
+            
+            if ((n_obs == 0) || (value > max_x)) {
+              
+              max_x = value;
+              idxmax_x = k;
+              
+            }
+            
+            if ((n_obs == 0) || (max_x - value > drawdown_x)) {
+              
+              drawdown_x = max_x - value;
+              peak_x = idxmax_x;
+              trough_x = k;
+              
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          
+          rcpp_drawdown[i] = drawdown_x;
+          
+          if (index) {
+            
+            if (runup) {
+              
+              rcpp_peak[i] = trough_x - offset + 1;
+              rcpp_trough[i] = peak_x - offset + 1;
+              
+            } else {
+              
+              rcpp_peak[i] = peak_x - offset + 1;
+              rcpp_trough[i] = trough_x - offset + 1;
+              
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_drawdown[i] = NA_REAL;
+          
+          if (index) {
+            
+            rcpp_peak[i] = NA_INTEGER;
+            rcpp_trough[i] = NA_INTEGER;
+            
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_drawdown[i] = x[i];
+        
+        if (index) {
+          
+          rcpp_peak[i] = (int)x[i];
+          rcpp_trough[i] = (int)x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollIdxQuantileOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const bool na_restore;
+  RVector<int> rcpp_idxquantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxQuantileOnlineVec(const NumericVector x, const int n,
+                           const int n_rows_x, const int width,
+                           const arma::vec arma_weights, const double p,
+                           const int min_obs, const bool na_restore,
+                           IntegerVector rcpp_idxquantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), p(p),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_idxquantile(rcpp_idxquantile) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double lambda = 1;
+    long double w_new = 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    if ((width > 1) && (n > 1)) {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    RollOrderTree tree(n_rows_x, lambda != 1);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // weight of the new row relative to the first row
+      // note: only the ratio of weights is required for the quantile
+      if (i > 0) {
+        w_new = w_new / lambda;
+      }
+      
+      // rescale the frame by a power of two to avoid overflow or underflow
+      if ((w_new > w_max) || (w_new < 1 / w_max)) {
+        
+        long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+        
+        tree.scale(scale);
+        
+        for (int k = 0; k < n_ring; k++) {
+          w_x[k] *= scale;
+        }
+        
+        w_new *= scale;
+        
+      }
+      
+      w_x[i % n_ring] = w_new;
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i], w_new);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (tree.n_obs >= min_obs) {
+          
+          bool status_avg = false;
+          int k = tree.quantile(p, status_avg);
+          
+          // lower observation if upper and lower weight is equal
+          if (status_avg && (k > 0)) {
+            k -= 1;
+          }
+          
+          rcpp_idxquantile[i] = rank_ix[tree.select(k)] - std::max(0, i - width + 1) + 1;
+          
+        } else {
+          rcpp_idxquantile[i] = NA_INTEGER;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_idxquantile[i] = (int)x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollIdxQuantileOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const bool na_restore;
+  RVector<int> rcpp_idxquantile;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollIdxQuantileOfflineVec(const NumericVector x, const int n,
+                            const int n_rows_x, const int width,
+                            const arma::vec arma_weights, const double p,
+                            const int min_obs, const bool na_restore,
+                            IntegerVector rcpp_idxquantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), p(p),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_idxquantile(rcpp_idxquantile) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        int n_obs = 0;
+        long double sum_w = 0;
+        long double sum_upper_w = 0;
+        
+        int offset = std::max(0, i - width + 1);
+        int n_size_x = i - offset + 1;
+        std::vector<int> rank_x(n_size_x);
+        std::vector<int> sort_ix(n_size_x);
+        
+        // similar to R's sort with 'index.return = TRUE' and ties by row
+        rank_index(x.begin() + offset, n_size_x, rank_x, sort_ix);
+        
+        for (int count = n_size_x - 1; count >= 0; count--) {
+          
+          int k = sort_ix[count];
+          
+          // don't include if missing value
+          if (!std::isnan(x[offset + k])) {
+            
+            // compute the sum
+            sum_w += arma_weights[n - n_size_x + k];
+            n_obs += 1;
+            
+          }
+          
+        }
+        
+        if (n_obs >= min_obs) {
+          
+          int idxquantile_x = 0;
+          long double sum_upper_w_temp = 0;
+          
+          // last element of sorted array that is 'p' of 'weights'
+          // note: 'weights' must be greater than 0
+          for (int count = n_size_x - 1; count >= 0; count--) {
+            
+            int k = sort_ix[count];
+            
+            if (!std::isnan(x[offset + k])) {
+              
+              sum_upper_w += arma_weights[n - n_size_x + k];
+              
+              if (sum_upper_w / sum_w >= p) {
+                
+                idxquantile_x = count;
+                sum_upper_w_temp = sum_upper_w;
+                break;
+                
+              }
+              
+            }
+            
+          }
+          
+          // lower observation if upper and lower weight is equal
+          if ((idxquantile_x > 0) &&
+              (std::fabs(sum_upper_w_temp / sum_w - p) <= sqrt(arma::datum::eps))) {
+            idxquantile_x -= 1;
+          }
+          
+          rcpp_idxquantile[i] = sort_ix[idxquantile_x] + 1;
+          
+        } else {
+          rcpp_idxquantile[i] = NA_INTEGER;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_idxquantile[i] = (int)x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollMedianOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_median;  // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollMedianOnlineVec(const NumericVector x, const int n,
+                      const int n_rows_x, const int width,
+                      const arma::vec arma_weights, const int min_obs,
+                      const bool na_restore, NumericVector rcpp_median)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), min_obs(min_obs),
+      na_restore(na_restore), rcpp_median(rcpp_median) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    RollMedianHeap heap;
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        heap.insert(x[i], i);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        heap.erase(x[i - width], i - width);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (heap.n_obs() >= min_obs) {
+          rcpp_median[i] = heap.median();
+        } else {
+          rcpp_median[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_median[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollQuantileOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const bool na_restore;
+  arma::mat& arma_quantile;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileOnlineVec(const NumericVector x, const int n,
+                        const int n_rows_x, const int width,
+                        const arma::vec arma_weights, const arma::vec arma_p,
+                        const int min_obs, const bool na_restore,
+                        arma::mat& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), arma_p(arma_p),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_p = arma_p.size();
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double lambda = 1;
+    long double w_new = 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    if ((width > 1) && (n > 1)) {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    RollOrderTree tree(n_rows_x, lambda != 1);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // weight of the new row relative to the first row
+      // note: only the ratio of weights is required for the quantile
+      if (i > 0) {
+        w_new = w_new / lambda;
+      }
+      
+      // rescale the frame by a power of two to avoid overflow or underflow
+      if ((w_new > w_max) || (w_new < 1 / w_max)) {
+        
+        long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+        
+        tree.scale(scale);
+        
+        for (int k = 0; k < n_ring; k++) {
+          w_x[k] *= scale;
+        }
+        
+        w_new *= scale;
+        
+      }
+      
+      w_x[i % n_ring] = w_new;
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i], w_new);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (tree.n_obs >= min_obs) {
+          
+          // each probability is answered from the same tree
+          for (int l = 0; l < n_p; l++) {
+            
+            bool status_avg = false;
+            int k = tree.quantile(arma_p[l], status_avg);
+            
+            // average if upper and lower weight is equal
+            if (status_avg && (k > 0)) {
+              arma_quantile(i, l) = (x[rank_ix[tree.select(k)]] +
+                x[rank_ix[tree.select(k - 1)]]) / 2;
+            } else {
+              arma_quantile(i, l) = x[rank_ix[tree.select(k)]];
+            }
+            
+          }
+          
+        } else {
+          
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, l) = NA_REAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        for (int l = 0; l < n_p; l++) {
+          arma_quantile(i, l) = x[i];
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a sorted window
+struct RollQuantileSortedVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const bool na_restore;
+  arma::mat& arma_quantile;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileSortedVec(const NumericVector x, const int n,
+                        const int n_rows_x, const int width,
+                        const arma::vec arma_weights, const arma::vec arma_p,
+                        const int min_obs, const bool na_restore,
+                        arma::mat& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), arma_p(arma_p),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_p = arma_p.size();
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    RollSortedWindow sorted(std::min(width, n_rows_x));
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        sorted.insert(x[i], i);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        sorted.erase(x[i - width], i - width);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        int n_obs = sorted.n_obs();
+        
+        if (n_obs >= min_obs) {
+          
+          long double sum_w = 0;
+          
+          // weight of each observation is by row within the window
+          if (!status_eq) {
+            for (int k = n_obs - 1; k >= 0; k--) {
+              sum_w += arma_weights[n - 1 - i + sorted.window[k].row];
+            }
+          }
+          
+          // each probability is answered from the same sorted window
+          for (int l = 0; l < n_p; l++) {
+            
+            int k = 0;
+            bool status_avg = false;
+            
+            if (status_eq) {
+              k = n_obs - quantile_upper(n_obs, arma_p[l], status_avg);
+            } else {
+              
+              long double sum_upper_w = 0;
+              
+              // last element of sorted array that is 'p' of 'weights'
+              for (int k_upper = n_obs - 1; k_upper >= 0; k_upper--) {
+                
+                sum_upper_w += arma_weights[n - 1 - i + sorted.window[k_upper].row];
+                
+                if (sum_upper_w / sum_w >= arma_p[l]) {
+                  
+                  k = k_upper;
+                  status_avg = std::fabs(sum_upper_w / sum_w - arma_p[l]) <= sqrt(arma::datum::eps);
+                  break;
+                  
+                }
+                
+              }
+              
+            }
+            
+            // average if upper and lower weight is equal
+            if (status_avg && (k > 0)) {
+              arma_quantile(i, l) = (sorted.window[k].value + sorted.window[k - 1].value) / 2;
+            } else {
+              arma_quantile(i, l) = sorted.window[k].value;
+            }
+            
+          }
+          
+        } else {
+          
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, l) = NA_REAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        for (int l = 0; l < n_p; l++) {
+          arma_quantile(i, l) = x[i];
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the expanding statistic using an approximate online algorithm
+struct RollQuantileSketchVec {
+  
+  const RVector<double> x;      // source
+  const int n_rows_x;
+  const arma::vec arma_p;
+  const double error;
+  const int min_obs;
+  const bool na_restore;
+  arma::mat& arma_quantile;     // destination (pass by reference)
+  arma::vec& arma_error;
+  
+  // initialize with source and destination
+  RollQuantileSketchVec(const NumericVector x, const int n_rows_x,
+                        const arma::vec arma_p, const double error,
+                        const int min_obs, const bool na_restore,
+                        arma::mat& arma_quantile, arma::vec& arma_error)
+    : x(x), n_rows_x(n_rows_x),
+      arma_p(arma_p), error(error),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_quantile(arma_quantile), arma_error(arma_error) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_p = arma_p.size();
+    RollQuantileSketch sketch(n_rows_x, error);
+    
+    arma_error[0] = 0;
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        
+        sketch.insert(x[i]);
+        
+        // achieved rank error relative to the number of observations
+        arma_error[0] = std::max(arma_error[0],
+                                 (double)(sketch.error_rank / sketch.n_obs));
+        
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (sketch.n_obs >= min_obs) {
+          
+          // each probability is answered from the same sketch
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, l) = sketch.quantile(arma_p[l]);
+          }
+          
+        } else {
+          
+          for (int l = 0; l < n_p; l++) {
+            arma_quantile(i, l) = NA_REAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        for (int l = 0; l < n_p; l++) {
+          arma_quantile(i, l) = x[i];
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollQuantileOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const arma::vec arma_p;
+  const int min_obs;
+  const bool na_restore;
+  arma::mat& arma_quantile;     // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollQuantileOfflineVec(const NumericVector x, const int n,
+                         const int n_rows_x, const int width,
+                         const arma::vec arma_weights, const arma::vec arma_p, 
+                         const int min_obs, const bool na_restore,
+                         arma::mat& arma_quantile)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), arma_p(arma_p),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_quantile(arma_quantile) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      int n_p = arma_p.size();
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        int k = 0;
+        int count = 0;
+        int n_obs = 0;
+        long double sum_w = 0;
+        
+        int offset = std::max(0, i - width + 1);
+        int n_size_x = i - offset + 1;
+        arma::vec x_subset(n_size_x);
+        arma::vec arma_weights_subset(n_size_x);
+        
+        std::copy(x.begin() + offset, x.begin() + i + 1,
+                  x_subset.begin());
+        std::copy(arma_weights.begin() + n - n_size_x, arma_weights.begin() + n,
+                  arma_weights_subset.begin());
+        
+        // similar to R's sort with 'index.return = TRUE'
+        arma::ivec sort_ix = stl_sort_index(x_subset);
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (n_size_x - 1 >= count)) {
+          
+          k = sort_ix[n_size_x - count - 1];
+          
+          // don't include if missing value
+          if (!std::isnan(x_subset[k])) {
+            
+            // compute the sum
+            sum_w += arma_weights_subset[k];
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        // each probability is answered from the same sorted window
+        for (int l = 0; l < n_p; l++) {
+          
+          count = 0;
+          int idxquantile_x = 0;
+          bool status = false;
+          long double sum_upper_w = 0;
+          long double sum_upper_w_temp = 0;
+          
+          // number of observations is either the window size or,
+          // for partial results, the number of the current row
+          while (!status && (width > count) && (n_size_x - 1 >= count)) {
+            
+            k = sort_ix[n_size_x - count - 1];
+            
+            // don't include if missing value
+            if (!std::isnan(x_subset[k])) {
+              
+              sum_upper_w += arma_weights_subset[k];
+              
+              // last element of sorted array that is 'p' of 'weights'
+              // note: 'weights' must be greater than 0
+              if (sum_upper_w / sum_w >= arma_p[l]) {
+                
+                status = true;
+                idxquantile_x = n_size_x - count - 1;
+                sum_upper_w_temp = sum_upper_w;
+                
+              }
+              
+            }
+            
+            count += 1;
+            
+          }
+          
+          if ((n_obs >= min_obs)) {
+            
+            k = sort_ix[idxquantile_x];
+            
+            // average if upper and lower weight is equal
+            if ((idxquantile_x > 0) &&
+                (std::fabs(sum_upper_w_temp / sum_w - arma_p[l]) <= sqrt(arma::datum::eps))) {
+              
+              int k_lower = sort_ix[idxquantile_x - 1];
+              arma_quantile(i, l) = (x_subset[k] + x_subset[k_lower]) / 2;
+              
+            } else {
+              arma_quantile(i, l) = x_subset[k];
+            }
+            
+          } else {
+            arma_quantile(i, l) = NA_REAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        for (int l = 0; l < n_p; l++) {
+          arma_quantile(i, l) = x[i];
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollEsOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_es;      // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollEsOnlineVec(const NumericVector x, const int n,
+                  const int n_rows_x, const int width,
+                  const arma::vec arma_weights, const double p,
+                  const int min_obs, const bool na_restore,
+                  NumericVector rcpp_es)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), p(p),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_es(rcpp_es) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    long double lambda = 1;
+    long double w_new = 1;
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    if ((width > 1) && (n > 1)) {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    bool status_w = (lambda != 1);
+    RollOrderTree tree(n_rows_x, status_w, true);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // weight of the new row relative to the first row
+      // note: only the ratio of weights is required for the mean
+      if (i > 0) {
+        w_new = w_new / lambda;
+      }
+      
+      // rescale the frame by a power of two to avoid overflow or underflow
+      if ((w_new > w_max) || (w_new < 1 / w_max)) {
+        
+        long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+        
+        tree.scale(scale);
+        
+        for (int k = 0; k < n_ring; k++) {
+          w_x[k] *= scale;
+        }
+        
+        w_new *= scale;
+        
+      }
+      
+      w_x[i % n_ring] = w_new;
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i], w_new, x[i]);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width], w_x[(i - width) % n_ring], x[i - width]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (tree.n_obs >= min_obs) {
+          
+          bool status_avg = false;
+          int k = tree.quantile(p, status_avg);
+          double quantile_x = x[rank_ix[tree.select(k)]];
+          
+          // average if upper and lower weight is equal
+          if (status_avg && (k > 0)) {
+            quantile_x = (quantile_x + x[rank_ix[tree.select(k - 1)]]) / 2;
+          }
+          
+          // mean of the observations less than or equal to the quantile
+          int r = rank_bound(x.begin(), n_rows_x, rank_ix, quantile_x, true);
+          long double sum_w = status_w ? tree.sum(r) : tree.count(r);
+          
+          rcpp_es[i] = tree.sum_x(r) / sum_w;
+          
+        } else {
+          rcpp_es[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_es[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollEsOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double p;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_es;      // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollEsOfflineVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int width,
+                   const arma::vec arma_weights, const double p,
+                   const int min_obs, const bool na_restore,
+                   NumericVector rcpp_es)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), p(p),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_es(rcpp_es) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[k])) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x[k], w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double quantile_x = quantile_w(x_w, sum_w, p);
+          long double sum_lower_w = 0;
+          long double sum_lower_x = 0;
+          
+          // mean of the observations less than or equal to the quantile
+          for (std::size_t k = 0; (k < x_w.size()) && (x_w[k].first <= quantile_x); k++) {
+            
+            sum_lower_w += x_w[k].second;
+            sum_lower_x += x_w[k].second * x_w[k].first;
+            
+          }
+          
+          rcpp_es[i] = sum_lower_x / sum_lower_w;
+          
+        } else {
+          rcpp_es[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_es[i] = x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollTrimMeanOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double trim;
+  const bool winsorize;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_mean;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollTrimMeanOnlineVec(const NumericVector x, const int n,
+                        const int n_rows_x, const int width,
+                        const arma::vec arma_weights, const double trim,
+                        const bool winsorize, const int min_obs,
+                        const bool na_restore, NumericVector rcpp_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), trim(trim),
+      winsorize(winsorize), min_obs(min_obs),
+      na_restore(na_restore), rcpp_mean(rcpp_mean) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    long double lambda = 1;
+    long double w_new = 1;
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    if ((width > 1) && (n > 1)) {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    bool status_w = (lambda != 1);
+    RollOrderTree tree(n_rows_x, status_w, true);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // weight of the new row relative to the first row
+      // note: only the ratio of weights is required for the mean
+      if (i > 0) {
+        w_new = w_new / lambda;
+      }
+      
+      // rescale the frame by a power of two to avoid overflow or underflow
+      if ((w_new > w_max) || (w_new < 1 / w_max)) {
+        
+        long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+        
+        tree.scale(scale);
+        
+        for (int k = 0; k < n_ring; k++) {
+          w_x[k] *= scale;
+        }
+        
+        w_new *= scale;
+        
+      }
+      
+      w_x[i % n_ring] = w_new;
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i], w_new, x[i]);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width], w_x[(i - width) % n_ring], x[i - width]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (tree.n_obs >= min_obs) {
+          
+          double quantile_x[2];
+          
+          // lower and upper quantiles, where 'p' is the upper probability
+          for (int l = 0; l < 2; l++) {
+            
+            bool status_avg = false;
+            int k = tree.quantile((l == 0) ? 1 - trim : trim, status_avg);
+            
+            quantile_x[l] = x[rank_ix[tree.select(k)]];
+            
+            // average if upper and lower weight is equal
+            if (status_avg && (k > 0)) {
+              quantile_x[l] = (quantile_x[l] + x[rank_ix[tree.select(k - 1)]]) / 2;
+            }
+            
+          }
+          
+          int r_lower = rank_bound(x.begin(), n_rows_x, rank_ix, quantile_x[0], false);
+          int r_upper = rank_bound(x.begin(), n_rows_x, rank_ix, quantile_x[1], true);
+          long double sum_lower_w = status_w ? tree.sum(r_lower) : tree.count(r_lower);
+          long double sum_upper_w = status_w ? tree.sum(r_upper) : tree.count(r_upper);
+          long double sum_x = tree.sum_x(r_upper) - tree.sum_x(r_lower);
+          
+          if (winsorize) {
+            
+            // observations outside the quantiles are replaced by the quantiles
+            long double sum_w = status_w ? tree.sum(n_rows_x) : tree.n_obs;
+            
+            rcpp_mean[i] = (sum_x + quantile_x[0] * sum_lower_w +
+              quantile_x[1] * (sum_w - sum_upper_w)) / sum_w;
+            
+          } else if (tree.count(r_upper) > tree.count(r_lower)) {
+            
+            // observations outside the quantiles are removed
+            rcpp_mean[i] = sum_x / (sum_upper_w - sum_lower_w);
+            
+          } else {
+            rcpp_mean[i] = (quantile_x[0] + quantile_x[1]) / 2;
+          }
+          
+        } else {
+          rcpp_mean[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mean[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollTrimMeanOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double trim;
+  const bool winsorize;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_mean;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollTrimMeanOfflineVec(const NumericVector x, const int n,
+                         const int n_rows_x, const int width,
+                         const arma::vec arma_weights, const double trim,
+                         const bool winsorize, const int min_obs,
+                         const bool na_restore, NumericVector rcpp_mean)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), trim(trim),
+      winsorize(winsorize), min_obs(min_obs),
+      na_restore(na_restore), rcpp_mean(rcpp_mean) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[k])) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x[k], w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double quantile_lower = quantile_w(x_w, sum_w, 1 - trim);
+          double quantile_upper = quantile_w(x_w, sum_w, trim);
+          long double sum_trim_w = 0;
+          long double sum_trim_x = 0;
+          
+          for (std::size_t k = 0; k < x_w.size(); k++) {
+            
+            if (winsorize) {
+              
+              // observations outside the quantiles are replaced by the quantiles
+              double value = std::min(std::max(x_w[k].first, quantile_lower), quantile_upper);
+              
+              sum_trim_w += x_w[k].second;
+              sum_trim_x += x_w[k].second * value;
+              
+            } else if ((x_w[k].first >= quantile_lower) && (x_w[k].first <= quantile_upper)) {
+              
+              // observations outside the quantiles are removed
+              sum_trim_w += x_w[k].second;
+              sum_trim_x += x_w[k].second * x_w[k].first;
+              
+            }
+            
+          }
+          
+          if (sum_trim_w > 0) {
+            rcpp_mean[i] = sum_trim_x / sum_trim_w;
+          } else {
+            rcpp_mean[i] = (quantile_lower + quantile_upper) / 2;
+          }
+          
+        } else {
+          rcpp_mean[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mean[i] = x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollMadOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_mad;     // destination (pass by reference)
+  RVector<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadOnlineVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int width,
+                   const arma::vec arma_weights, const double threshold,
+                   const int min_obs, const bool na_restore,
+                   NumericVector rcpp_mad, LogicalVector rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), threshold(threshold),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    RollOrderTree tree(n_rows_x);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    
+    // k-th smallest observation in the window
+    auto value = [&](int k) { return x[rank_ix[tree.select(k)]]; };
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i]);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (tree.n_obs >= min_obs) {
+          
+          double center = 0;
+          rcpp_mad[i] = mad_select(tree.n_obs, value, center);
+          
+          // flag if the absolute deviation is more than 'threshold' times
+          // the scaled median absolute deviation (see R's mad)
+          if (threshold > 0) {
+            
+            if (std::isnan(x[i])) {
+              rcpp_outlier[i] = NA_LOGICAL;
+            } else {
+              rcpp_outlier[i] = std::fabs(x[i] - center) > threshold * 1.4826 * rcpp_mad[i];
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_mad[i] = NA_REAL;
+          
+          if (threshold > 0) {
+            rcpp_outlier[i] = NA_LOGICAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mad[i] = x[i];
+        
+        if (threshold > 0) {
+          rcpp_outlier[i] = NA_LOGICAL;
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a sorted window
+struct RollMadSortedVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_mad;     // destination (pass by reference)
+  RVector<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadSortedVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int width,
+                   const arma::vec arma_weights, const double threshold,
+                   const int min_obs, const bool na_restore,
+                   NumericVector rcpp_mad, LogicalVector rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), threshold(threshold),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    RollSortedWindow sorted(std::min(width, n_rows_x));
+    
+    // k-th smallest observation in the window
+    auto value = [&](int k) { return sorted.window[k].value; };
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        sorted.insert(x[i], i);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        sorted.erase(x[i - width], i - width);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (sorted.n_obs() >= min_obs) {
+          
+          double center = 0;
+          rcpp_mad[i] = mad_select(sorted.n_obs(), value, center);
+          
+          // flag if the absolute deviation is more than 'threshold' times
+          // the scaled median absolute deviation (see R's mad)
+          if (threshold > 0) {
+            
+            if (std::isnan(x[i])) {
+              rcpp_outlier[i] = NA_LOGICAL;
+            } else {
+              rcpp_outlier[i] = std::fabs(x[i] - center) > threshold * 1.4826 * rcpp_mad[i];
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_mad[i] = NA_REAL;
+          
+          if (threshold > 0) {
+            rcpp_outlier[i] = NA_LOGICAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mad[i] = x[i];
+        
+        if (threshold > 0) {
+          rcpp_outlier[i] = NA_LOGICAL;
+        }
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollMadOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double threshold;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_mad;     // destination (pass by reference)
+  RVector<int> rcpp_outlier;
+  
+  // initialize with source and destination
+  RollMadOfflineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int width,
+                    const arma::vec arma_weights, const double threshold,
+                    const int min_obs, const bool na_restore,
+                    NumericVector rcpp_mad, LogicalVector rcpp_outlier)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), threshold(threshold),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_mad(rcpp_mad), rcpp_outlier(rcpp_outlier) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    
+    bool status_eq = all(arma_weights == arma_weights[0]);
+    std::vector<std::pair<double, long double> > x_w;
+    std::vector<std::pair<double, long double> > dev_w;
+    
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        long double sum_w = 0;
+        int offset = std::max(0, i - width + 1);
+        
+        x_w.clear();
+        dev_w.clear();
+        
+        for (int k = offset; k <= i; k++) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[k])) {
+            
+            // weight of each observation is by row within the window
+            long double w = status_eq ? 1 : arma_weights[n - 1 - i + k];
+            
+            x_w.push_back(std::make_pair(x[k], w));
+            sum_w += w;
+            
+          }
+          
+        }
+        
+        if ((int)x_w.size() >= min_obs) {
+          
+          std::sort(x_w.begin(), x_w.end());
+          double center = quantile_w(x_w, sum_w, 0.5);
+          
+          for (std::size_t k = 0; k < x_w.size(); k++) {
+            dev_w.push_back(std::make_pair(std::fabs(x_w[k].first - center), x_w[k].second));
+          }
+          
+          std::sort(dev_w.begin(), dev_w.end());
+          rcpp_mad[i] = quantile_w(dev_w, sum_w, 0.5);
+          
+          // flag if the absolute deviation is more than 'threshold' times
+          // the scaled median absolute deviation (see R's mad)
+          if (threshold > 0) {
+            
+            if (std::isnan(x[i])) {
+              rcpp_outlier[i] = NA_LOGICAL;
+            } else {
+              rcpp_outlier[i] = std::fabs(x[i] - center) > threshold * 1.4826 * rcpp_mad[i];
+            }
+            
+          }
+          
+        } else {
+          
+          rcpp_mad[i] = NA_REAL;
+          
+          if (threshold > 0) {
+            rcpp_outlier[i] = NA_LOGICAL;
+          }
+          
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_mad[i] = x[i];
+        
+        if (threshold > 0) {
+          rcpp_outlier[i] = NA_LOGICAL;
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+struct RollRankOnlineVec {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double ties;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_rank;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollRankOnlineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int width,
+                    const arma::vec arma_weights, const double ties,
+                    const int min_obs, const bool na_restore,
+                    NumericVector rcpp_rank)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), ties(ties),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_rank(rcpp_rank) { }
+  
+  // function call operator that iterates by index
+  void operator()() {
+    
+    int n_ring = std::min(width, n_rows_x) + 1;
+    long double w_max = std::ldexp(1.0L, 512);
+    long double lambda = 1;
+    long double w_new = 1;
+    std::vector<int> rank_x(n_rows_x);
+    std::vector<int> rank_ix(n_rows_x);
+    std::vector<int> ties_lower(n_rows_x);
+    std::vector<int> ties_upper(n_rows_x);
+    std::vector<long double> w_x(n_ring);
+    
+    if ((width > 1) && (n > 1)) {
+      lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+    }
+    
+    bool status_w = (lambda != 1);
+    RollOrderTree tree(n_rows_x, status_w);
+    
+    // similar to R's rank with 'ties.method = "first"'
+    rank_index(x.begin(), n_rows_x, rank_x, rank_ix);
+    rank_ties(x.begin(), n_rows_x, rank_ix, ties_lower, ties_upper);
+    
+    for (int i = 0; i < n_rows_x; i++) {
+      
+      // weight of the new row relative to the first row
+      // note: only the ratio of weights is required for the rank
+      if (i > 0) {
+        w_new = w_new / lambda;
+      }
+      
+      // rescale the frame by a power of two to avoid overflow or underflow
+      if ((w_new > w_max) || (w_new < 1 / w_max)) {
+        
+        long double scale = std::ldexp(1.0L, -std::ilogb(w_new));
+        
+        tree.scale(scale);
+        
+        for (int k = 0; k < n_ring; k++) {
+          w_x[k] *= scale;
+        }
+        
+        w_new *= scale;
+        
+      }
+      
+      w_x[i % n_ring] = w_new;
+      
+      // expanding window
+      // don't include if missing value
+      if (!std::isnan(x[i])) {
+        tree.insert(rank_x[i], w_new);
+      }
+      
+      // rolling window
+      if ((i >= width) && !std::isnan(x[i - width])) {
+        tree.erase(rank_x[i - width], w_x[(i - width) % n_ring]);
+      }
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        // current observation must be within the window
+        if ((tree.n_obs >= min_obs) && !std::isnan(x[i])) {
+          
+          int lower = ties_lower[rank_x[i]];
+          int upper = ties_upper[rank_x[i]];
+          
+          // fraction of the window below the current observation, where
+          // 'ties' is the fraction of other equal observations that are below
+          if (status_w) {
+            
+            long double sum_w = tree.sum(n_rows_x);
+            long double sum_lower_w = tree.sum(lower);
+            long double sum_ties_w = tree.sum(upper) - sum_lower_w - w_new;
+            
+            rcpp_rank[i] = (sum_lower_w + ties * sum_ties_w) / sum_w;
+            
+          } else {
+            
+            int n_lower = tree.count(lower);
+            int n_ties = tree.count(upper) - n_lower - 1;
+            
+            rcpp_rank[i] = (n_lower + ties * n_ties) / tree.n_obs;
+            
+          }
+          
+        } else {
+          rcpp_rank[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_rank[i] = x[i];
+        
+      }
+      
+    }
+    
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using a standard algorithm
+struct RollRankOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const double ties;
+  const int min_obs;
+  const bool na_restore;
+  RVector<double> rcpp_rank;    // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollRankOfflineVec(const NumericVector x, const int n,
+                     const int n_rows_x, const int width,
+                     const arma::vec arma_weights, const double ties,
+                     const int min_obs, const bool na_restore,
+                     NumericVector rcpp_rank)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), ties(ties),
+      min_obs(min_obs), na_restore(na_restore),
+      rcpp_rank(rcpp_rank) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        int count = 0;
+        int n_obs = 0;
+        long double sum_w = 0;
+        long double sum_lower_w = 0;
+        long double sum_ties_w = 0;
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (i >= count)) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i - count])) {
+            
+            sum_w += arma_weights[n - count - 1];
+            
+            if (x[i - count] < x[i]) {
+              sum_lower_w += arma_weights[n - count - 1];
+            } else if ((count > 0) && (x[i - count] == x[i])) {
+              sum_ties_w += arma_weights[n - count - 1];
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        // current observation must be within the window
+        if ((n_obs >= min_obs) && !std::isnan(x[i])) {
+          rcpp_rank[i] = (sum_lower_w + ties * sum_ties_w) / sum_w;
+        } else {
+          rcpp_rank[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        rcpp_rank[i] = x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
+struct RollVarOnlineVec : public Worker {
+  
+  typedef typename Accum::value_type value_type;
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  const int reanchor;
+  arma::vec& arma_var;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
+  
+  // initialize with source and destination
+  RollVarOnlineVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const bool center, const int min_obs,
+                   const bool na_restore, const int reanchor,
+                   arma::vec& arma_var, arma::vec& arma_reanchor)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), reanchor(reanchor),
+      arma_var(arma_var), arma_reanchor(arma_reanchor) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      int n_obs = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0; 
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
+      Accum sumsq_w;
+      Accum sumsq_x;
+      value_type mean_prev_x = 0;
+      value_type mean_x = 0;
+      
+      if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      } else {
+        lambda = arma_weights[n - 1];
+      }
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        if (std::isnan(x[i])) {
+          
+          w_new = 0;
+          x_new = 0;
+          
+        } else {
+          
+          w_new = arma_weights[n - 1];
+          x_new = x[i];
+          
+        }
+        
+        // expanding window
+        if (i < offset + width) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i])) {
+            n_obs += 1;
+          }
+          
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
+            
+          }
+          
+          if (center && (n_obs > 0)) {
+            
+            // compute the mean
+            mean_prev_x = mean_x;
+            mean_x = sum_x.value() / sum_w.value();
+            
+          }
+          
+          // compute the sum of squares
+          if (!std::isnan(x[i]) && (n_obs > 1)) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            
+          } else if (std::isnan(x[i])) {
+            
+            sumsq_x.scale(lambda);
+            
+          } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
+            
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
+            
+          }
+          
+        }
+        
+        // rolling window
+        if (i >= offset + width) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            n_obs += 1;
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            n_obs -= 1;
+            
+          }
+          
+          if (std::isnan(x[i - width])) {
+            
+            w_old = 0;
+            x_old = 0;
+            
+          } else {
+            
+            w_old = arma_weights[n - width];
+            x_old = x[i - width];
+            
+          }
+          
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
+            
+          }
+          
+          if (center && (n_obs > 0)) {
+            
+            // compute the mean
+            mean_prev_x = mean_x;
+            mean_x = sum_x.value() / sum_w.value();
+            
+          }
+          
+          // compute the sum of squares
+          if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            
+          } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            
+          } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            
+          }
+          
+        }
+        
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+          
+          RollReanchor exact(x.begin(), x.begin(), NULL,
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, center);
+          
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sumsq_x.value() - exact.sumsq_x));
+          }
+          
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
+          sumsq_w.set(exact.sumsq_w);
+          sumsq_x.set(exact.sumsq_x);
+          mean_x = exact.mean_x;
+          
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            arma_var[i] = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
+          } else {
+            arma_var[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_var[i] = x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an offline algorithm
+struct RollVarOfflineVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_var;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollVarOfflineVec(const NumericVector x, const int n,
+                    const int n_rows_x, const int width,
+                    const arma::vec arma_weights, const bool center,
+                    const int min_obs, const bool na_restore,
+                    arma::vec& arma_var)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), width(width),
+      arma_weights(arma_weights), center(center),
+      min_obs(min_obs), na_restore(na_restore),
+      arma_var(arma_var) { }
+  
+  // function call operator that iterates by index
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // from 1D to 2D array
+      int i = z;
+      
+      long double mean_x = 0;
+      
+      // don't compute if missing value and 'na_restore' argument is TRUE
+      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        
+        if (center) {
+          
+          int count = 0;
+          long double sum_w = 0;
+          long double sum_x = 0;
+          
+          // number of observations is either the window size or,
+          // for partial results, the number of the current row
+          while ((width > count) && (i >= count)) {
+            
+            // don't include if missing value
+            if (!std::isnan(x[i - count])) {
+              
+              // compute the sum
+              sum_w += arma_weights[n - count - 1];
+              sum_x += arma_weights[n - count - 1] * x[i - count];
+              
+            }
+            
+            count += 1;
+            
+          }
+          
+          // compute the mean
+          mean_x = sum_x / sum_w;
+          
+        }
+        
+        int count = 0;
+        int n_obs = 0;
+        long double sum_w = 0;
+        long double sumsq_w = 0;
+        long double sumsq_x = 0;
+        
+        // number of observations is either the window size or,
+        // for partial results, the number of the current row
+        while ((width > count) && (i >= count)) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i - count])) {
+            
+            sum_w += arma_weights[n - count - 1];
+            sumsq_w += pow(arma_weights[n - count - 1], 2.0);
+            
+            // compute the sum of squares with 'center' argument
+            if (center) {
+              sumsq_x += arma_weights[n - count - 1] *
+                pow(x[i - count] - mean_x, (long double)2.0);
+            } else if (!center) {
+              sumsq_x += arma_weights[n - count - 1] *
+                pow(x[i - count], 2.0);
+            }
+            
+            n_obs += 1;
+            
+          }
+          
+          count += 1;
+          
+        }
+        
+        if ((n_obs > 1) && (n_obs >= min_obs)) {
+          arma_var[i] = sumsq_x / (sum_w - sumsq_w / sum_w);
+        } else {
+          arma_var[i] = NA_REAL;
+        }
+        
+      } else {
+        
+        // can be either NA or NaN
+        arma_var[i] = x[i];
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollVarPrefixVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_var;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollVarPrefixVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const bool center, const int min_obs,
+                   const bool na_restore, arma::vec& arma_var)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), arma_var(arma_var) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 2, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          
+          // shift by the first finite observation if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x[i])) {
+            
+            x_ref = x[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = value[0] * value[0];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            
+            arma_var[i] = sumsq_x / (sum_w - sumsq_w / sum_w);
+            
+          } else {
+            arma_var[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_var[i] = x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollVarLinearVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_var;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollVarLinearVec(const NumericVector x, const int n,
+                   const int n_rows_x, const int n_rows_chunk,
+                   const int width, const arma::vec arma_weights,
+                   const bool center, const int min_obs,
+                   const bool na_restore, arma::vec& arma_var)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), arma_var(arma_var) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 2, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          
+          // shift by the first observation if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = value[0] * value[0];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            
+            arma_var[i] = sumsq_x / (sum_w - sumsq_w / sum_w);
+            
+          } else {
+            arma_var[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_var[i] = x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
+struct RollSdOnlineVec : public Worker {
+  
+  typedef typename Accum::value_type value_type;
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  const int reanchor;
+  arma::vec& arma_sd;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
+  
+  // initialize with source and destination
+  RollSdOnlineVec(const NumericVector x, const int n,
+                  const int n_rows_x, const int n_rows_chunk,
+                  const int width, const arma::vec arma_weights,
+                  const bool center, const int min_obs,
+                  const bool na_restore, const int reanchor,
+                  arma::vec& arma_sd, arma::vec& arma_reanchor)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), reanchor(reanchor),
+      arma_sd(arma_sd), arma_reanchor(arma_reanchor) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      int n_obs = 0;
+      value_type lambda = 0;
+      value_type w_new = 0;
+      value_type w_old = 0; 
+      value_type x_new = 0;
+      value_type x_old = 0;
+      Accum sum_w;
+      Accum sum_x;
+      Accum sumsq_w;
+      Accum sumsq_x;
+      value_type mean_prev_x = 0;
+      value_type mean_x = 0;
+      value_type var_x = 0;
+      
+      if (width > 1) {
+        lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
+      } else {
+        lambda = arma_weights[n - 1];
+      }
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        if (std::isnan(x[i])) {
+          
+          w_new = 0;
+          x_new = 0;
+          
+        } else {
+          
+          w_new = arma_weights[n - 1];
+          x_new = x[i];
+          
+        }
+        
+        // expanding window
+        if (i < offset + width) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i])) {
+            n_obs += 1;
+          }
+          
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
+            
+          }
+          
+          if (center && (n_obs > 0)) {
+            
+            // compute the mean
+            mean_prev_x = mean_x;
+            mean_x = sum_x.value() / sum_w.value();
+            
+          }
+          
+          // compute the sum of squares
+          if (!std::isnan(x[i]) && (n_obs > 1)) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            
+          } else if (std::isnan(x[i])) {
+            
+            sumsq_x.scale(lambda);
+            
+          } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
+            
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
+            
+          }
+          
+          var_x = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
+          
+        }
+        
+        // rolling window
+        if (i >= offset + width) {
+          
+          // don't include if missing value
+          if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            n_obs += 1;
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            n_obs -= 1;
+            
+          }
+          
+          if (std::isnan(x[i - width])) {
+            
+            w_old = 0;
+            x_old = 0;
+            
+          } else {
+            
+            w_old = arma_weights[n - width];
+            x_old = x[i - width];
+            
+          }
+          
+          if (width > 1) {
+            
+            sum_w.scale(lambda);
+            sum_w.add(w_new);
+            sum_w.add(-(lambda * w_old));
+            sum_x.scale(lambda);
+            sum_x.add(w_new * x_new);
+            sum_x.add(-(lambda * w_old * x_old));
+            sumsq_w.scale(pow(lambda, (value_type)2.0));
+            sumsq_w.add(pow(w_new, (value_type)2.0));
+            sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
+            
+          } else {
+            
+            sum_w.set(w_new);
+            sum_x.set(w_new * x_new);
+            sumsq_w.set(pow(w_new, (value_type)2.0));
+            
+          }
+          
+          if (center && (n_obs > 0)) {
+            
+            // compute the mean
+            mean_prev_x = mean_x;
+            mean_x = sum_x.value() / sum_w.value();
+            
+          }
+          
+          // compute the sum of squares
+          if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            
+          } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            
+          } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            
+          } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
+            
+            sumsq_x.scale(lambda);
+            
+          }
           
-          // compute the mean
-          mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
+          var_x = sumsq_x.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
           
         }
         
-        // compute the sum of squares
-        if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-          
-        } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
-          
-          sumsq_x = lambda * sumsq_x +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-          
-        } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
+        // recompute the sums of the window every 'reanchor' rows
+        if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
           
-          sumsq_x = lambda * sumsq_x -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+          RollReanchor exact(x.begin(), x.begin(), NULL,
+                             std::max(offset, i - width + 1), i,
+                             n, arma_weights, center);
           
-        } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
+          if (i >= begin_row) {
+            arma_reanchor[z] = std::max(arma_reanchor[z], (double)std::abs(sumsq_x.value() - exact.sumsq_x));
+          }
           
-          sumsq_x = lambda * sumsq_x;
+          sum_w.set(exact.sum_w);
+          sum_x.set(exact.sum_x);
+          sumsq_w.set(exact.sumsq_w);
+          sumsq_x.set(exact.sumsq_x);
+          mean_x = exact.mean_x;
           
         }
         
-        var_x = sumsq_x / (sum_w - sumsq_w / sum_w);
-        
-      }
-      
-      // don't compute if missing value
-      if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
         
-        if ((n_obs > 1) && (n_obs >= min_obs)) {
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
           
-          if ((var_x < 0) || (sqrt(var_x) <= sqrt(arma::datum::eps))) {
-            arma_sd[i] = 0;
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            if ((var_x < 0) || (sqrt(var_x) <= sqrt(arma::datum::eps))) {
+              arma_sd[i] = 0;
+            } else {
+              arma_sd[i] = sqrt(var_x);
+            }
+            
           } else {
-            arma_sd[i] = sqrt(var_x);
+            arma_sd[i] = NA_REAL;
           }
           
         } else {
-          arma_sd[i] = NA_REAL;
+          
+          // can be either NA or NaN
+          arma_sd[i] = x[i];
+          
         }
         
-      } else {
-        
-        // can be either NA or NaN
-        arma_sd[i] = x[i];
-        
       }
       
     }
-    
   }
   
 };
@@ -2624,6 +5640,220 @@ struct RollSdOfflineVec : public Worker {
   
 };
 
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollSdPrefixVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_sd;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollSdPrefixVec(const NumericVector x, const int n,
+                  const int n_rows_x, const int n_rows_chunk,
+                  const int width, const arma::vec arma_weights,
+                  const bool center, const int min_obs,
+                  const bool na_restore, arma::vec& arma_sd)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), arma_sd(arma_sd) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollPrefixSums prefix(std::min(width, n_rows_x), 2, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          
+          // shift by the first finite observation if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x[i])) {
+            
+            x_ref = x[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = value[0] * value[0];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            
+            arma_sd[i] = sqrt(sumsq_x / (sum_w - sumsq_w / sum_w));
+            
+          } else {
+            arma_sd[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sd[i] = x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollSdLinearVec : public Worker {
+  
+  const RVector<double> x;      // source
+  const int n;
+  const int n_rows_x;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_sd;          // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollSdLinearVec(const NumericVector x, const int n,
+                  const int n_rows_x, const int n_rows_chunk,
+                  const int width, const arma::vec arma_weights,
+                  const bool center, const int min_obs,
+                  const bool na_restore, arma::vec& arma_sd)
+    : x(x), n(n),
+      n_rows_x(n_rows_x), n_rows_chunk(n_rows_chunk),
+      width(width), arma_weights(arma_weights),
+      center(center), min_obs(min_obs),
+      na_restore(na_restore), arma_sd(arma_sd) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_x);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      bool status_ref = false;
+      long double value[2];
+      long double sum[2];
+      RollLinearSums linear(width, std::min(width, n_rows_x), 2, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i])) {
+          
+          // shift by the first observation if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = value[0] * value[0];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sumsq_x = sum[1];
+            
+            if (center) {
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            
+            arma_sd[i] = sqrt(sumsq_x / (sum_w - sumsq_w / sum_w));
+            
+          } else {
+            arma_sd[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          arma_sd[i] = x[i];
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
 // 'Worker' function for computing the rolling statistic using an online algorithm
 struct RollScaleOnlineVec {
   
@@ -3023,8 +6253,11 @@ struct RollScaleOfflineVec : public Worker {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollCovOnlineVecXX {
   
+  typedef typename Accum::value_type value_type;
+  
   const RVector<double> x;      // source
   const int n;
   const int n_rows_xy;
@@ -3034,36 +6267,40 @@ struct RollCovOnlineVecXX {
   const bool scale;
   const int min_obs;
   const bool na_restore;
+  const int reanchor;
   arma::vec& arma_cov;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollCovOnlineVecXX(const NumericVector x, const int n,
                      const int n_rows_xy, const int width,
                      const arma::vec arma_weights, const bool center,
                      const bool scale, const int min_obs,
-                     const bool na_restore, arma::vec& arma_cov)
+                     const bool na_restore, const int reanchor,
+                     arma::vec& arma_cov, arma::vec& arma_reanchor)
     : x(x), n(n),
       n_rows_xy(n_rows_xy), width(width),
       arma_weights(arma_weights), center(center),
       scale(scale), min_obs(min_obs),
-      na_restore(na_restore), arma_cov(arma_cov) { }
+      na_restore(na_restore), reanchor(reanchor),
+      arma_cov(arma_cov), arma_reanchor(arma_reanchor) { }
   
   // function call operator that iterates by column
   void operator()() {
     
     int n_obs = 0;
-    long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0;      
-    long double x_new = 0;
-    long double x_old = 0;
-    long double sum_w = 0;
-    long double sum_x = 0;
-    long double sumsq_w = 0;
-    long double sumsq_x = 0;
-    long double sumsq_xy = 0;
-    long double mean_prev_x = 0;
-    long double mean_x = 0;
+    value_type lambda = 0;
+    value_type w_new = 0;
+    value_type w_old = 0;      
+    value_type x_new = 0;
+    value_type x_old = 0;
+    Accum sum_w;
+    Accum sum_x;
+    Accum sumsq_w;
+    Accum sumsq_x;
+    Accum sumsq_xy;
+    value_type mean_prev_x = 0;
+    value_type mean_x = 0;
     
     if (width > 1) {
       lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -3095,15 +6332,18 @@ struct RollCovOnlineVecXX {
         
         if (width > 1) {
           
-          sum_w = lambda * sum_w + w_new;
-          sum_x = lambda * sum_x + w_new * x_new;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+          sum_w.scale(lambda);
+          sum_w.add(w_new);
+          sum_x.scale(lambda);
+          sum_x.add(w_new * x_new);
+          sumsq_w.scale(pow(lambda, (value_type)2.0));
+          sumsq_w.add(pow(w_new, (value_type)2.0));
           
         } else {
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          sum_w.set(w_new);
+          sum_x.set(w_new * x_new);
+          sumsq_w.set(pow(w_new, (value_type)2.0));
           
         }
         
@@ -3111,7 +6351,7 @@ struct RollCovOnlineVecXX {
           
           // compute the mean
           mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
+          mean_x = sum_x.value() / sum_w.value();
           
         }
         
@@ -3120,16 +6360,16 @@ struct RollCovOnlineVecXX {
           // compute the sum of squares
           if (!std::isnan(x[i]) && (n_obs > 1)) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if (std::isnan(x[i])) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
             
-            sumsq_x = w_new * pow(x_new, (long double)2.0);
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
             
           }
           
@@ -3138,16 +6378,16 @@ struct RollCovOnlineVecXX {
         // compute the sum of squares
         if (!std::isnan(x[i]) && (n_obs > 1)) {
           
-          sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
           
         } else if (std::isnan(x[i])) {
           
-          sumsq_xy = lambda * sumsq_xy;
+          sumsq_xy.scale(lambda);
           
         } else if (!std::isnan(x[i]) && (n_obs == 1) && !center) {
           
-          sumsq_xy = w_new * pow(x_new, (long double)2.0);
+          sumsq_xy.set(w_new * pow(x_new, (value_type)2.0));
           
         }
         
@@ -3181,16 +6421,21 @@ struct RollCovOnlineVecXX {
         
         if (width > 1) {
           
-          sum_w = lambda * sum_w + w_new - lambda * w_old;
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-            pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+          sum_w.scale(lambda);
+          sum_w.add(w_new);
+          sum_w.add(-(lambda * w_old));
+          sum_x.scale(lambda);
+          sum_x.add(w_new * x_new);
+          sum_x.add(-(lambda * w_old * x_old));
+          sumsq_w.scale(pow(lambda, (value_type)2.0));
+          sumsq_w.add(pow(w_new, (value_type)2.0));
+          sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
           
         } else {
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          sum_w.set(w_new);
+          sum_x.set(w_new * x_new);
+          sumsq_w.set(pow(w_new, (value_type)2.0));
           
         }
         
@@ -3198,7 +6443,7 @@ struct RollCovOnlineVecXX {
           
           // compute the mean
           mean_prev_x = mean_x;
-          mean_x = sum_x / sum_w;
+          mean_x = sum_x.value() / sum_w.value();
           
         }
         
@@ -3207,23 +6452,23 @@ struct RollCovOnlineVecXX {
           // compute the sum of squares
           if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
             
           } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
             
-            sumsq_x = lambda * sumsq_x -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
             
           } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
             
-            sumsq_x = lambda * sumsq_x;
+            sumsq_x.scale(lambda);
             
           }
           
@@ -3232,28 +6477,46 @@ struct RollCovOnlineVecXX {
         // compute the sum of squares
         if (!std::isnan(x[i]) && !std::isnan(x[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+          sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
           
         } else if (!std::isnan(x[i]) && std::isnan(x[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (x_new - mean_prev_x);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
           
         } else if (std::isnan(x[i]) && !std::isnan(x[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
           
         } else if (std::isnan(x[i]) || std::isnan(x[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy;
+          sumsq_xy.scale(lambda);
           
         }
         
       }
       
+      // recompute the sums of the window every 'reanchor' rows
+      if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+        
+        RollReanchor exact(x.begin(), x.begin(), NULL,
+                           std::max(0, i - width + 1), i,
+                           n, arma_weights, center);
+        
+        arma_reanchor[0] = std::max(arma_reanchor[0], (double)std::abs(sumsq_xy.value() - exact.sumsq_xy));
+        
+        sum_w.set(exact.sum_w);
+        sum_x.set(exact.sum_x);
+        sumsq_w.set(exact.sumsq_w);
+        sumsq_x.set(exact.sumsq_x);
+        sumsq_xy.set(exact.sumsq_xy);
+        mean_x = exact.mean_x;
+        
+      }
+      
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]))) {
         
@@ -3262,14 +6525,14 @@ struct RollCovOnlineVecXX {
           if (scale) {
             
             // don't compute if the standard deviation is zero
-            if ((sumsq_x < 0) || (sqrt(sumsq_x) <= sqrt(arma::datum::eps)))  {
+            if ((sumsq_x.value() < 0) || (sqrt(sumsq_x.value()) <= sqrt(arma::datum::eps)))  {
               arma_cov[i] = NA_REAL;
             } else {
-              arma_cov[i] = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_x));
+              arma_cov[i] = sumsq_xy.value() / (sqrt(sumsq_x.value()) * sqrt(sumsq_x.value()));
             }
             
           } else if (!scale) {
-            arma_cov[i] = sumsq_xy / (sum_w - sumsq_w / sum_w);
+            arma_cov[i] = sumsq_xy.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
           }
           
         } else {
@@ -3290,8 +6553,11 @@ struct RollCovOnlineVecXX {
 };
 
 // 'Worker' function for computing the rolling statistic using an online algorithm
+template <typename Accum>
 struct RollCovOnlineVecXY {
   
+  typedef typename Accum::value_type value_type;
+  
   const RVector<double> x;      // source
   const RVector<double> y;      // source
   const int n;
@@ -3302,44 +6568,48 @@ struct RollCovOnlineVecXY {
   const bool scale;
   const int min_obs;
   const bool na_restore;
+  const int reanchor;
   arma::vec& arma_cov;          // destination (pass by reference)
+  arma::vec& arma_reanchor;
   
   // initialize with source and destination
   RollCovOnlineVecXY(const NumericVector x, const NumericVector y,
-                     const int n, const int n_rows_xy,
-                     const int width, const arma::vec arma_weights,
-                     const bool center, const bool scale,
-                     const int min_obs, const bool na_restore,
-                     arma::vec& arma_cov)
-    : x(x), y(y),
-      n(n), n_rows_xy(n_rows_xy),
-      width(width), arma_weights(arma_weights),
-      center(center), scale(scale),
-      min_obs(min_obs), na_restore(na_restore),
-      arma_cov(arma_cov) { }
-  
-  // function call operator that iterates by column
-  void operator()() {
-    
-    int n_obs = 0;
-    long double lambda = 0;
-    long double w_new = 0;
-    long double w_old = 0;
-    long double x_new = 0;
-    long double x_old = 0;
-    long double y_new = 0;
-    long double y_old = 0;
-    long double sum_w = 0;
-    long double sum_x = 0;
-    long double sum_y = 0;
-    long double sumsq_w = 0;
-    long double sumsq_x = 0;
-    long double sumsq_y = 0;
-    long double sumsq_xy = 0;
-    long double mean_prev_x = 0;
-    long double mean_prev_y = 0;
-    long double mean_x = 0;
-    long double mean_y = 0;
+                     const int n, const int n_rows_xy,
+                     const int width, const arma::vec arma_weights,
+                     const bool center, const bool scale,
+                     const int min_obs, const bool na_restore,
+                     const int reanchor, arma::vec& arma_cov,
+                     arma::vec& arma_reanchor)
+    : x(x), y(y),
+      n(n), n_rows_xy(n_rows_xy),
+      width(width), arma_weights(arma_weights),
+      center(center), scale(scale),
+      min_obs(min_obs), na_restore(na_restore),
+      reanchor(reanchor), arma_cov(arma_cov),
+      arma_reanchor(arma_reanchor) { }
+  
+  // function call operator that iterates by column
+  void operator()() {
+    
+    int n_obs = 0;
+    value_type lambda = 0;
+    value_type w_new = 0;
+    value_type w_old = 0;
+    value_type x_new = 0;
+    value_type x_old = 0;
+    value_type y_new = 0;
+    value_type y_old = 0;
+    Accum sum_w;
+    Accum sum_x;
+    Accum sum_y;
+    Accum sumsq_w;
+    Accum sumsq_x;
+    Accum sumsq_y;
+    Accum sumsq_xy;
+    value_type mean_prev_x = 0;
+    value_type mean_prev_y = 0;
+    value_type mean_x = 0;
+    value_type mean_y = 0;
     
     if (width > 1) {
       lambda = arma_weights[n - 2] / arma_weights[n - 1]; // check already passed
@@ -3373,17 +6643,21 @@ struct RollCovOnlineVecXY {
         
         if (width > 1) {
           
-          sum_w = lambda * sum_w + w_new;
-          sum_x = lambda * sum_x + w_new * x_new;
-          sum_y = lambda * sum_y + w_new * y_new;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w + pow(w_new, (long double)2.0);
+          sum_w.scale(lambda);
+          sum_w.add(w_new);
+          sum_x.scale(lambda);
+          sum_x.add(w_new * x_new);
+          sum_y.scale(lambda);
+          sum_y.add(w_new * y_new);
+          sumsq_w.scale(pow(lambda, (value_type)2.0));
+          sumsq_w.add(pow(w_new, (value_type)2.0));
           
         } else {
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sum_y = w_new * y_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          sum_w.set(w_new);
+          sum_x.set(w_new * x_new);
+          sum_y.set(w_new * y_new);
+          sumsq_w.set(pow(w_new, (value_type)2.0));
           
         }
         
@@ -3392,8 +6666,8 @@ struct RollCovOnlineVecXY {
           // compute the mean
           mean_prev_x = mean_x;
           mean_prev_y = mean_y;
-          mean_x = sum_x / sum_w;
-          mean_y = sum_y / sum_w;
+          mean_x = sum_x.value() / sum_w.value();
+          mean_y = sum_y.value() / sum_w.value();
           
         }
         
@@ -3402,20 +6676,20 @@ struct RollCovOnlineVecXY {
           // compute the sum of squares
           if (!std::isnan(x[i]) && !std::isnan(y[i]) && (n_obs > 1)) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-            sumsq_y = lambda * sumsq_y +
-              w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_y.scale(lambda);
+            sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
             
           } else if (std::isnan(x[i]) || std::isnan(y[i])) {
             
-            sumsq_x = lambda * sumsq_x;
-            sumsq_y = lambda * sumsq_y;
+            sumsq_x.scale(lambda);
+            sumsq_y.scale(lambda);
             
           } else if (!std::isnan(x[i]) && !std::isnan(y[i]) && (n_obs == 1) && !center) {
             
-            sumsq_x = w_new * pow(x_new, (long double)2.0);
-            sumsq_y = w_new * pow(y_new, (long double)2.0);
+            sumsq_x.set(w_new * pow(x_new, (value_type)2.0));
+            sumsq_y.set(w_new * pow(y_new, (value_type)2.0));
             
           }
           
@@ -3424,16 +6698,16 @@ struct RollCovOnlineVecXY {
         // compute the sum of squares
         if (!std::isnan(x[i]) && !std::isnan(y[i]) && (n_obs > 1)) {
           
-          sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (y_new - mean_prev_y);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
           
         } else if (std::isnan(x[i]) || std::isnan(y[i])) {
           
-          sumsq_xy = lambda * sumsq_xy;
+          sumsq_xy.scale(lambda);
           
         } else if (!std::isnan(x[i]) && !std::isnan(y[i]) && (n_obs == 1) && !center) {
           
-          sumsq_xy = w_new * x_new * y_new;
+          sumsq_xy.set(w_new * x_new * y_new);
           
         }
         
@@ -3471,18 +6745,25 @@ struct RollCovOnlineVecXY {
         
         if (width > 1) {
           
-          sum_w = lambda * sum_w + w_new - lambda * w_old;
-          sum_x = lambda * sum_x + w_new * x_new - lambda * w_old * x_old;
-          sum_y = lambda * sum_y + w_new * y_new - lambda * w_old * y_old;
-          sumsq_w = pow(lambda, (long double)2.0) * sumsq_w +
-            pow(w_new, (long double)2.0) - pow(lambda * w_old, (long double)2.0);
+          sum_w.scale(lambda);
+          sum_w.add(w_new);
+          sum_w.add(-(lambda * w_old));
+          sum_x.scale(lambda);
+          sum_x.add(w_new * x_new);
+          sum_x.add(-(lambda * w_old * x_old));
+          sum_y.scale(lambda);
+          sum_y.add(w_new * y_new);
+          sum_y.add(-(lambda * w_old * y_old));
+          sumsq_w.scale(pow(lambda, (value_type)2.0));
+          sumsq_w.add(pow(w_new, (value_type)2.0));
+          sumsq_w.add(-(pow(lambda * w_old, (value_type)2.0)));
           
         } else {
           
-          sum_w = w_new;
-          sum_x = w_new * x_new;
-          sum_y = w_new * y_new;
-          sumsq_w = pow(w_new, (long double)2.0);
+          sum_w.set(w_new);
+          sum_x.set(w_new * x_new);
+          sum_y.set(w_new * y_new);
+          sumsq_w.set(pow(w_new, (value_type)2.0));
           
         }
         
@@ -3491,8 +6772,8 @@ struct RollCovOnlineVecXY {
           // compute the mean
           mean_prev_x = mean_x;
           mean_prev_y = mean_y;
-          mean_x = sum_x / sum_w;
-          mean_y = sum_y / sum_w;
+          mean_x = sum_x.value() / sum_w.value();
+          mean_y = sum_y.value() / sum_w.value();
           
         }
         
@@ -3502,34 +6783,34 @@ struct RollCovOnlineVecXY {
           if (!std::isnan(x[i]) && !std::isnan(y[i]) &&
               !std::isnan(x[i - width]) && !std::isnan(y[i - width])) {
               
-              sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x) -
-              lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-            sumsq_y = lambda * sumsq_y +
-              w_new * (y_new - mean_y) * (y_new - mean_prev_y) -
-              lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+              sumsq_x.scale(lambda);
+              sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+              sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            sumsq_y.scale(lambda);
+            sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
+            sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
             
           } else if (!std::isnan(x[i]) && !std::isnan(y[i]) &&
             (std::isnan(x[i - width]) || std::isnan(y[i - width]))) {
             
-            sumsq_x = lambda * sumsq_x +
-              w_new * (x_new - mean_x) * (x_new - mean_prev_x);
-            sumsq_y = lambda * sumsq_y +
-              w_new * (y_new - mean_y) * (y_new - mean_prev_y);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(w_new * (x_new - mean_x) * (x_new - mean_prev_x));
+            sumsq_y.scale(lambda);
+            sumsq_y.add(w_new * (y_new - mean_y) * (y_new - mean_prev_y));
             
           } else if ((std::isnan(x[i]) || std::isnan(y[i])) &&
             !std::isnan(x[i - width]) && !std::isnan(y[i - width])) {
             
-            sumsq_x = lambda * sumsq_x -
-            lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x);
-            sumsq_y = lambda * sumsq_y -
-              lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y);
+            sumsq_x.scale(lambda);
+            sumsq_x.add(-(lambda * w_old * (x_old - mean_x) * (x_old - mean_prev_x)));
+            sumsq_y.scale(lambda);
+            sumsq_y.add(-(lambda * w_old * (y_old - mean_y) * (y_old - mean_prev_y)));
             
           } else if (std::isnan(x[i]) || std::isnan(y[i]) ||
             std::isnan(x[i - width]) || std::isnan(y[i - width])) {
             
-            sumsq_x = lambda * sumsq_x;
-            sumsq_y = lambda * sumsq_y;
+            sumsq_x.scale(lambda);
+            sumsq_y.scale(lambda);
             
           }
           
@@ -3539,31 +6820,52 @@ struct RollCovOnlineVecXY {
         if (!std::isnan(x[i]) && !std::isnan(y[i]) &&
             !std::isnan(x[i - width]) && !std::isnan(y[i - width])) {
             
-            sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (y_new - mean_prev_y) -
-            lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
+            sumsq_xy.scale(lambda);
+            sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
+            sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
           
         } else if (!std::isnan(x[i]) && !std::isnan(y[i]) &&
           (std::isnan(x[i - width]) || std::isnan(y[i - width]))) {
           
-          sumsq_xy = lambda * sumsq_xy +
-            w_new * (x_new - mean_x) * (y_new - mean_prev_y);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(w_new * (x_new - mean_x) * (y_new - mean_prev_y));
           
         } else if ((std::isnan(x[i]) || std::isnan(y[i])) &&
           !std::isnan(x[i - width]) && !std::isnan(y[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy -
-          lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y);
+          sumsq_xy.scale(lambda);
+          sumsq_xy.add(-(lambda * w_old * (x_old - mean_x) * (y_old - mean_prev_y)));
           
         } else if (std::isnan(x[i]) || std::isnan(y[i]) ||
           std::isnan(x[i - width]) || std::isnan(y[i - width])) {
           
-          sumsq_xy = lambda * sumsq_xy;
+          sumsq_xy.scale(lambda);
           
         }
         
       }
       
+      // recompute the sums of the window every 'reanchor' rows
+      if ((reanchor > 0) && ((i + 1) % reanchor == 0)) {
+        
+        RollReanchor exact(x.begin(), y.begin(), NULL,
+                           std::max(0, i - width + 1), i,
+                           n, arma_weights, center);
+        
+        arma_reanchor[0] = std::max(arma_reanchor[0], (double)std::abs(sumsq_xy.value() - exact.sumsq_xy));
+        
+        sum_w.set(exact.sum_w);
+        sum_x.set(exact.sum_x);
+        sum_y.set(exact.sum_y);
+        sumsq_w.set(exact.sumsq_w);
+        sumsq_x.set(exact.sumsq_x);
+        sumsq_y.set(exact.sumsq_y);
+        sumsq_xy.set(exact.sumsq_xy);
+        mean_x = exact.mean_x;
+        mean_y = exact.mean_y;
+        
+      }
+      
       // don't compute if missing value and 'na_restore' argument is TRUE
       if ((!na_restore) || (na_restore && !std::isnan(x[i]) &&
           !std::isnan(y[i]))) {
@@ -3573,17 +6875,17 @@ struct RollCovOnlineVecXY {
             if (scale) {
               
               // don't compute if the standard deviation is zero
-              if ((sumsq_x < 0) || (sumsq_y < 0) ||
-                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+              if ((sumsq_x.value() < 0) || (sumsq_y.value() < 0) ||
+                  (sqrt(sumsq_x.value()) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y.value()) <= sqrt(arma::datum::eps))) {
                 
                 arma_cov[i] = NA_REAL;
                 
               } else {
-                arma_cov[i] = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+                arma_cov[i] = sumsq_xy.value() / (sqrt(sumsq_x.value()) * sqrt(sumsq_y.value()));
               }
               
             } else if (!scale) {
-              arma_cov[i] = sumsq_xy / (sum_w - sumsq_w / sum_w);
+              arma_cov[i] = sumsq_xy.value() / (sum_w.value() - sumsq_w.value() / sum_w.value());
             }
             
           } else {
@@ -3953,6 +7255,291 @@ struct RollCovOfflineVecXY : public Worker {
   
 };
 
+// 'Worker' function for computing the rolling statistic using prefix sums
+struct RollCovPrefixVecXY : public Worker {
+  
+  const RVector<double> x;       // source
+  const RVector<double> y;       // source
+  const int n;
+  const int n_rows_xy;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const bool scale;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_cov;           // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollCovPrefixVecXY(const NumericVector x, const NumericVector y,
+                     const int n, const int n_rows_xy,
+                     const int n_rows_chunk, const int width,
+                     const arma::vec arma_weights, const bool center,
+                     const bool scale, const int min_obs,
+                     const bool na_restore, arma::vec& arma_cov)
+    : x(x), y(y),
+      n(n), n_rows_xy(n_rows_xy),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      scale(scale), min_obs(min_obs),
+      na_restore(na_restore), arma_cov(arma_cov) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_xy);
+      int offset = std::max(0, begin_row - width);
+      
+      long double w = arma_weights[n - 1];
+      long double x_ref = 0;
+      long double y_ref = 0;
+      bool status_ref = false;
+      long double value[5];
+      long double sum[5];
+      RollPrefixSums prefix(std::min(width, n_rows_xy), 5, offset);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i]) && !std::isnan(y[i])) {
+          
+          // shift by the first finite observations if 'center' argument is TRUE
+          if (center && !status_ref && std::isfinite(x[i]) && std::isfinite(y[i])) {
+            
+            x_ref = x[i];
+            y_ref = y[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = y[i] - y_ref;
+          value[2] = value[0] * value[0];
+          value[3] = value[1] * value[1];
+          value[4] = value[0] * value[1];
+          prefix.push_back(i, value);
+          
+        } else {
+          prefix.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]) &&
+            !std::isnan(y[i]))) {
+          
+          int n_obs = prefix.window(i, i - width, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sum_w = w * n_obs;
+            long double sumsq_w = w * w * n_obs;
+            long double sumsq_x = sum[2];
+            long double sumsq_y = sum[3];
+            long double sumsq_xy = sum[4];
+            
+            if (center) {
+              
+              sumsq_x -= sum[0] * sum[0] / n_obs;
+              sumsq_y -= sum[1] * sum[1] / n_obs;
+              sumsq_xy -= sum[0] * sum[1] / n_obs;
+              
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = w * std::max(sumsq_x, (long double)0);
+            sumsq_y = w * std::max(sumsq_y, (long double)0);
+            sumsq_xy = w * sumsq_xy;
+            
+            if (scale) {
+              
+              // don't compute if the standard deviation is zero
+              if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+                
+                arma_cov[i] = NA_REAL;
+                
+              } else {
+                arma_cov[i] = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+              }
+              
+            } else if (!scale) {
+              arma_cov[i] = sumsq_xy / (sum_w - sumsq_w / sum_w);
+            }
+            
+          } else {
+            arma_cov[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          if (std::isnan(x[i])) {
+            arma_cov[i] = x[i];
+          } else {
+            arma_cov[i] = y[i];
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
+// 'Worker' function for computing the rolling statistic using linear decay weights
+struct RollCovLinearVecXY : public Worker {
+  
+  const RVector<double> x;       // source
+  const RVector<double> y;       // source
+  const int n;
+  const int n_rows_xy;
+  const int n_rows_chunk;
+  const int width;
+  const arma::vec arma_weights;
+  const bool center;
+  const bool scale;
+  const int min_obs;
+  const bool na_restore;
+  arma::vec& arma_cov;           // destination (pass by reference)
+  
+  // initialize with source and destination
+  RollCovLinearVecXY(const NumericVector x, const NumericVector y,
+                     const int n, const int n_rows_xy,
+                     const int n_rows_chunk, const int width,
+                     const arma::vec arma_weights, const bool center,
+                     const bool scale, const int min_obs,
+                     const bool na_restore, arma::vec& arma_cov)
+    : x(x), y(y),
+      n(n), n_rows_xy(n_rows_xy),
+      n_rows_chunk(n_rows_chunk), width(width),
+      arma_weights(arma_weights), center(center),
+      scale(scale), min_obs(min_obs),
+      na_restore(na_restore), arma_cov(arma_cov) { }
+  
+  // function call operator that iterates by chunk of rows
+  void operator()(std::size_t begin_index, std::size_t end_index) {
+    for (std::size_t z = begin_index; z < end_index; z++) {
+      
+      // each chunk is warmed up on the previous 'width' rows
+      int begin_row = z * n_rows_chunk;
+      int end_row = std::min(begin_row + n_rows_chunk, n_rows_xy);
+      int offset = std::max(0, begin_row - width);
+      
+      // weights decrease by 'delta' for each row (check already passed)
+      long double delta = arma_weights[n - 1] - arma_weights[n - 2];
+      long double x_ref = 0;
+      long double y_ref = 0;
+      bool status_ref = false;
+      long double value[5];
+      long double sum[5];
+      RollLinearSums linear(width, std::min(width, n_rows_xy), 5, offset,
+                            arma_weights[n - 1], delta);
+      
+      for (int i = offset; i < end_row; i++) {
+        
+        // don't include if missing value
+        if (!std::isnan(x[i]) && !std::isnan(y[i])) {
+          
+          // shift by the first observations if 'center' argument is TRUE
+          if (center && !status_ref) {
+            
+            x_ref = x[i];
+            y_ref = y[i];
+            status_ref = true;
+            
+          }
+          
+          value[0] = x[i] - x_ref;
+          value[1] = y[i] - y_ref;
+          value[2] = value[0] * value[0];
+          value[3] = value[1] * value[1];
+          value[4] = value[0] * value[1];
+          linear.push_back(i, value);
+          
+        } else {
+          linear.push_back(i, NULL);
+        }
+        
+        // warm-up rows are computed by the previous chunk
+        if (i < begin_row) {
+          continue;
+        }
+        
+        // don't compute if missing value
+        if ((!na_restore) || (na_restore && !std::isnan(x[i]) &&
+            !std::isnan(y[i]))) {
+          
+          long double sum_w = 0;
+          long double sumsq_w = 0;
+          int n_obs = linear.window(sum_w, sumsq_w, sum);
+          
+          if ((n_obs > 1) && (n_obs >= min_obs)) {
+            
+            long double sumsq_x = sum[2];
+            long double sumsq_y = sum[3];
+            long double sumsq_xy = sum[4];
+            
+            if (center) {
+              
+              sumsq_x -= sum[0] * sum[0] / sum_w;
+              sumsq_y -= sum[1] * sum[1] / sum_w;
+              sumsq_xy -= sum[0] * sum[1] / sum_w;
+              
+            }
+            
+            // sum of squares is at least zero (i.e., round-off)
+            sumsq_x = std::max(sumsq_x, (long double)0);
+            sumsq_y = std::max(sumsq_y, (long double)0);
+                        
+            if (scale) {
+              
+              // don't compute if the standard deviation is zero
+              if ((sumsq_x < 0) || (sumsq_y < 0) ||
+                  (sqrt(sumsq_x) <= sqrt(arma::datum::eps)) || (sqrt(sumsq_y) <= sqrt(arma::datum::eps))) {
+                
+                arma_cov[i] = NA_REAL;
+                
+              } else {
+                arma_cov[i] = sumsq_xy / (sqrt(sumsq_x) * sqrt(sumsq_y));
+              }
+              
+            } else if (!scale) {
+              arma_cov[i] = sumsq_xy / (sum_w - sumsq_w / sum_w);
+            }
+            
+          } else {
+            arma_cov[i] = NA_REAL;
+          }
+          
+        } else {
+          
+          // can be either NA or NaN
+          if (std::isnan(x[i])) {
+            arma_cov[i] = x[i];
+          } else {
+            arma_cov[i] = y[i];
+          }
+          
+        }
+        
+      }
+      
+    }
+  }
+  
+};
+
 // 'Worker' function for computing the rolling statistic using an online algorithm
 struct RollCrossProdOnlineVecXX {
   
@@ -45,8 +45,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // roll_sum
-SEXP roll_sum(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_sum(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_sum(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& reanchor, const std::string& precision);
+RcppExport SEXP _roll_roll_sum(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP reanchorSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -57,7 +57,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_sum(x, width, weights, min_obs, complete_obs, na_restore, online));
+    Rcpp::traits::input_parameter< const int& >::type reanchor(reanchorSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_sum(x, width, weights, min_obs, complete_obs, na_restore, online, reanchor, precision));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -79,8 +81,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // roll_mean
-SEXP roll_mean(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_mean(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_mean(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& reanchor, const std::string& precision);
+RcppExport SEXP _roll_roll_mean(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP reanchorSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -91,7 +93,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_mean(x, width, weights, min_obs, complete_obs, na_restore, online));
+    Rcpp::traits::input_parameter< const int& >::type reanchor(reanchorSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_mean(x, width, weights, min_obs, complete_obs, na_restore, online, reanchor, precision));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -114,8 +118,101 @@ BEGIN_RCPP
 END_RCPP
 }
 // roll_quantile
-SEXP roll_quantile(const SEXP& x, const int& width, const arma::vec& weights, const double& p, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_quantile(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP pSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_quantile(const SEXP& x, const int& width, const arma::vec& weights, const arma::vec& p, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const double& error);
+RcppExport SEXP _roll_roll_quantile(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP pSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP errorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type p(pSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    Rcpp::traits::input_parameter< const double& >::type error(errorSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_quantile(x, width, weights, p, min_obs, complete_obs, na_restore, online, error));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_quantile_sorted
+SEXP roll_quantile_sorted(const SEXP& x, const int& width, const arma::vec& weights, const arma::vec& p, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& n_sorted);
+RcppExport SEXP _roll_roll_quantile_sorted(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP pSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP n_sortedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type p(pSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    Rcpp::traits::input_parameter< const int& >::type n_sorted(n_sortedSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_quantile_sorted(x, width, weights, p, min_obs, complete_obs, na_restore, online, n_sorted));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_range
+SEXP roll_range(const SEXP& x, const int& width, const arma::vec& weights, const std::vector<std::string>& type, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_range(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP typeSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_range(x, width, weights, type, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_drawdown
+SEXP roll_drawdown(const SEXP& x, const int& width, const arma::vec& weights, const bool& runup, const bool& index, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_drawdown(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP runupSEXP, SEXP indexSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type runup(runupSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_drawdown(x, width, weights, runup, index, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_mad
+SEXP roll_mad(const SEXP& x, const int& width, const arma::vec& weights, const double& threshold, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_mad(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP thresholdSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const double& >::type threshold(thresholdSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_mad(x, width, weights, threshold, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_es
+SEXP roll_es(const SEXP& x, const int& width, const arma::vec& weights, const double& p, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_es(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP pSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -127,13 +224,50 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_quantile(x, width, weights, p, min_obs, complete_obs, na_restore, online));
+    rcpp_result_gen = Rcpp::wrap(roll_es(x, width, weights, p, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_trimmean
+SEXP roll_trimmean(const SEXP& x, const int& width, const arma::vec& weights, const double& trim, const bool& winsorize, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_trimmean(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP trimSEXP, SEXP winsorizeSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const double& >::type trim(trimSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type winsorize(winsorizeSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_trimmean(x, width, weights, trim, winsorize, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_rank
+SEXP roll_rank(const SEXP& x, const int& width, const arma::vec& weights, const std::string& ties, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_rank(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP tiesSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type ties(tiesSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_rank(x, width, weights, ties, min_obs, complete_obs, na_restore, online));
     return rcpp_result_gen;
 END_RCPP
 }
 // roll_var
-SEXP roll_var(const SEXP& x, const int& width, const arma::vec& weights, const bool& center, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_var(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_var(const SEXP& x, const int& width, const arma::vec& weights, const bool& center, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& reanchor, const std::string& precision);
+RcppExport SEXP _roll_roll_var(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP reanchorSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -145,13 +279,15 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_var(x, width, weights, center, min_obs, complete_obs, na_restore, online));
+    Rcpp::traits::input_parameter< const int& >::type reanchor(reanchorSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_var(x, width, weights, center, min_obs, complete_obs, na_restore, online, reanchor, precision));
     return rcpp_result_gen;
 END_RCPP
 }
 // roll_sd
-SEXP roll_sd(const SEXP& x, const int& width, const arma::vec& weights, const bool& center, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_sd(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_sd(const SEXP& x, const int& width, const arma::vec& weights, const bool& center, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& reanchor, const std::string& precision);
+RcppExport SEXP _roll_roll_sd(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP reanchorSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -163,7 +299,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_sd(x, width, weights, center, min_obs, complete_obs, na_restore, online));
+    Rcpp::traits::input_parameter< const int& >::type reanchor(reanchorSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_sd(x, width, weights, center, min_obs, complete_obs, na_restore, online, reanchor, precision));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -187,8 +325,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // roll_cov
-SEXP roll_cov(const SEXP& x, const SEXP& y, const int& width, const arma::vec& weights, const bool& center, const bool& scale, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
-RcppExport SEXP _roll_roll_cov(SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP scaleSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+SEXP roll_cov(const SEXP& x, const SEXP& y, const int& width, const arma::vec& weights, const bool& center, const bool& scale, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online, const int& reanchor, const std::string& precision);
+RcppExport SEXP _roll_roll_cov(SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP scaleSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP, SEXP reanchorSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -202,7 +340,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
     Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
     Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
-    rcpp_result_gen = Rcpp::wrap(roll_cov(x, y, width, weights, center, scale, min_obs, complete_obs, na_restore, online));
+    Rcpp::traits::input_parameter< const int& >::type reanchor(reanchorSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_cov(x, y, width, weights, center, scale, min_obs, complete_obs, na_restore, online, reanchor, precision));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -245,3 +385,104 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// roll_state_init
+SEXP roll_state_init(const SEXP& x, const SEXP& y, const std::string& type, const int& width, const arma::vec& weights, const bool& center, const bool& scale, const bool& intercept, const int& min_obs, const bool& complete_obs, const bool& na_restore);
+RcppExport SEXP _roll_roll_state_init(SEXP xSEXP, SEXP ySEXP, SEXP typeSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP centerSEXP, SEXP scaleSEXP, SEXP interceptSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const SEXP& >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type center(centerSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type scale(scaleSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_state_init(x, y, type, width, weights, center, scale, intercept, min_obs, complete_obs, na_restore));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_update
+SEXP roll_update(const SEXP& state, const SEXP& x, const SEXP& y);
+RcppExport SEXP _roll_roll_update(SEXP stateSEXP, SEXP xSEXP, SEXP ySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type state(stateSEXP);
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const SEXP& >::type y(ySEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_update(state, x, y));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_state_save
+RawVector roll_state_save(const SEXP& state);
+RcppExport SEXP _roll_roll_state_save(SEXP stateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type state(stateSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_state_save(state));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_state_load
+SEXP roll_state_load(const RawVector& x);
+RcppExport SEXP _roll_roll_state_load(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const RawVector& >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_state_load(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_state_merge
+SEXP roll_state_merge(const List& states);
+RcppExport SEXP _roll_roll_state_merge(SEXP statesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const List& >::type states(statesSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_state_merge(states));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_kernel_sum
+SEXP roll_kernel_sum(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_kernel_sum(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_kernel_sum(x, width, weights, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
+// roll_kernel_max
+SEXP roll_kernel_max(const SEXP& x, const int& width, const arma::vec& weights, const int& min_obs, const bool& complete_obs, const bool& na_restore, const bool& online);
+RcppExport SEXP _roll_roll_kernel_max(SEXP xSEXP, SEXP widthSEXP, SEXP weightsSEXP, SEXP min_obsSEXP, SEXP complete_obsSEXP, SEXP na_restoreSEXP, SEXP onlineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const SEXP& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int& >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const int& >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type complete_obs(complete_obsSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type na_restore(na_restoreSEXP);
+    Rcpp::traits::input_parameter< const bool& >::type online(onlineSEXP);
+    rcpp_result_gen = Rcpp::wrap(roll_kernel_max(x, width, weights, min_obs, complete_obs, na_restore, online));
+    return rcpp_result_gen;
+END_RCPP
+}
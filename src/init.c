@@ -10,32 +10,60 @@
 /* .Call calls */
 extern SEXP _roll_roll_all(void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_any(void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_cov(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_cov(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_crossprod(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_drawdown(void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_es(void *, void *, void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_idxquantile(void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_kernel_max(void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_kernel_sum(void *, void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_lm(void *, void *, void *, void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_mean(void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_mad(void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_mean(void *, void *, void *, void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_prod(void *, void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_quantile(void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_quantile(void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_quantile_sorted(void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_range(void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_rank(void *, void *, void *, void *, void *, void *, void *, void *);
 extern SEXP _roll_roll_scale(void *, void *, void *, void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_sd(void *, void *, void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_sum(void *, void *, void *, void *, void *, void *, void *);
-extern SEXP _roll_roll_var(void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_sd(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_state_init(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_state_load(void *);
+extern SEXP _roll_roll_state_merge(void *);
+extern SEXP _roll_roll_state_save(void *);
+extern SEXP _roll_roll_sum(void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_trimmean(void *, void *, void *, void *, void *, void *, void *, void *, void *);
+extern SEXP _roll_roll_update(void *, void *, void *);
+extern SEXP _roll_roll_var(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
 
 static const R_CallMethodDef CallEntries[] = {
-  {"_roll_roll_all",         (DL_FUNC) &_roll_roll_all,          6},
-  {"_roll_roll_any",         (DL_FUNC) &_roll_roll_any,          6},
-  {"_roll_roll_cov",         (DL_FUNC) &_roll_roll_cov,         10},
-  {"_roll_roll_crossprod",   (DL_FUNC) &_roll_roll_crossprod,   10},
-  {"_roll_roll_idxquantile", (DL_FUNC) &_roll_roll_idxquantile,  8},
-  {"_roll_roll_lm",          (DL_FUNC) &_roll_roll_lm,           9},
-  {"_roll_roll_mean",        (DL_FUNC) &_roll_roll_mean,         7},
-  {"_roll_roll_prod",        (DL_FUNC) &_roll_roll_prod,         7},
-  {"_roll_roll_quantile",    (DL_FUNC) &_roll_roll_quantile,     8},
-  {"_roll_roll_scale",       (DL_FUNC) &_roll_roll_scale,        9},
-  {"_roll_roll_sd",          (DL_FUNC) &_roll_roll_sd,           8},
-  {"_roll_roll_sum",         (DL_FUNC) &_roll_roll_sum,          7},
-  {"_roll_roll_var",         (DL_FUNC) &_roll_roll_var,          8},
+  {"_roll_roll_all",             (DL_FUNC) &_roll_roll_all,             6},
+  {"_roll_roll_any",             (DL_FUNC) &_roll_roll_any,             6},
+  {"_roll_roll_cov",             (DL_FUNC) &_roll_roll_cov,            12},
+  {"_roll_roll_crossprod",       (DL_FUNC) &_roll_roll_crossprod,      10},
+  {"_roll_roll_drawdown",        (DL_FUNC) &_roll_roll_drawdown,        9},
+  {"_roll_roll_es",              (DL_FUNC) &_roll_roll_es,              8},
+  {"_roll_roll_idxquantile",     (DL_FUNC) &_roll_roll_idxquantile,     8},
+  {"_roll_roll_kernel_max",      (DL_FUNC) &_roll_roll_kernel_max,      7},
+  {"_roll_roll_kernel_sum",      (DL_FUNC) &_roll_roll_kernel_sum,      7},
+  {"_roll_roll_lm",              (DL_FUNC) &_roll_roll_lm,              9},
+  {"_roll_roll_mad",             (DL_FUNC) &_roll_roll_mad,             8},
+  {"_roll_roll_mean",            (DL_FUNC) &_roll_roll_mean,            9},
+  {"_roll_roll_prod",            (DL_FUNC) &_roll_roll_prod,            7},
+  {"_roll_roll_quantile",        (DL_FUNC) &_roll_roll_quantile,        9},
+  {"_roll_roll_quantile_sorted", (DL_FUNC) &_roll_roll_quantile_sorted, 9},
+  {"_roll_roll_range",           (DL_FUNC) &_roll_roll_range,           8},
+  {"_roll_roll_rank",            (DL_FUNC) &_roll_roll_rank,            8},
+  {"_roll_roll_scale",           (DL_FUNC) &_roll_roll_scale,           9},
+  {"_roll_roll_sd",              (DL_FUNC) &_roll_roll_sd,             10},
+  {"_roll_roll_state_init",      (DL_FUNC) &_roll_roll_state_init,     11},
+  {"_roll_roll_state_load",      (DL_FUNC) &_roll_roll_state_load,      1},
+  {"_roll_roll_state_merge",     (DL_FUNC) &_roll_roll_state_merge,     1},
+  {"_roll_roll_state_save",      (DL_FUNC) &_roll_roll_state_save,      1},
+  {"_roll_roll_sum",             (DL_FUNC) &_roll_roll_sum,             9},
+  {"_roll_roll_trimmean",        (DL_FUNC) &_roll_roll_trimmean,        9},
+  {"_roll_roll_update",          (DL_FUNC) &_roll_roll_update,          3},
+  {"_roll_roll_var",             (DL_FUNC) &_roll_roll_var,            10},
   {NULL, NULL, 0}
 };
 
@@ -1,4 +1,12 @@
 #include "roll.h"
+#include <thread>
+
+using roll::check_width;
+using roll::check_weights_x;
+using roll::check_lambda;
+using roll::check_linear;
+using roll::check_min_obs;
+using roll::any_na_x;
 
 void check_p(const double& p) {
   
@@ -8,10 +16,100 @@ void check_p(const double& p) {
   
 }
 
-void check_width(const int& width) {
+void check_p(const arma::vec& p) {
+  
+  int n_p = p.size();
+  
+  if (n_p < 1) {
+    stop("length of 'p' must be greater than zero");
+  }
+  
+  for (int l = 0; l < n_p; l++) {
+    check_p(p[l]);
+  }
+  
+}
+
+void check_error(const double& error) {
+  
+  if ((error < 0) || (error >= 1)) {
+    stop("value of 'error' must be greater than or equal to zero and less than one");
+  }
+  
+}
+
+void check_threshold(const double& threshold) {
+  
+  if (threshold < 0) {
+    stop("value of 'threshold' must be greater than or equal to zero");
+  }
+  
+}
+
+void check_reanchor(const int& reanchor, const bool& status_lin) {
+  
+  if (reanchor < 0) {
+    stop("value of 'reanchor' must be greater than or equal to zero");
+  }
+  
+  // linear decay weights are not re-anchored (i.e., no "reanchor" attribute)
+  if ((reanchor > 0) && status_lin) {
+    warning("'reanchor' is only supported for equal or exponential decay 'weights'");
+  }
+  
+}
+
+int check_precision(const std::string& precision) {
+  
+  int result = 0;
+  
+  if (precision == "compensated") {
+    result = 1;
+  } else if (precision == "double") {
+    result = 2;
+  } else if (precision != "long double") {
+    stop("value of 'precision' must be \"long double\", \"compensated\", or \"double\"");
+  }
+  
+  return result;
+  
+}
+
+void check_trim(const double& trim) {
+  
+  if ((trim < 0) || (trim > 0.5)) {
+    stop("value of 'trim' must be between zero and 0.5");
+  }
+  
+}
+
+double check_ties(const std::string& ties) {
+  
+  double result = 0.5;
+  
+  if (ties == "min") {
+    result = 0;
+  } else if (ties == "max") {
+    result = 1;
+  } else if (ties != "average") {
+    stop("value of 'ties' must be \"average\", \"min\", or \"max\"");
+  }
+  
+  return result;
+  
+}
+
+void check_type(const std::vector<std::string>& type) {
+  
+  if (type.size() == 0) {
+    stop("length of 'type' must be greater than zero");
+  }
   
-  if (width < 1) {
-    stop("value of 'width' must be greater than zero");
+  for (std::size_t k = 0; k < type.size(); k++) {
+    if ((type[k] != "min") && (type[k] != "max") &&
+        (type[k] != "idxmin") && (type[k] != "idxmax")) {
+      stop("values of 'type' must be \"min\", \"max\", \"idxmin\", or \"idxmax\"");
+    }
   }
   
 }
@@ -38,15 +136,6 @@ void check_weights_p(const arma::vec& weights) {
   
 }
 
-void check_weights_x(const int& n_rows_x, const int& width,
-                     const arma::vec& weights) {
-  
-  if ((int)weights.size() < std::min(width, n_rows_x)) {
-    stop("length of 'weights' must equal either the number of rows in 'x' or 'width'");
-  }
-  
-}
-
 void check_weights_xy(const int& n_rows_xy, const int& width,
                       const arma::vec& weights) {
   
@@ -65,57 +154,111 @@ void check_weights_lm(const int& n_rows_xy, const int& width,
   
 }
 
-bool check_lambda(const arma::vec& weights, const int& n_rows_x,
-                  const int& width, const bool& online) {
+// number of threads (see RcppParallel::setThreadOptions)
+double num_threads() {
   
-  // check if equal-weights
-  bool status_eq = all(weights == weights[0]);
-  bool status_exp = true;
+  double n_threads = std::thread::hardware_concurrency();
+  const char* env_threads = std::getenv("RCPP_PARALLEL_NUM_THREADS");
   
-  // check if exponential-weights
-  if (!status_eq) {
-    
-    int i = 0;
-    int n = weights.size();
-    long double lambda = 0;
-    long double lambda_prev = 0;
-    
-    // check if constant ratio
-    while (status_exp && (i <= (n - 2))) {
-      
-      // ratio of weights
-      lambda_prev = lambda;
-      lambda = weights[n - i - 2] / weights[n - i - 1];
-      
-      // tolerance for consistency with R's all.equal
-      if (((i > 0) && (std::abs(lambda - lambda_prev) > sqrt(arma::datum::eps))) ||
-          ((weights[n - i - 2] > weights[n - i - 1]) && (width < n_rows_x)) ||
-          (std::isnan(lambda) || (std::isinf(lambda)))) {
-        
-        status_exp = false;
-        
-      }
-      
-      i += 1;
-      
-    }
-    
+  if (env_threads != NULL) {
+    n_threads = std::atoi(env_threads);
+  }
+  
+  return std::max(1.0, n_threads);
+  
+}
+
+// cost model of the sorted window by width, where the sorted window moves half
+// of the window for each row (i.e., parallel by column) and is compared with
+// either the order-statistic tree if 'online' or sort of each window (i.e.,
+// O(width * log(width)) for each row and parallel by row and column), unless
+// 'n_sorted' is the maximum width of the sorted window (e.g., in the tests)
+bool check_sorted(const int& width, const int& n_rows_x, const int& n_cols_x,
+                  const bool& status_eq, const bool& online,
+                  const int& n_sorted) {
+  
+  double n_size_x = std::min(width, n_rows_x);
+  
+  if (n_sorted >= 0) {
+    return n_size_x <= n_sorted;
+  }
+  
+  // order-statistic tree is O(log(n)) and faster for large widths
+  if (online) {
+    return n_size_x <= 512;
+  }
+  
+  double n_threads = num_threads();
+  
+  // approximate cost for each row in nanoseconds, where 'weights' other than
+  // equal require a pass through the sorted window
+  double cost_sorted = (status_eq ? 0.5 : 3) * n_size_x + 75;
+  double cost_sort = 9 * n_size_x * std::log2(n_size_x + 1) + 150;
+  
+  return cost_sorted * std::ceil(n_cols_x / n_threads) <= cost_sort * n_cols_x / n_threads;
+  
+}
+
+// rows in each chunk of the online algorithms, where the chunks of a column
+// are in parallel if there are fewer columns than threads and each chunk is
+// warmed up on the previous 'width' rows (i.e., at most a quarter of a chunk),
+// otherwise all rows are in one chunk
+int check_chunk(const int& width, const int& n_rows_x, const int& n_cols_x) {
+  
+  double n_threads = num_threads();
+  
+  if (n_cols_x >= n_threads) {
+    return std::max(1, n_rows_x);
+  }
+  
+  double n_chunks = std::floor(n_threads / std::max(1, n_cols_x));
+  double n_rows_chunk = std::ceil(n_rows_x / n_chunks);
+  
+  // minimum rows in each chunk for the overhead of a thread
+  n_rows_chunk = std::max(n_rows_chunk, std::max(4.0 * width, 32768.0));
+  
+  return std::max(1.0, std::min(n_rows_chunk, (double)n_rows_x));
+  
+}
+
+// size of the fast Fourier transform for arbitrary weights (i.e., a power of
+// two that is at least four times the width or all rows), otherwise 0 if the
+// sum of 'width' products for each row is faster (e.g., a small width), where
+// blocks of rows that are not finite or have a large dynamic range also use
+// the sum of 'width' products (see 'convolve_block')
+int check_fft(const int& width, const int& n_rows_x) {
+  
+  int n_size_x = std::min(width, n_rows_x);
+  int n_fft = 1;
+  
+  while ((n_fft < 4 * n_size_x) && (n_fft < n_rows_x + n_size_x - 1)) {
+    n_fft *= 2;
   }
   
-  if (!status_exp && online) {
-    warning("'online' is only supported for equal or exponential decay 'weights'");
+  // cost of the forward and inverse transforms for each row of a block
+  double n_step = std::min(n_fft - n_size_x + 1, n_rows_x);
+  double n_cost = 2 * 5 * n_fft * std::log2((double)n_fft) / n_step;
+  
+  if (n_cost < n_size_x) {
+    return n_fft;
   }
   
-  return status_exp;
+  return 0;
   
 }
 
-void check_min_obs(const int& min_obs) {
+// maximum correction of each column from the re-anchored chunks of rows,
+// i.e., 'arma_reanchor' is by column and chunk as in the online algorithms
+NumericVector reanchor_x(const arma::vec& arma_reanchor, const int& n_cols_x) {
+  
+  NumericVector result(n_cols_x);
   
-  if (min_obs < 1) {
-    stop("value of 'min_obs' must be greater than zero");
+  for (unsigned int z = 0; z < arma_reanchor.size(); z++) {
+    result[z % n_cols_x] = std::max(result[z % n_cols_x], arma_reanchor[z]);
   }
   
+  return result;
+  
 }
 
 void check_lm(const int& n_rows_x, const int& n_rows_y) {
@@ -197,25 +340,17 @@ CharacterVector dimnames_lm_y(const List& input, const int& n_cols_y) {
   
 }
 
-IntegerVector any_na_i(const IntegerMatrix& x) {
+CharacterVector names_p(const arma::vec& p) {
   
-  int n_rows_x = x.nrow();
-  int n_cols_x = x.ncol();
-  IntegerVector result(n_rows_x);
+  int n_p = p.size();
+  CharacterVector result(n_p);
   
-  for (int i = 0; i < n_rows_x; i++) {
-    
-    int any_na = 0;
-    int j = 0;
-    
-    while ((any_na == 0) && (j < n_cols_x)) {
-      if (x(i, j) == NA_INTEGER) {
-        any_na = 1;
-      }
-      j += 1;
-    }
+  // similar to R's names of quantile
+  for (int l = 0; l < n_p; l++) {
     
-    result[i] = any_na;
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.7g%%", 100 * p[l]);
+    result[l] = buffer;
     
   }
   
@@ -223,11 +358,11 @@ IntegerVector any_na_i(const IntegerMatrix& x) {
   
 }
 
-arma::uvec any_na_x(const NumericMatrix& x) {
+IntegerVector any_na_i(const IntegerMatrix& x) {
   
   int n_rows_x = x.nrow();
   int n_cols_x = x.ncol();
-  arma::uvec result(n_rows_x);
+  IntegerVector result(n_rows_x);
   
   for (int i = 0; i < n_rows_x; i++) {
     
@@ -235,7 +370,7 @@ arma::uvec any_na_x(const NumericMatrix& x) {
     int j = 0;
     
     while ((any_na == 0) && (j < n_cols_x)) {
-      if (std::isnan(x(i, j))) {
+      if (x(i, j) == NA_INTEGER) {
         any_na = 1;
       }
       j += 1;
@@ -514,7 +649,8 @@ SEXP roll_all(const SEXP& x, const int& width,
 SEXP roll_sum(const SEXP& x, const int& width,
               const arma::vec& weights, const int& min_obs,
               const bool& complete_obs, const bool& na_restore,
-              const bool& online) {
+              const bool& online, const int& reanchor,
+              const std::string& precision) {
   
   if (Rf_isMatrix(x)) {
     
@@ -524,6 +660,7 @@ SEXP roll_sum(const SEXP& x, const int& width,
     int n_cols_x = xx.ncol();
     arma::uvec arma_any_na(n_rows_x);
     arma::mat arma_sum(n_rows_x, n_cols_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -531,12 +668,23 @@ SEXP roll_sum(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
+    int n_fft = check_fft(width, n_rows_x);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'false',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -546,21 +694,110 @@ SEXP roll_sum(const SEXP& x, const int& width,
     }
     
     // compute rolling sums
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollSumOnlineMat roll_sum_online(xx, n, n_rows_x, n_cols_x, width,
-                                             weights, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSumLinearMat roll_sum_linear(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                             width, weights, min_obs,
+                                             arma_any_na, na_restore,
+                                             arma_sum);
+      parallelFor(0, n_cols_x * n_chunks, roll_sum_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_cols_x * n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollSumOnlineMat<roll::RollAccumCompensated> roll_sum_online(xx, n, n_rows_x,
+                                                                           n_cols_x, n_rows_chunk,
+                                                                           width, weights, min_obs,
+                                                                           arma_any_na, na_restore,
+                                                                           reanchor, arma_sum,
+                                                                           arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sum_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSumOnlineMat<roll::RollAccumDouble> roll_sum_online(xx, n, n_rows_x, n_cols_x,
+                                                                      n_rows_chunk, width, weights,
+                                                                      min_obs, arma_any_na,
+                                                                      na_restore, reanchor,
+                                                                      arma_sum, arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sum_online);
+        
+      } else {
+        
+        roll::RollSumOnlineMat<roll::RollAccumLongDouble> roll_sum_online(xx, n, n_rows_x, n_cols_x,
+                                                                          n_rows_chunk, width,
+                                                                          weights, min_obs,
+                                                                          arma_any_na, na_restore,
+                                                                          reanchor, arma_sum,
+                                                                          arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sum_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSumPrefixMat roll_sum_prefix(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                             width, weights, min_obs,
                                              arma_any_na, na_restore,
                                              arma_sum);
-      parallelFor(0, n_cols_x, roll_sum_online);
+      parallelFor(0, n_cols_x * n_chunks, roll_sum_prefix);
+      
+    } else if (n_fft > 0) {
+      
+      // blocks of rows that overlap by 'width' - 1 rows
+      int n_step = n_fft - std::min(width, n_rows_x) + 1;
+      int n_blocks = std::ceil((double)n_rows_x / n_step);
+      
+      roll::RollSumFFTMat roll_sum_fft(xx, n, n_rows_x, n_cols_x, n_fft,
+                                       width, weights, min_obs,
+                                       arma_any_na, na_restore,
+                                       arma_sum);
+      parallelFor(0, n_cols_x * n_blocks, roll_sum_fft);
       
     } else {
       
-      roll::RollSumOfflineMat roll_sum_offline(xx, n, n_rows_x, n_cols_x, width,
-                                               weights, min_obs,
-                                               arma_any_na, na_restore,
-                                               arma_sum);
-      parallelFor(0, n_rows_x * n_cols_x, roll_sum_offline);
+      if (precision_x == 1) {
+        
+        roll::RollSumOfflineMat<roll::RollAccumCompensated> roll_sum_offline(xx, n, n_rows_x,
+                                                                             n_cols_x, width,
+                                                                             weights, min_obs,
+                                                                             arma_any_na,
+                                                                             na_restore, arma_sum);
+        parallelFor(0, n_rows_x * n_cols_x, roll_sum_offline);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSumOfflineMat<roll::RollAccumDouble> roll_sum_offline(xx, n, n_rows_x, n_cols_x,
+                                                                        width, weights, min_obs,
+                                                                        arma_any_na, na_restore,
+                                                                        arma_sum);
+        parallelFor(0, n_rows_x * n_cols_x, roll_sum_offline);
+        
+      } else {
+        
+        roll::RollSumOfflineMat<roll::RollAccumLongDouble> roll_sum_offline(xx, n, n_rows_x,
+                                                                            n_cols_x, width,
+                                                                            weights, min_obs,
+                                                                            arma_any_na, na_restore,
+                                                                            arma_sum);
+        parallelFor(0, n_rows_x * n_cols_x, roll_sum_offline);
+        
+      }
       
     }
     
@@ -575,6 +812,11 @@ SEXP roll_sum(const SEXP& x, const int& width,
     result.attr("tzone") = xx.attr("tzone");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums of each column
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, n_cols_x);
+    }
+    
     return result;
     
   } else {
@@ -583,6 +825,7 @@ SEXP roll_sum(const SEXP& x, const int& width,
     int n = weights.size();
     int n_rows_x = xx.size();
     arma::vec arma_sum(n_rows_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -590,28 +833,120 @@ SEXP roll_sum(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
+    int n_fft = check_fft(width, n_rows_x);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // compute rolling sums
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollSumOnlineVec roll_sum_online(xx, n, n_rows_x, width,
-                                             weights, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSumLinearVec roll_sum_linear(xx, n, n_rows_x, n_rows_chunk,
+                                             width, weights, min_obs,
+                                             na_restore,
+                                             arma_sum);
+      parallelFor(0, n_chunks, roll_sum_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollSumOnlineVec<roll::RollAccumCompensated> roll_sum_online(xx, n, n_rows_x,
+                                                                           n_rows_chunk, width,
+                                                                           weights, min_obs,
+                                                                           na_restore, reanchor,
+                                                                           arma_sum, arma_reanchor);
+        parallelFor(0, n_chunks, roll_sum_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSumOnlineVec<roll::RollAccumDouble> roll_sum_online(xx, n, n_rows_x, n_rows_chunk,
+                                                                      width, weights, min_obs,
+                                                                      na_restore, reanchor,
+                                                                      arma_sum, arma_reanchor);
+        parallelFor(0, n_chunks, roll_sum_online);
+        
+      } else {
+        
+        roll::RollSumOnlineVec<roll::RollAccumLongDouble> roll_sum_online(xx, n, n_rows_x,
+                                                                          n_rows_chunk, width,
+                                                                          weights, min_obs,
+                                                                          na_restore, reanchor,
+                                                                          arma_sum, arma_reanchor);
+        parallelFor(0, n_chunks, roll_sum_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSumPrefixVec roll_sum_prefix(xx, n, n_rows_x, n_rows_chunk,
+                                             width, weights, min_obs,
                                              na_restore,
                                              arma_sum);
-      roll_sum_online();
+      parallelFor(0, n_chunks, roll_sum_prefix);
+      
+    } else if (n_fft > 0) {
+      
+      // blocks of rows that overlap by 'width' - 1 rows
+      int n_step = n_fft - std::min(width, n_rows_x) + 1;
+      int n_blocks = std::ceil((double)n_rows_x / n_step);
+      
+      roll::RollSumFFTVec roll_sum_fft(xx, n, n_rows_x, n_fft,
+                                       width, weights, min_obs,
+                                       na_restore,
+                                       arma_sum);
+      parallelFor(0, n_blocks, roll_sum_fft);
       
     } else {
       
-      roll::RollSumOfflineVec roll_sum_offline(xx, n, n_rows_x, width,
-                                               weights, min_obs,
-                                               na_restore,
-                                               arma_sum);
-      parallelFor(0, n_rows_x, roll_sum_offline);
+      if (precision_x == 1) {
+        
+        roll::RollSumOfflineVec<roll::RollAccumCompensated> roll_sum_offline(xx, n, n_rows_x, width,
+                                                                             weights, min_obs,
+                                                                             na_restore, arma_sum);
+        parallelFor(0, n_rows_x, roll_sum_offline);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSumOfflineVec<roll::RollAccumDouble> roll_sum_offline(xx, n, n_rows_x, width,
+                                                                        weights, min_obs,
+                                                                        na_restore, arma_sum);
+        parallelFor(0, n_rows_x, roll_sum_offline);
+        
+      } else {
+        
+        roll::RollSumOfflineVec<roll::RollAccumLongDouble> roll_sum_offline(xx, n, n_rows_x, width,
+                                                                            weights, min_obs,
+                                                                            na_restore, arma_sum);
+        parallelFor(0, n_rows_x, roll_sum_offline);
+        
+      }
       
     }
     
@@ -625,6 +960,11 @@ SEXP roll_sum(const SEXP& x, const int& width,
     result.attr("index") = xx.attr("index");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, 1);
+    }
+    
     return result;
     
   }
@@ -756,7 +1096,8 @@ SEXP roll_prod(const SEXP& x, const int& width,
 SEXP roll_mean(const SEXP& x, const int& width,
                const arma::vec& weights, const int& min_obs,
                const bool& complete_obs, const bool& na_restore,
-               const bool& online) {
+               const bool& online, const int& reanchor,
+               const std::string& precision) {
   
   if (Rf_isMatrix(x)) {
     
@@ -766,6 +1107,7 @@ SEXP roll_mean(const SEXP& x, const int& width,
     int n_cols_x = xx.ncol();
     arma::uvec arma_any_na(n_rows_x);
     arma::mat arma_mean(n_rows_x, n_cols_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -773,12 +1115,23 @@ SEXP roll_mean(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
+    int n_fft = check_fft(width, n_rows_x);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'false',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -788,21 +1141,114 @@ SEXP roll_mean(const SEXP& x, const int& width,
     }
     
     // compute rolling means
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollMeanOnlineMat roll_mean_online(xx, n, n_rows_x, n_cols_x, width,
-                                               weights, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollMeanLinearMat roll_mean_linear(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                               width, weights, min_obs,
+                                               arma_any_na, na_restore,
+                                               arma_mean);
+      parallelFor(0, n_cols_x * n_chunks, roll_mean_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_cols_x * n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollMeanOnlineMat<roll::RollAccumCompensated> roll_mean_online(xx, n, n_rows_x,
+                                                                             n_cols_x, n_rows_chunk,
+                                                                             width, weights,
+                                                                             min_obs, arma_any_na,
+                                                                             na_restore, reanchor,
+                                                                             arma_mean,
+                                                                             arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_mean_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollMeanOnlineMat<roll::RollAccumDouble> roll_mean_online(xx, n, n_rows_x, n_cols_x,
+                                                                        n_rows_chunk, width,
+                                                                        weights, min_obs,
+                                                                        arma_any_na, na_restore,
+                                                                        reanchor, arma_mean,
+                                                                        arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_mean_online);
+        
+      } else {
+        
+        roll::RollMeanOnlineMat<roll::RollAccumLongDouble> roll_mean_online(xx, n, n_rows_x,
+                                                                            n_cols_x, n_rows_chunk,
+                                                                            width, weights, min_obs,
+                                                                            arma_any_na, na_restore,
+                                                                            reanchor, arma_mean,
+                                                                            arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_mean_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollMeanPrefixMat roll_mean_prefix(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                               width, weights, min_obs,
                                                arma_any_na, na_restore,
                                                arma_mean);
-      parallelFor(0, n_cols_x, roll_mean_online);
+      parallelFor(0, n_cols_x * n_chunks, roll_mean_prefix);
+      
+    } else if (n_fft > 0) {
+      
+      // blocks of rows that overlap by 'width' - 1 rows
+      int n_step = n_fft - std::min(width, n_rows_x) + 1;
+      int n_blocks = std::ceil((double)n_rows_x / n_step);
+      
+      roll::RollMeanFFTMat roll_mean_fft(xx, n, n_rows_x, n_cols_x, n_fft,
+                                         width, weights, min_obs,
+                                         arma_any_na, na_restore,
+                                         arma_mean);
+      parallelFor(0, n_cols_x * n_blocks, roll_mean_fft);
       
     } else {
       
-      roll::RollMeanOfflineMat roll_mean_offline(xx, n, n_rows_x, n_cols_x, width,
-                                                 weights, min_obs,
-                                                 arma_any_na, na_restore,
-                                                 arma_mean);
-      parallelFor(0, n_rows_x * n_cols_x, roll_mean_offline);
+      if (precision_x == 1) {
+        
+        roll::RollMeanOfflineMat<roll::RollAccumCompensated> roll_mean_offline(xx, n, n_rows_x,
+                                                                               n_cols_x, width,
+                                                                               weights, min_obs,
+                                                                               arma_any_na,
+                                                                               na_restore,
+                                                                               arma_mean);
+        parallelFor(0, n_rows_x * n_cols_x, roll_mean_offline);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollMeanOfflineMat<roll::RollAccumDouble> roll_mean_offline(xx, n, n_rows_x, n_cols_x,
+                                                                          width, weights, min_obs,
+                                                                          arma_any_na, na_restore,
+                                                                          arma_mean);
+        parallelFor(0, n_rows_x * n_cols_x, roll_mean_offline);
+        
+      } else {
+        
+        roll::RollMeanOfflineMat<roll::RollAccumLongDouble> roll_mean_offline(xx, n, n_rows_x,
+                                                                              n_cols_x, width,
+                                                                              weights, min_obs,
+                                                                              arma_any_na,
+                                                                              na_restore,
+                                                                              arma_mean);
+        parallelFor(0, n_rows_x * n_cols_x, roll_mean_offline);
+        
+      }
       
     }
     
@@ -817,6 +1263,11 @@ SEXP roll_mean(const SEXP& x, const int& width,
     result.attr("tzone") = xx.attr("tzone");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums of each column
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, n_cols_x);
+    }
+    
     return result;
     
   } else {
@@ -825,6 +1276,7 @@ SEXP roll_mean(const SEXP& x, const int& width,
     int n = weights.size();
     int n_rows_x = xx.size();
     arma::vec arma_mean(n_rows_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -832,41 +1284,143 @@ SEXP roll_mean(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
+    int n_fft = check_fft(width, n_rows_x);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // compute rolling means
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollMeanOnlineVec roll_mean_online(xx, n, n_rows_x, width,
-                                               weights, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollMeanLinearVec roll_mean_linear(xx, n, n_rows_x, n_rows_chunk,
+                                               width, weights, min_obs,
                                                na_restore,
                                                arma_mean);
-      roll_mean_online();
+      parallelFor(0, n_chunks, roll_mean_linear);
       
-    } else {
+    } else if (status && online) {
       
-      roll::RollMeanOfflineVec roll_mean_offline(xx, n, n_rows_x, width,
-                                                 weights, min_obs,
-                                                 na_restore,
-                                                 arma_mean);
-      parallelFor(0, n_rows_x, roll_mean_offline);
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
       
-    }
-    
-    // create and return a vector object
-    NumericVector result(wrap(arma_mean));
-    result.attr("dim") = R_NilValue;
-    List names = xx.attr("names");
+      arma_reanchor.zeros(n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollMeanOnlineVec<roll::RollAccumCompensated> roll_mean_online(xx, n, n_rows_x,
+                                                                             n_rows_chunk, width,
+                                                                             weights, min_obs,
+                                                                             na_restore, reanchor,
+                                                                             arma_mean,
+                                                                             arma_reanchor);
+        parallelFor(0, n_chunks, roll_mean_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollMeanOnlineVec<roll::RollAccumDouble> roll_mean_online(xx, n, n_rows_x,
+                                                                        n_rows_chunk, width,
+                                                                        weights, min_obs,
+                                                                        na_restore, reanchor,
+                                                                        arma_mean, arma_reanchor);
+        parallelFor(0, n_chunks, roll_mean_online);
+        
+      } else {
+        
+        roll::RollMeanOnlineVec<roll::RollAccumLongDouble> roll_mean_online(xx, n, n_rows_x,
+                                                                            n_rows_chunk, width,
+                                                                            weights, min_obs,
+                                                                            na_restore, reanchor,
+                                                                            arma_mean,
+                                                                            arma_reanchor);
+        parallelFor(0, n_chunks, roll_mean_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollMeanPrefixVec roll_mean_prefix(xx, n, n_rows_x, n_rows_chunk,
+                                               width, weights, min_obs,
+                                               na_restore,
+                                               arma_mean);
+      parallelFor(0, n_chunks, roll_mean_prefix);
+      
+    } else if (n_fft > 0) {
+      
+      // blocks of rows that overlap by 'width' - 1 rows
+      int n_step = n_fft - std::min(width, n_rows_x) + 1;
+      int n_blocks = std::ceil((double)n_rows_x / n_step);
+      
+      roll::RollMeanFFTVec roll_mean_fft(xx, n, n_rows_x, n_fft,
+                                         width, weights, min_obs,
+                                         na_restore,
+                                         arma_mean);
+      parallelFor(0, n_blocks, roll_mean_fft);
+      
+    } else {
+      
+      if (precision_x == 1) {
+        
+        roll::RollMeanOfflineVec<roll::RollAccumCompensated> roll_mean_offline(xx, n, n_rows_x,
+                                                                               width, weights,
+                                                                               min_obs, na_restore,
+                                                                               arma_mean);
+        parallelFor(0, n_rows_x, roll_mean_offline);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollMeanOfflineVec<roll::RollAccumDouble> roll_mean_offline(xx, n, n_rows_x, width,
+                                                                          weights, min_obs,
+                                                                          na_restore, arma_mean);
+        parallelFor(0, n_rows_x, roll_mean_offline);
+        
+      } else {
+        
+        roll::RollMeanOfflineVec<roll::RollAccumLongDouble> roll_mean_offline(xx, n, n_rows_x,
+                                                                              width, weights,
+                                                                              min_obs, na_restore,
+                                                                              arma_mean);
+        parallelFor(0, n_rows_x, roll_mean_offline);
+        
+      }
+      
+    }
+    
+    // create and return a vector object
+    NumericVector result(wrap(arma_mean));
+    result.attr("dim") = R_NilValue;
+    List names = xx.attr("names");
     if (names.size() > 0) {
       result.attr("names") = names;
     }
     result.attr("index") = xx.attr("index");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, 1);
+    }
+    
     return result;
     
   }
@@ -929,6 +1483,22 @@ SEXP roll_idxquantile(const SEXP& x, const int& width,
                                                      rcpp_idxquantile);
         parallelFor(0, n_cols_x, roll_idxmax_online);
         
+      } else if (check_lambda(weights, n_rows_x, width, online)) {
+        
+        roll::RollIdxQuantileOnlineMat roll_idxquantile_online(xx, n, n_rows_x, n_cols_x, width,
+                                                               weights, 1 - p, min_obs,
+                                                               rcpp_any_na, na_restore,
+                                                               rcpp_idxquantile);
+        parallelFor(0, n_cols_x, roll_idxquantile_online);
+        
+      } else {
+        
+        roll::RollIdxQuantileOfflineMat roll_idxquantile_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                                 weights, 1 - p, min_obs,
+                                                                 rcpp_any_na, na_restore,
+                                                                 rcpp_idxquantile);
+        parallelFor(0, n_rows_x * n_cols_x, roll_idxquantile_offline);
+        
       }
       
     } else {
@@ -949,6 +1519,14 @@ SEXP roll_idxquantile(const SEXP& x, const int& width,
                                                        rcpp_idxquantile);
         parallelFor(0, n_rows_x * n_cols_x, roll_idxmax_offline);
         
+      } else {
+        
+        roll::RollIdxQuantileOfflineMat roll_idxquantile_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                                 weights, 1 - p, min_obs,
+                                                                 rcpp_any_na, na_restore,
+                                                                 rcpp_idxquantile);
+        parallelFor(0, n_rows_x * n_cols_x, roll_idxquantile_offline);
+        
       }
       
     }
@@ -1006,6 +1584,22 @@ SEXP roll_idxquantile(const SEXP& x, const int& width,
                                                      rcpp_idxquantile);
         roll_idxmax_online();
         
+      } else if (check_lambda(weights, n_rows_x, width, online)) {
+        
+        roll::RollIdxQuantileOnlineVec roll_idxquantile_online(xx, n, n_rows_x, width,
+                                                               weights, 1 - p, min_obs,
+                                                               na_restore,
+                                                               rcpp_idxquantile);
+        roll_idxquantile_online();
+        
+      } else {
+        
+        roll::RollIdxQuantileOfflineVec roll_idxquantile_offline(xx, n, n_rows_x, width,
+                                                                 weights, 1 - p, min_obs,
+                                                                 na_restore,
+                                                                 rcpp_idxquantile);
+        parallelFor(0, n_rows_x, roll_idxquantile_offline);
+        
       }
       
     } else {
@@ -1026,6 +1620,14 @@ SEXP roll_idxquantile(const SEXP& x, const int& width,
                                                        rcpp_idxquantile);
         parallelFor(0, n_rows_x, roll_idxmax_offline);
         
+      } else {
+        
+        roll::RollIdxQuantileOfflineVec roll_idxquantile_offline(xx, n, n_rows_x, width,
+                                                                 weights, 1 - p, min_obs,
+                                                                 na_restore,
+                                                                 rcpp_idxquantile);
+        parallelFor(0, n_rows_x, roll_idxquantile_offline);
+        
       }
       
     }
@@ -1046,20 +1648,25 @@ SEXP roll_idxquantile(const SEXP& x, const int& width,
   
 }
 
-// [[Rcpp::export(.roll_quantile)]]
-SEXP roll_quantile(const SEXP& x, const int& width,
-                   const arma::vec& weights, const double& p,
-                   const int& min_obs, const bool& complete_obs,
-                   const bool& na_restore, const bool& online) {
+// rolling quantiles, where 'n_sorted' is the maximum width of the sorted window
+// or -1 for the cost model (see 'check_sorted')
+SEXP roll_quantile_x(const SEXP& x, const int& width,
+                     const arma::vec& weights, const arma::vec& p,
+                     const int& min_obs, const bool& complete_obs,
+                     const bool& na_restore, const bool& online,
+                     const double& error, const int& n_sorted) {
   
   if (Rf_isMatrix(x)) {
     
     NumericMatrix xx(x);
     int n = weights.size();
+    int n_p = p.size();
     int n_rows_x = xx.nrow();
     int n_cols_x = xx.ncol();
     arma::uvec arma_any_na(n_rows_x);
     NumericMatrix rcpp_quantile(n_rows_x, n_cols_x);
+    arma::cube arma_quantile;
+    arma::vec arma_error(n_cols_x);
     
     // check 'width' argument for errors
     check_width(width);
@@ -1067,9 +1674,23 @@ SEXP roll_quantile(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_p(weights);
+    bool status_eq = all(weights == weights[0]);
     
     // check 'p' argument for errors
     check_p(p);
+    bool status_p = (n_p == 1);
+    
+    // default 'error' argument is zero (i.e., exact),
+    // otherwise check argument for errors
+    check_error(error);
+    bool status_error = (error > 0);
+    
+    if (status_error && (!status_eq || (width < n_rows_x))) {
+      
+      warning("'error' is only supported for equal 'weights' and expanding windows");
+      status_error = false;
+      
+    }
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
@@ -1084,9 +1705,28 @@ SEXP roll_quantile(const SEXP& x, const int& width,
     }
     
     // compute rolling quantiles
-    if (online) {
+    if (status_error) {
       
-      if (p == 0) {
+      arma_quantile.set_size(n_rows_x, n_cols_x, n_p);
+      roll::RollQuantileSketchMat roll_quantile_sketch(xx, n_rows_x, n_cols_x,
+                                                       1 - p, error, min_obs,
+                                                       arma_any_na, na_restore,
+                                                       arma_quantile, arma_error);
+      parallelFor(0, n_cols_x, roll_quantile_sketch);
+      
+    } else if (online) {
+      
+      if (status_p && (p[0] == 0) && (n_cols_x > 1)) {
+        
+        // blocks of adjacent columns are scanned together
+        int n_blocks = (n_cols_x + roll::RollMinBlockMat::n_lanes - 1) / roll::RollMinBlockMat::n_lanes;
+        roll::RollMinBlockMat roll_min_block(xx, n, n_rows_x, n_cols_x, width,
+                                             weights, min_obs,
+                                             arma_any_na, na_restore,
+                                             rcpp_quantile);
+        parallelFor(0, n_blocks, roll_min_block);
+        
+      } else if (status_p && (p[0] == 0)) {
         
         roll::RollMinOnlineMat roll_min_online(xx, n, n_rows_x, n_cols_x, width,
                                                weights, min_obs,
@@ -1094,7 +1734,17 @@ SEXP roll_quantile(const SEXP& x, const int& width,
                                                rcpp_quantile);
         parallelFor(0, n_cols_x, roll_min_online);
         
-      } else if (p == 1) {
+      } else if (status_p && (p[0] == 1) && (n_cols_x > 1)) {
+        
+        // blocks of adjacent columns are scanned together
+        int n_blocks = (n_cols_x + roll::RollMaxBlockMat::n_lanes - 1) / roll::RollMaxBlockMat::n_lanes;
+        roll::RollMaxBlockMat roll_max_block(xx, n, n_rows_x, n_cols_x, width,
+                                             weights, min_obs,
+                                             arma_any_na, na_restore,
+                                             rcpp_quantile);
+        parallelFor(0, n_blocks, roll_max_block);
+        
+      } else if (status_p && (p[0] == 1)) {
         
         roll::RollMaxOnlineMat roll_max_online(xx, n, n_rows_x, n_cols_x, width,
                                                weights, min_obs,
@@ -1102,49 +1752,1339 @@ SEXP roll_quantile(const SEXP& x, const int& width,
                                                rcpp_quantile);
         parallelFor(0, n_cols_x, roll_max_online);
         
+      } else if (status_p && (p[0] == 0.5) && status_eq) {
+        
+        roll::RollMedianOnlineMat roll_median_online(xx, n, n_rows_x, n_cols_x, width,
+                                                     weights, min_obs,
+                                                     arma_any_na, na_restore,
+                                                     rcpp_quantile);
+        parallelFor(0, n_cols_x, roll_median_online);
+        
+      } else if (check_sorted(width, n_rows_x, n_cols_x, status_eq, online, n_sorted)) {
+        
+        arma_quantile.set_size(n_rows_x, n_cols_x, n_p);
+        roll::RollQuantileSortedMat roll_quantile_sorted(xx, n, n_rows_x, n_cols_x, width,
+                                                         weights, 1 - p, min_obs,
+                                                         arma_any_na, na_restore,
+                                                         arma_quantile);
+        parallelFor(0, n_cols_x, roll_quantile_sorted);
+        
+      } else if (status_eq || check_lambda(weights, n_rows_x, width, online)) {
+        
+        arma_quantile.set_size(n_rows_x, n_cols_x, n_p);
+        roll::RollQuantileOnlineMat roll_quantile_online(xx, n, n_rows_x, n_cols_x, width,
+                                                         weights, 1 - p, min_obs,
+                                                         arma_any_na, na_restore,
+                                                         arma_quantile);
+        parallelFor(0, n_cols_x, roll_quantile_online);
+        
+      } else {
+        
+        arma_quantile.set_size(n_rows_x, n_cols_x, n_p);
+        
+        if (check_sorted(width, n_rows_x, n_cols_x, status_eq, false, n_sorted)) {
+          
+          roll::RollQuantileSortedMat roll_quantile_sorted(xx, n, n_rows_x, n_cols_x, width,
+                                                           weights, 1 - p, min_obs,
+                                                           arma_any_na, na_restore,
+                                                           arma_quantile);
+          parallelFor(0, n_cols_x, roll_quantile_sorted);
+          
+        } else {
+          
+          roll::RollQuantileOfflineMat roll_quantile_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                             weights, 1 - p, min_obs,
+                                                             arma_any_na, na_restore,
+                                                             arma_quantile);
+          parallelFor(0, n_rows_x * n_cols_x, roll_quantile_offline);
+          
+        }
+        
+      }
+      
+    } else {
+      
+      if (status_p && (p[0] == 0)) {
+        
+        roll::RollMinOfflineMat roll_min_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                 weights, min_obs,
+                                                 arma_any_na, na_restore,
+                                                 rcpp_quantile);
+        parallelFor(0, n_rows_x * n_cols_x, roll_min_offline);
+        
+      } else if (status_p && (p[0] == 1)) {
+        
+        roll::RollMaxOfflineMat roll_max_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                 weights, min_obs,
+                                                 arma_any_na, na_restore,
+                                                 rcpp_quantile);
+        parallelFor(0, n_rows_x * n_cols_x, roll_max_offline);
+        
       } else {
         
-        warning("'online' is not supported");
-        roll::RollQuantileOfflineMat roll_quantile_offline(xx, n, n_rows_x, n_cols_x, width,
+        arma_quantile.set_size(n_rows_x, n_cols_x, n_p);
+        
+        if (check_sorted(width, n_rows_x, n_cols_x, status_eq, false, n_sorted)) {
+          
+          roll::RollQuantileSortedMat roll_quantile_sorted(xx, n, n_rows_x, n_cols_x, width,
                                                            weights, 1 - p, min_obs,
                                                            arma_any_na, na_restore,
-                                                           rcpp_quantile);
-        parallelFor(0, n_rows_x * n_cols_x, roll_quantile_offline);
+                                                           arma_quantile);
+          parallelFor(0, n_cols_x, roll_quantile_sorted);
+          
+        } else {
+          
+          roll::RollQuantileOfflineMat roll_quantile_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                             weights, 1 - p, min_obs,
+                                                             arma_any_na, na_restore,
+                                                             arma_quantile);
+          parallelFor(0, n_rows_x * n_cols_x, roll_quantile_offline);
+          
+        }
+        
+      }
+      
+    }
+    
+    // quantiles of a single probability are returned as a matrix
+    if (status_p && (arma_quantile.n_slices > 0)) {
+      std::copy(arma_quantile.begin(), arma_quantile.end(), rcpp_quantile.begin());
+    }
+    
+    if (status_p) {
+      
+      // create and return a matrix or xts object
+      NumericMatrix result(rcpp_quantile);
+      List dimnames = xx.attr("dimnames");
+      result.attr("dimnames") = dimnames;
+      result.attr("index") = xx.attr("index");
+      result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+      result.attr(".indexTZ") = xx.attr(".indexTZ");
+      result.attr("tclass") = xx.attr("tclass");
+      result.attr("tzone") = xx.attr("tzone");
+      result.attr("class") = xx.attr("class");
+      
+      // achieved rank error of the approximate algorithm
+      if (status_error) {
+        result.attr("error") = NumericVector(arma_error.begin(), arma_error.end());
+      }
+      
+      return result;
+      
+    } else {
+      
+      // create and return a list of matrices or xts objects
+      List result(n_p);
+      List dimnames = xx.attr("dimnames");
+      
+      for (int l = 0; l < n_p; l++) {
+        
+        NumericMatrix result_l(wrap(arma_quantile.slice(l)));
+        result_l.attr("dimnames") = dimnames;
+        result_l.attr("index") = xx.attr("index");
+        result_l.attr(".indexCLASS") = xx.attr(".indexCLASS");
+        result_l.attr(".indexTZ") = xx.attr(".indexTZ");
+        result_l.attr("tclass") = xx.attr("tclass");
+        result_l.attr("tzone") = xx.attr("tzone");
+        result_l.attr("class") = xx.attr("class");
+        
+        result[l] = result_l;
+        
+      }
+      
+      result.attr("names") = names_p(p);
+      
+      // achieved rank error of the approximate algorithm
+      if (status_error) {
+        result.attr("error") = NumericVector(arma_error.begin(), arma_error.end());
+      }
+      
+      return result;
+      
+    }
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_p = p.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_quantile(n_rows_x);
+    arma::mat arma_quantile;
+    arma::vec arma_error(1);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    bool status_eq = all(weights == weights[0]);
+    
+    // check 'p' argument for errors
+    check_p(p);
+    bool status_p = (n_p == 1);
+    
+    // default 'error' argument is zero (i.e., exact),
+    // otherwise check argument for errors
+    check_error(error);
+    bool status_error = (error > 0);
+    
+    if (status_error && (!status_eq || (width < n_rows_x))) {
+      
+      warning("'error' is only supported for equal 'weights' and expanding windows");
+      status_error = false;
+      
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling quantiles
+    if (status_error) {
+      
+      arma_quantile.set_size(n_rows_x, n_p);
+      roll::RollQuantileSketchVec roll_quantile_sketch(xx, n_rows_x, 1 - p,
+                                                       error, min_obs, na_restore,
+                                                       arma_quantile, arma_error);
+      roll_quantile_sketch();
+      
+    } else if (online) {
+      
+      if (status_p && (p[0] == 0)) {
+        
+        roll::RollMinOnlineVec roll_min_online(xx, n, n_rows_x, width,
+                                               weights, min_obs,
+                                               na_restore,
+                                               rcpp_quantile);
+        roll_min_online();
+        
+      } else if (status_p && (p[0] == 1)) {
+        
+        roll::RollMaxOnlineVec roll_max_online(xx, n, n_rows_x, width,
+                                               weights, min_obs,
+                                               na_restore,
+                                               rcpp_quantile);
+        roll_max_online();
+        
+      } else if (status_p && (p[0] == 0.5) && status_eq) {
+        
+        roll::RollMedianOnlineVec roll_median_online(xx, n, n_rows_x, width,
+                                                     weights, min_obs,
+                                                     na_restore,
+                                                     rcpp_quantile);
+        roll_median_online();
+        
+      } else if (check_sorted(width, n_rows_x, 1, status_eq, online, n_sorted)) {
+        
+        arma_quantile.set_size(n_rows_x, n_p);
+        roll::RollQuantileSortedVec roll_quantile_sorted(xx, n, n_rows_x, width,
+                                                         weights, 1 - p, min_obs,
+                                                         na_restore,
+                                                         arma_quantile);
+        roll_quantile_sorted();
         
+      } else if (status_eq || check_lambda(weights, n_rows_x, width, online)) {
+        
+        arma_quantile.set_size(n_rows_x, n_p);
+        roll::RollQuantileOnlineVec roll_quantile_online(xx, n, n_rows_x, width,
+                                                         weights, 1 - p, min_obs,
+                                                         na_restore,
+                                                         arma_quantile);
+        roll_quantile_online();
+        
+      } else {
+        
+        arma_quantile.set_size(n_rows_x, n_p);
+        
+        if (check_sorted(width, n_rows_x, 1, status_eq, false, n_sorted)) {
+          
+          roll::RollQuantileSortedVec roll_quantile_sorted(xx, n, n_rows_x, width,
+                                                           weights, 1 - p, min_obs,
+                                                           na_restore,
+                                                           arma_quantile);
+          roll_quantile_sorted();
+          
+        } else {
+          
+          roll::RollQuantileOfflineVec roll_quantile_offline(xx, n, n_rows_x, width,
+                                                             weights, 1 - p, min_obs,
+                                                             na_restore,
+                                                             arma_quantile);
+          parallelFor(0, n_rows_x, roll_quantile_offline);
+          
+        }
+        
+      }
+      
+    } else {
+      
+      if (status_p && (p[0] == 0)) {
+        
+        roll::RollMinOfflineVec roll_min_offline(xx, n, n_rows_x, width,
+                                                 weights, min_obs,
+                                                 na_restore,
+                                                 rcpp_quantile);
+        parallelFor(0, n_rows_x, roll_min_offline);
+        
+      } else if (status_p && (p[0] == 1)) {
+        
+        roll::RollMaxOfflineVec roll_max_offline(xx, n, n_rows_x, width,
+                                                 weights, min_obs,
+                                                 na_restore,
+                                                 rcpp_quantile);
+        parallelFor(0, n_rows_x, roll_max_offline);
+        
+      } else {
+        
+        arma_quantile.set_size(n_rows_x, n_p);
+        
+        if (check_sorted(width, n_rows_x, 1, status_eq, false, n_sorted)) {
+          
+          roll::RollQuantileSortedVec roll_quantile_sorted(xx, n, n_rows_x, width,
+                                                           weights, 1 - p, min_obs,
+                                                           na_restore,
+                                                           arma_quantile);
+          roll_quantile_sorted();
+          
+        } else {
+          
+          roll::RollQuantileOfflineVec roll_quantile_offline(xx, n, n_rows_x, width,
+                                                             weights, 1 - p, min_obs,
+                                                             na_restore,
+                                                             arma_quantile);
+          parallelFor(0, n_rows_x, roll_quantile_offline);
+          
+        }
+        
+      }
+      
+    }
+    
+    // quantiles of a single probability are returned as a vector
+    if (status_p && (arma_quantile.n_elem > 0)) {
+      std::copy(arma_quantile.begin(), arma_quantile.end(), rcpp_quantile.begin());
+    }
+    
+    List names = xx.attr("names");
+    
+    if (status_p) {
+      
+      // create and return a vector object
+      NumericVector result(rcpp_quantile);
+      result.attr("dim") = R_NilValue;
+      if (names.size() > 0) {
+        result.attr("names") = names;
       }
+      result.attr("index") = xx.attr("index");
+      result.attr("class") = xx.attr("class");
+      
+      // achieved rank error of the approximate algorithm
+      if (status_error) {
+        result.attr("error") = NumericVector(arma_error.begin(), arma_error.end());
+      }
+      
+      return result;
+      
+    } else {
+      
+      // create and return a matrix object
+      NumericMatrix result(wrap(arma_quantile));
+      if (names.size() > 0) {
+        result.attr("dimnames") = List::create(names, names_p(p));
+      } else {
+        result.attr("dimnames") = List::create(R_NilValue, names_p(p));
+      }
+      result.attr("index") = xx.attr("index");
+      result.attr("class") = xx.attr("class");
+      
+      // achieved rank error of the approximate algorithm
+      if (status_error) {
+        result.attr("error") = NumericVector(arma_error.begin(), arma_error.end());
+      }
+      
+      return result;
+      
+    }
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_quantile)]]
+SEXP roll_quantile(const SEXP& x, const int& width,
+                   const arma::vec& weights, const arma::vec& p,
+                   const int& min_obs, const bool& complete_obs,
+                   const bool& na_restore, const bool& online,
+                   const double& error) {
+  
+  return roll_quantile_x(x, width, weights, p, min_obs, complete_obs,
+                         na_restore, online, error, -1);
+  
+}
+
+// rolling quantiles with the sorted window for widths up to 'n_sorted' that are
+// compared with the other algorithms in the tests (e.g., 'n_sorted' is 0 for
+// the order-statistic tree, heaps, or sort of each window)
+// [[Rcpp::export(.roll_quantile_sorted)]]
+SEXP roll_quantile_sorted(const SEXP& x, const int& width,
+                          const arma::vec& weights, const arma::vec& p,
+                          const int& min_obs, const bool& complete_obs,
+                          const bool& na_restore, const bool& online,
+                          const int& n_sorted) {
+  
+  return roll_quantile_x(x, width, weights, p, min_obs, complete_obs,
+                         na_restore, online, 0, n_sorted);
+  
+}
+
+// [[Rcpp::export(.roll_range)]]
+SEXP roll_range(const SEXP& x, const int& width,
+                const arma::vec& weights, const std::vector<std::string>& type,
+                const int& min_obs, const bool& complete_obs,
+                const bool& na_restore, const bool& online) {
+  
+  // check 'type' argument for errors
+  check_type(type);
+  bool status_min = std::count(type.begin(), type.end(), "min") > 0;
+  bool status_max = std::count(type.begin(), type.end(), "max") > 0;
+  bool status_idxmin = std::count(type.begin(), type.end(), "idxmin") > 0;
+  bool status_idxmax = std::count(type.begin(), type.end(), "idxmax") > 0;
+  int n_type = type.size();
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_min;
+    NumericMatrix rcpp_max;
+    IntegerMatrix rcpp_idxmin;
+    IntegerMatrix rcpp_idxmax;
+    
+    // only the requested statistics are allocated
+    if (status_min) {
+      rcpp_min = NumericMatrix(n_rows_x, n_cols_x);
+    }
+    
+    if (status_max) {
+      rcpp_max = NumericMatrix(n_rows_x, n_cols_x);
+    }
+    
+    if (status_idxmin) {
+      rcpp_idxmin = IntegerMatrix(n_rows_x, n_cols_x);
+    }
+    
+    if (status_idxmax) {
+      rcpp_idxmax = IntegerMatrix(n_rows_x, n_cols_x);
+    }
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling minimums, maximums, and indices in a single pass
+    if (online) {
+      
+      roll::RollRangeOnlineMat roll_range_online(xx, n, n_rows_x, n_cols_x, width,
+                                                 weights, min_obs,
+                                                 arma_any_na, na_restore,
+                                                 status_min, status_max,
+                                                 status_idxmin, status_idxmax,
+                                                 rcpp_min, rcpp_max,
+                                                 rcpp_idxmin, rcpp_idxmax);
+      parallelFor(0, n_cols_x, roll_range_online);
+      
+    } else {
+      
+      roll::RollRangeOfflineMat roll_range_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                   weights, min_obs,
+                                                   arma_any_na, na_restore,
+                                                   status_min, status_max,
+                                                   status_idxmin, status_idxmax,
+                                                   rcpp_min, rcpp_max,
+                                                   rcpp_idxmin, rcpp_idxmax);
+      parallelFor(0, n_rows_x * n_cols_x, roll_range_offline);
+      
+    }
+    
+    // create and return a list of matrices or xts objects
+    List result(n_type);
+    List dimnames = xx.attr("dimnames");
+    
+    for (int l = 0; l < n_type; l++) {
+      
+      if ((type[l] == "min") || (type[l] == "max")) {
+        
+        NumericMatrix result_l((type[l] == "min") ? rcpp_min : rcpp_max);
+        result_l.attr("dimnames") = dimnames;
+        result_l.attr("index") = xx.attr("index");
+        result_l.attr(".indexCLASS") = xx.attr(".indexCLASS");
+        result_l.attr(".indexTZ") = xx.attr(".indexTZ");
+        result_l.attr("tclass") = xx.attr("tclass");
+        result_l.attr("tzone") = xx.attr("tzone");
+        result_l.attr("class") = xx.attr("class");
+        
+        result[l] = result_l;
+        
+      } else {
+        
+        IntegerMatrix result_l((type[l] == "idxmin") ? rcpp_idxmin : rcpp_idxmax);
+        result_l.attr("dimnames") = dimnames;
+        result_l.attr("index") = xx.attr("index");
+        result_l.attr(".indexCLASS") = xx.attr(".indexCLASS");
+        result_l.attr(".indexTZ") = xx.attr(".indexTZ");
+        result_l.attr("tclass") = xx.attr("tclass");
+        result_l.attr("tzone") = xx.attr("tzone");
+        result_l.attr("class") = xx.attr("class");
+        
+        result[l] = result_l;
+        
+      }
+      
+    }
+    
+    result.attr("names") = type;
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_min;
+    NumericVector rcpp_max;
+    IntegerVector rcpp_idxmin;
+    IntegerVector rcpp_idxmax;
+    
+    // only the requested statistics are allocated
+    if (status_min) {
+      rcpp_min = NumericVector(n_rows_x);
+    }
+    
+    if (status_max) {
+      rcpp_max = NumericVector(n_rows_x);
+    }
+    
+    if (status_idxmin) {
+      rcpp_idxmin = IntegerVector(n_rows_x);
+    }
+    
+    if (status_idxmax) {
+      rcpp_idxmax = IntegerVector(n_rows_x);
+    }
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling minimums, maximums, and indices in a single pass
+    if (online) {
+      
+      roll::RollRangeOnlineVec roll_range_online(xx, n, n_rows_x, width,
+                                                 weights, min_obs,
+                                                 na_restore,
+                                                 status_min, status_max,
+                                                 status_idxmin, status_idxmax,
+                                                 rcpp_min, rcpp_max,
+                                                 rcpp_idxmin, rcpp_idxmax);
+      roll_range_online();
+      
+    } else {
+      
+      roll::RollRangeOfflineVec roll_range_offline(xx, n, n_rows_x, width,
+                                                   weights, min_obs,
+                                                   na_restore,
+                                                   status_min, status_max,
+                                                   status_idxmin, status_idxmax,
+                                                   rcpp_min, rcpp_max,
+                                                   rcpp_idxmin, rcpp_idxmax);
+      parallelFor(0, n_rows_x, roll_range_offline);
+      
+    }
+    
+    // create and return a list of vector objects
+    List result(n_type);
+    List names = xx.attr("names");
+    
+    for (int l = 0; l < n_type; l++) {
+      
+      if ((type[l] == "min") || (type[l] == "max")) {
+        
+        NumericVector result_l((type[l] == "min") ? rcpp_min : rcpp_max);
+        result_l.attr("dim") = R_NilValue;
+        if (names.size() > 0) {
+          result_l.attr("names") = names;
+        }
+        result_l.attr("index") = xx.attr("index");
+        result_l.attr("class") = xx.attr("class");
+        
+        result[l] = result_l;
+        
+      } else {
+        
+        IntegerVector result_l((type[l] == "idxmin") ? rcpp_idxmin : rcpp_idxmax);
+        result_l.attr("dim") = R_NilValue;
+        if (names.size() > 0) {
+          result_l.attr("names") = names;
+        }
+        result_l.attr("index") = xx.attr("index");
+        result_l.attr("class") = xx.attr("class");
+        
+        result[l] = result_l;
+        
+      }
+      
+    }
+    
+    result.attr("names") = type;
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_drawdown)]]
+SEXP roll_drawdown(const SEXP& x, const int& width,
+                   const arma::vec& weights, const bool& runup,
+                   const bool& index, const int& min_obs,
+                   const bool& complete_obs, const bool& na_restore,
+                   const bool& online) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_drawdown(n_rows_x, n_cols_x);
+    IntegerMatrix rcpp_peak;
+    IntegerMatrix rcpp_trough;
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    
+    // default 'index' argument is 'false' (i.e., no rows of the peaks and troughs)
+    if (index) {
+      
+      rcpp_peak = IntegerMatrix(n_rows_x, n_cols_x);
+      rcpp_trough = IntegerMatrix(n_rows_x, n_cols_x);
+      
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling maximum drawdowns or run-ups
+    if (online) {
+      
+      roll::RollDrawdownOnlineMat roll_drawdown_online(xx, n, n_rows_x, n_cols_x, width,
+                                                       weights, runup, index, min_obs,
+                                                       arma_any_na, na_restore,
+                                                       rcpp_drawdown, rcpp_peak,
+                                                       rcpp_trough);
+      parallelFor(0, n_cols_x, roll_drawdown_online);
+      
+    } else {
+      
+      roll::RollDrawdownOfflineMat roll_drawdown_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                         weights, runup, index, min_obs,
+                                                         arma_any_na, na_restore,
+                                                         rcpp_drawdown, rcpp_peak,
+                                                         rcpp_trough);
+      parallelFor(0, n_rows_x * n_cols_x, roll_drawdown_offline);
+      
+    }
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(rcpp_drawdown);
+    List dimnames = xx.attr("dimnames");
+    result.attr("dimnames") = dimnames;
+    result.attr("index") = xx.attr("index");
+    result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+    result.attr(".indexTZ") = xx.attr(".indexTZ");
+    result.attr("tclass") = xx.attr("tclass");
+    result.attr("tzone") = xx.attr("tzone");
+    result.attr("class") = xx.attr("class");
+    
+    if (index) {
+      
+      // create and return a list of matrices or xts objects
+      IntegerMatrix peak(rcpp_peak);
+      peak.attr("dimnames") = dimnames;
+      peak.attr("index") = xx.attr("index");
+      peak.attr(".indexCLASS") = xx.attr(".indexCLASS");
+      peak.attr(".indexTZ") = xx.attr(".indexTZ");
+      peak.attr("tclass") = xx.attr("tclass");
+      peak.attr("tzone") = xx.attr("tzone");
+      peak.attr("class") = xx.attr("class");
+      
+      IntegerMatrix trough(rcpp_trough);
+      trough.attr("dimnames") = dimnames;
+      trough.attr("index") = xx.attr("index");
+      trough.attr(".indexCLASS") = xx.attr(".indexCLASS");
+      trough.attr(".indexTZ") = xx.attr(".indexTZ");
+      trough.attr("tclass") = xx.attr("tclass");
+      trough.attr("tzone") = xx.attr("tzone");
+      trough.attr("class") = xx.attr("class");
+      
+      return List::create(Named(runup ? "runup" : "drawdown") = result,
+                          Named("peak") = peak,
+                          Named("trough") = trough);
+      
+    }
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_drawdown(n_rows_x);
+    IntegerVector rcpp_peak;
+    IntegerVector rcpp_trough;
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    
+    // default 'index' argument is 'false' (i.e., no rows of the peaks and troughs)
+    if (index) {
+      
+      rcpp_peak = IntegerVector(n_rows_x);
+      rcpp_trough = IntegerVector(n_rows_x);
+      
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling maximum drawdowns or run-ups
+    if (online) {
+      
+      roll::RollDrawdownOnlineVec roll_drawdown_online(xx, n, n_rows_x, width,
+                                                       weights, runup, index, min_obs,
+                                                       na_restore,
+                                                       rcpp_drawdown, rcpp_peak,
+                                                       rcpp_trough);
+      roll_drawdown_online();
+      
+    } else {
+      
+      roll::RollDrawdownOfflineVec roll_drawdown_offline(xx, n, n_rows_x, width,
+                                                         weights, runup, index, min_obs,
+                                                         na_restore,
+                                                         rcpp_drawdown, rcpp_peak,
+                                                         rcpp_trough);
+      parallelFor(0, n_rows_x, roll_drawdown_offline);
+      
+    }
+    
+    List names = xx.attr("names");
+    
+    // create and return a vector object
+    NumericVector result(rcpp_drawdown);
+    result.attr("dim") = R_NilValue;
+    if (names.size() > 0) {
+      result.attr("names") = names;
+    }
+    result.attr("index") = xx.attr("index");
+    result.attr("class") = xx.attr("class");
+    
+    if (index) {
+      
+      // create and return a list of vector objects
+      IntegerVector peak(rcpp_peak);
+      peak.attr("dim") = R_NilValue;
+      if (names.size() > 0) {
+        peak.attr("names") = names;
+      }
+      peak.attr("index") = xx.attr("index");
+      peak.attr("class") = xx.attr("class");
+      
+      IntegerVector trough(rcpp_trough);
+      trough.attr("dim") = R_NilValue;
+      if (names.size() > 0) {
+        trough.attr("names") = names;
+      }
+      trough.attr("index") = xx.attr("index");
+      trough.attr("class") = xx.attr("class");
+      
+      return List::create(Named(runup ? "runup" : "drawdown") = result,
+                          Named("peak") = peak,
+                          Named("trough") = trough);
+      
+    }
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_mad)]]
+SEXP roll_mad(const SEXP& x, const int& width,
+              const arma::vec& weights, const double& threshold,
+              const int& min_obs, const bool& complete_obs,
+              const bool& na_restore, const bool& online) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_mad(n_rows_x, n_cols_x);
+    LogicalMatrix rcpp_outlier;
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    bool status_eq = all(weights == weights[0]);
+    
+    // default 'threshold' argument is zero (i.e., no outliers),
+    // otherwise check argument for errors
+    check_threshold(threshold);
+    bool status_outlier = (threshold > 0);
+    
+    if (status_outlier) {
+      rcpp_outlier = LogicalMatrix(n_rows_x, n_cols_x);
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling median absolute deviations
+    // note: each result requires O(log(n)) selections, so the sorted window
+    // is faster than the order-statistic tree for widths up to about 8192
+    if (status_eq && (!online || (std::min(width, n_rows_x) <= 8192))) {
+      
+      roll::RollMadSortedMat roll_mad_sorted(xx, n, n_rows_x, n_cols_x, width,
+                                             weights, threshold, min_obs,
+                                             arma_any_na, na_restore,
+                                             rcpp_mad, rcpp_outlier);
+      parallelFor(0, n_cols_x, roll_mad_sorted);
+      
+    } else if (status_eq && online) {
+      
+      roll::RollMadOnlineMat roll_mad_online(xx, n, n_rows_x, n_cols_x, width,
+                                             weights, threshold, min_obs,
+                                             arma_any_na, na_restore,
+                                             rcpp_mad, rcpp_outlier);
+      parallelFor(0, n_cols_x, roll_mad_online);
+      
+    } else {
+      
+      roll::RollMadOfflineMat roll_mad_offline(xx, n, n_rows_x, n_cols_x, width,
+                                               weights, threshold, min_obs,
+                                               arma_any_na, na_restore,
+                                               rcpp_mad, rcpp_outlier);
+      parallelFor(0, n_rows_x * n_cols_x, roll_mad_offline);
+      
+    }
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(rcpp_mad);
+    List dimnames = xx.attr("dimnames");
+    result.attr("dimnames") = dimnames;
+    result.attr("index") = xx.attr("index");
+    result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+    result.attr(".indexTZ") = xx.attr(".indexTZ");
+    result.attr("tclass") = xx.attr("tclass");
+    result.attr("tzone") = xx.attr("tzone");
+    result.attr("class") = xx.attr("class");
+    
+    if (status_outlier) {
+      
+      // create and return a list of matrices or xts objects
+      LogicalMatrix outlier(rcpp_outlier);
+      outlier.attr("dimnames") = dimnames;
+      outlier.attr("index") = xx.attr("index");
+      outlier.attr(".indexCLASS") = xx.attr(".indexCLASS");
+      outlier.attr(".indexTZ") = xx.attr(".indexTZ");
+      outlier.attr("tclass") = xx.attr("tclass");
+      outlier.attr("tzone") = xx.attr("tzone");
+      outlier.attr("class") = xx.attr("class");
+      
+      return List::create(Named("mad") = result,
+                          Named("outlier") = outlier);
+      
+    }
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_mad(n_rows_x);
+    LogicalVector rcpp_outlier;
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_p(weights);
+    bool status_eq = all(weights == weights[0]);
+    
+    // default 'threshold' argument is zero (i.e., no outliers),
+    // otherwise check argument for errors
+    check_threshold(threshold);
+    bool status_outlier = (threshold > 0);
+    
+    if (status_outlier) {
+      rcpp_outlier = LogicalVector(n_rows_x);
+    }
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling median absolute deviations
+    // note: each result requires O(log(n)) selections, so the sorted window
+    // is faster than the order-statistic tree for widths up to about 8192
+    if (status_eq && (!online || (std::min(width, n_rows_x) <= 8192))) {
+      
+      roll::RollMadSortedVec roll_mad_sorted(xx, n, n_rows_x, width,
+                                             weights, threshold, min_obs,
+                                             na_restore,
+                                             rcpp_mad, rcpp_outlier);
+      roll_mad_sorted();
+      
+    } else if (status_eq && online) {
+      
+      roll::RollMadOnlineVec roll_mad_online(xx, n, n_rows_x, width,
+                                             weights, threshold, min_obs,
+                                             na_restore,
+                                             rcpp_mad, rcpp_outlier);
+      roll_mad_online();
+      
+    } else {
+      
+      roll::RollMadOfflineVec roll_mad_offline(xx, n, n_rows_x, width,
+                                               weights, threshold, min_obs,
+                                               na_restore,
+                                               rcpp_mad, rcpp_outlier);
+      parallelFor(0, n_rows_x, roll_mad_offline);
+      
+    }
+    
+    List names = xx.attr("names");
+    
+    // create and return a vector object
+    NumericVector result(rcpp_mad);
+    result.attr("dim") = R_NilValue;
+    if (names.size() > 0) {
+      result.attr("names") = names;
+    }
+    result.attr("index") = xx.attr("index");
+    result.attr("class") = xx.attr("class");
+    
+    if (status_outlier) {
+      
+      // create and return a list of vector objects
+      LogicalVector outlier(rcpp_outlier);
+      outlier.attr("dim") = R_NilValue;
+      if (names.size() > 0) {
+        outlier.attr("names") = names;
+      }
+      outlier.attr("index") = xx.attr("index");
+      outlier.attr("class") = xx.attr("class");
+      
+      return List::create(Named("mad") = result,
+                          Named("outlier") = outlier);
+      
+    }
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_es)]]
+SEXP roll_es(const SEXP& x, const int& width,
+             const arma::vec& weights, const double& p,
+             const int& min_obs, const bool& complete_obs,
+             const bool& na_restore, const bool& online) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_es(n_rows_x, n_cols_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // check 'p' argument for errors
+    check_p(p);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling expected shortfalls
+    if (status && online) {
+      
+      roll::RollEsOnlineMat roll_es_online(xx, n, n_rows_x, n_cols_x, width,
+                                           weights, 1 - p, min_obs,
+                                           arma_any_na, na_restore,
+                                           rcpp_es);
+      parallelFor(0, n_cols_x, roll_es_online);
+      
+    } else {
+      
+      roll::RollEsOfflineMat roll_es_offline(xx, n, n_rows_x, n_cols_x, width,
+                                             weights, 1 - p, min_obs,
+                                             arma_any_na, na_restore,
+                                             rcpp_es);
+      parallelFor(0, n_rows_x * n_cols_x, roll_es_offline);
+      
+    }
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(rcpp_es);
+    List dimnames = xx.attr("dimnames");
+    result.attr("dimnames") = dimnames;
+    result.attr("index") = xx.attr("index");
+    result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+    result.attr(".indexTZ") = xx.attr(".indexTZ");
+    result.attr("tclass") = xx.attr("tclass");
+    result.attr("tzone") = xx.attr("tzone");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_es(n_rows_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // check 'p' argument for errors
+    check_p(p);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling expected shortfalls
+    if (status && online) {
+      
+      roll::RollEsOnlineVec roll_es_online(xx, n, n_rows_x, width,
+                                           weights, 1 - p, min_obs,
+                                           na_restore,
+                                           rcpp_es);
+      roll_es_online();
+      
+    } else {
+      
+      roll::RollEsOfflineVec roll_es_offline(xx, n, n_rows_x, width,
+                                             weights, 1 - p, min_obs,
+                                             na_restore,
+                                             rcpp_es);
+      parallelFor(0, n_rows_x, roll_es_offline);
+      
+    }
+    
+    // create and return a vector object
+    NumericVector result(rcpp_es);
+    result.attr("dim") = R_NilValue;
+    List names = xx.attr("names");
+    if (names.size() > 0) {
+      result.attr("names") = names;
+    }
+    result.attr("index") = xx.attr("index");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_trimmean)]]
+SEXP roll_trimmean(const SEXP& x, const int& width,
+                   const arma::vec& weights, const double& trim,
+                   const bool& winsorize, const int& min_obs,
+                   const bool& complete_obs, const bool& na_restore,
+                   const bool& online) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_mean(n_rows_x, n_cols_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // default 'trim' argument is 0.1,
+    // otherwise check argument for errors
+    check_trim(trim);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling trimmed means
+    if (status && online) {
+      
+      roll::RollTrimMeanOnlineMat roll_trimmean_online(xx, n, n_rows_x, n_cols_x, width,
+                                                       weights, trim, winsorize,
+                                                       min_obs, arma_any_na,
+                                                       na_restore, rcpp_mean);
+      parallelFor(0, n_cols_x, roll_trimmean_online);
+      
+    } else {
+      
+      roll::RollTrimMeanOfflineMat roll_trimmean_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                         weights, trim, winsorize,
+                                                         min_obs, arma_any_na,
+                                                         na_restore, rcpp_mean);
+      parallelFor(0, n_rows_x * n_cols_x, roll_trimmean_offline);
+      
+    }
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(rcpp_mean);
+    List dimnames = xx.attr("dimnames");
+    result.attr("dimnames") = dimnames;
+    result.attr("index") = xx.attr("index");
+    result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+    result.attr(".indexTZ") = xx.attr(".indexTZ");
+    result.attr("tclass") = xx.attr("tclass");
+    result.attr("tzone") = xx.attr("tzone");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  } else {
+    
+    NumericVector xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.size();
+    NumericVector rcpp_mean(n_rows_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // default 'trim' argument is 0.1,
+    // otherwise check argument for errors
+    check_trim(trim);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // compute rolling trimmed means
+    if (status && online) {
+      
+      roll::RollTrimMeanOnlineVec roll_trimmean_online(xx, n, n_rows_x, width,
+                                                       weights, trim, winsorize,
+                                                       min_obs, na_restore,
+                                                       rcpp_mean);
+      roll_trimmean_online();
+      
+    } else {
+      
+      roll::RollTrimMeanOfflineVec roll_trimmean_offline(xx, n, n_rows_x, width,
+                                                         weights, trim, winsorize,
+                                                         min_obs, na_restore,
+                                                         rcpp_mean);
+      parallelFor(0, n_rows_x, roll_trimmean_offline);
+      
+    }
+    
+    // create and return a vector object
+    NumericVector result(rcpp_mean);
+    result.attr("dim") = R_NilValue;
+    List names = xx.attr("names");
+    if (names.size() > 0) {
+      result.attr("names") = names;
+    }
+    result.attr("index") = xx.attr("index");
+    result.attr("class") = xx.attr("class");
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_rank)]]
+SEXP roll_rank(const SEXP& x, const int& width,
+               const arma::vec& weights, const std::string& ties,
+               const int& min_obs, const bool& complete_obs,
+               const bool& na_restore, const bool& online) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    int n = weights.size();
+    int n_rows_x = xx.nrow();
+    int n_cols_x = xx.ncol();
+    arma::uvec arma_any_na(n_rows_x);
+    NumericMatrix rcpp_rank(n_rows_x, n_cols_x);
+    
+    // check 'width' argument for errors
+    check_width(width);
+    
+    // default 'weights' argument is equal-weighted,
+    // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
+    check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
+    
+    // default 'ties' argument is "average",
+    // otherwise check argument for errors
+    double ties_w = check_ties(ties);
+    
+    // default 'min_obs' argument is 'width',
+    // otherwise check argument for errors
+    check_min_obs(min_obs);
+    
+    // default 'complete_obs' argument is 'false',
+    // otherwise check argument for errors
+    if (complete_obs) {
+      arma_any_na = any_na_x(xx);
+    } else {
+      arma_any_na.fill(0);
+    }
+    
+    // compute rolling ranks
+    if (status && online) {
+      
+      roll::RollRankOnlineMat roll_rank_online(xx, n, n_rows_x, n_cols_x, width,
+                                               weights, ties_w, min_obs,
+                                               arma_any_na, na_restore,
+                                               rcpp_rank);
+      parallelFor(0, n_cols_x, roll_rank_online);
       
     } else {
       
-      if (p == 0) {
-        
-        roll::RollMinOfflineMat roll_min_offline(xx, n, n_rows_x, n_cols_x, width,
-                                                 weights, min_obs,
-                                                 arma_any_na, na_restore,
-                                                 rcpp_quantile);
-        parallelFor(0, n_rows_x * n_cols_x, roll_min_offline);
-        
-      } else if (p == 1) {
-        
-        roll::RollMaxOfflineMat roll_max_offline(xx, n, n_rows_x, n_cols_x, width,
-                                                 weights, min_obs,
+      roll::RollRankOfflineMat roll_rank_offline(xx, n, n_rows_x, n_cols_x, width,
+                                                 weights, ties_w, min_obs,
                                                  arma_any_na, na_restore,
-                                                 rcpp_quantile);
-        parallelFor(0, n_rows_x * n_cols_x, roll_max_offline);
-        
-      } else {
-        
-        roll::RollQuantileOfflineMat roll_quantile_offline(xx, n, n_rows_x, n_cols_x, width,
-                                                           weights, 1 - p, min_obs,
-                                                           arma_any_na, na_restore,
-                                                           rcpp_quantile);
-        parallelFor(0, n_rows_x * n_cols_x, roll_quantile_offline);
-        
-      }
+                                                 rcpp_rank);
+      parallelFor(0, n_rows_x * n_cols_x, roll_rank_offline);
       
     }
     
     // create and return a matrix or xts object
-    NumericMatrix result(rcpp_quantile);
+    NumericMatrix result(rcpp_rank);
     List dimnames = xx.attr("dimnames");
     result.attr("dimnames") = dimnames;
     result.attr("index") = xx.attr("index");
@@ -1161,84 +3101,46 @@ SEXP roll_quantile(const SEXP& x, const int& width,
     NumericVector xx(x);
     int n = weights.size();
     int n_rows_x = xx.size();
-    NumericVector rcpp_quantile(n_rows_x);
+    NumericVector rcpp_rank(n_rows_x);
     
     // check 'width' argument for errors
     check_width(width);
     
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
+    check_weights_x(n_rows_x, width, weights);
     check_weights_p(weights);
+    bool status = check_lambda(weights, n_rows_x, width, online);
     
-    // check 'p' argument for errors
-    check_p(p);
+    // default 'ties' argument is "average",
+    // otherwise check argument for errors
+    double ties_w = check_ties(ties);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
-    // compute rolling quantiles
-    if (online) {
+    // compute rolling ranks
+    if (status && online) {
       
-      if (p == 0) {
-        
-        roll::RollMinOnlineVec roll_min_online(xx, n, n_rows_x, width,
-                                               weights, min_obs,
-                                               na_restore,
-                                               rcpp_quantile);
-        roll_min_online();
-        
-      } else if (p == 1) {
-        
-        roll::RollMaxOnlineVec roll_max_online(xx, n, n_rows_x, width,
-                                               weights, min_obs,
+      roll::RollRankOnlineVec roll_rank_online(xx, n, n_rows_x, width,
+                                               weights, ties_w, min_obs,
                                                na_restore,
-                                               rcpp_quantile);
-        roll_max_online();
-        
-      } else {
-        
-        warning("'online' is not supported"); 
-        roll::RollQuantileOfflineVec roll_quantile_offline(xx, n, n_rows_x, width,
-                                                           weights, 1 - p, min_obs,
-                                                           na_restore,
-                                                           rcpp_quantile);
-        parallelFor(0, n_rows_x, roll_quantile_offline);
-        
-      }
+                                               rcpp_rank);
+      roll_rank_online();
       
     } else {
       
-      if (p == 0) {
-        
-        roll::RollMinOfflineVec roll_min_offline(xx, n, n_rows_x, width,
-                                                 weights, min_obs,
-                                                 na_restore,
-                                                 rcpp_quantile);
-        parallelFor(0, n_rows_x, roll_min_offline);
-        
-      } else if (p == 1) {
-        
-        roll::RollMaxOfflineVec roll_max_offline(xx, n, n_rows_x, width,
-                                                 weights, min_obs,
+      roll::RollRankOfflineVec roll_rank_offline(xx, n, n_rows_x, width,
+                                                 weights, ties_w, min_obs,
                                                  na_restore,
-                                                 rcpp_quantile);
-        parallelFor(0, n_rows_x, roll_max_offline);
-        
-      } else {
-        
-        roll::RollQuantileOfflineVec roll_quantile_offline(xx, n, n_rows_x, width,
-                                                           weights, 1 - p, min_obs,
-                                                           na_restore,
-                                                           rcpp_quantile);
-        parallelFor(0, n_rows_x, roll_quantile_offline);
-        
-      }
+                                                 rcpp_rank);
+      parallelFor(0, n_rows_x, roll_rank_offline);
       
     }
     
     // create and return a vector object
-    NumericVector result(rcpp_quantile);
+    NumericVector result(rcpp_rank);
     result.attr("dim") = R_NilValue;
     List names = xx.attr("names");
     if (names.size() > 0) {
@@ -1257,7 +3159,8 @@ SEXP roll_quantile(const SEXP& x, const int& width,
 SEXP roll_var(const SEXP& x, const int& width,
               const arma::vec& weights, const bool& center,
               const int& min_obs, const bool& complete_obs,
-              const bool& na_restore, const bool& online) {
+              const bool& na_restore, const bool& online,
+              const int& reanchor, const std::string& precision) {
   
   if (Rf_isMatrix(x)) {
     
@@ -1267,6 +3170,7 @@ SEXP roll_var(const SEXP& x, const int& width,
     int n_cols_x = xx.ncol();
     arma::uvec arma_any_na(n_rows_x);
     arma::mat arma_var(n_rows_x, n_cols_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -1274,12 +3178,22 @@ SEXP roll_var(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'false',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -1289,13 +3203,68 @@ SEXP roll_var(const SEXP& x, const int& width,
     }
     
     // compute rolling variances
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollVarOnlineMat roll_var_online(xx, n, n_rows_x, n_cols_x, width,
-                                             weights, center, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollVarLinearMat roll_var_linear(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                             width, weights, center, min_obs,
+                                             arma_any_na, na_restore,
+                                             arma_var);
+      parallelFor(0, n_cols_x * n_chunks, roll_var_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_cols_x * n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollVarOnlineMat<roll::RollAccumCompensated> roll_var_online(xx, n, n_rows_x,
+                                                                           n_cols_x, n_rows_chunk,
+                                                                           width, weights, center,
+                                                                           min_obs, arma_any_na,
+                                                                           na_restore, reanchor,
+                                                                           arma_var, arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_var_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollVarOnlineMat<roll::RollAccumDouble> roll_var_online(xx, n, n_rows_x, n_cols_x,
+                                                                      n_rows_chunk, width, weights,
+                                                                      center, min_obs, arma_any_na,
+                                                                      na_restore, reanchor,
+                                                                      arma_var, arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_var_online);
+        
+      } else {
+        
+        roll::RollVarOnlineMat<roll::RollAccumLongDouble> roll_var_online(xx, n, n_rows_x, n_cols_x,
+                                                                          n_rows_chunk, width,
+                                                                          weights, center, min_obs,
+                                                                          arma_any_na, na_restore,
+                                                                          reanchor, arma_var,
+                                                                          arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_var_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollVarPrefixMat roll_var_prefix(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                             width, weights, center, min_obs,
                                              arma_any_na, na_restore,
                                              arma_var);
-      parallelFor(0, n_cols_x, roll_var_online);
+      parallelFor(0, n_cols_x * n_chunks, roll_var_prefix);
       
     } else {
       
@@ -1318,6 +3287,11 @@ SEXP roll_var(const SEXP& x, const int& width,
     result.attr("tzone") = xx.attr("tzone");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums of each column
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, n_cols_x);
+    }
+    
     return result;
     
   } else {
@@ -1326,6 +3300,7 @@ SEXP roll_var(const SEXP& x, const int& width,
     int n = weights.size();
     int n_rows_x = xx.size();
     arma::vec arma_var(n_rows_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -1333,20 +3308,82 @@ SEXP roll_var(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // compute rolling variances
-    if (status && online) {
+    if (status && online && status_lin) {
       
-      roll::RollVarOnlineVec roll_var_online(xx, n, n_rows_x, width,
-                                             weights, center, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollVarLinearVec roll_var_linear(xx, n, n_rows_x, n_rows_chunk,
+                                             width, weights, center, min_obs,
+                                             na_restore,
+                                             arma_var);
+      parallelFor(0, n_chunks, roll_var_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollVarOnlineVec<roll::RollAccumCompensated> roll_var_online(xx, n, n_rows_x,
+                                                                           n_rows_chunk, width,
+                                                                           weights, center, min_obs,
+                                                                           na_restore, reanchor,
+                                                                           arma_var, arma_reanchor);
+        parallelFor(0, n_chunks, roll_var_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollVarOnlineVec<roll::RollAccumDouble> roll_var_online(xx, n, n_rows_x, n_rows_chunk,
+                                                                      width, weights, center,
+                                                                      min_obs, na_restore, reanchor,
+                                                                      arma_var, arma_reanchor);
+        parallelFor(0, n_chunks, roll_var_online);
+        
+      } else {
+        
+        roll::RollVarOnlineVec<roll::RollAccumLongDouble> roll_var_online(xx, n, n_rows_x,
+                                                                          n_rows_chunk, width,
+                                                                          weights, center, min_obs,
+                                                                          na_restore, reanchor,
+                                                                          arma_var, arma_reanchor);
+        parallelFor(0, n_chunks, roll_var_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollVarPrefixVec roll_var_prefix(xx, n, n_rows_x, n_rows_chunk,
+                                             width, weights, center, min_obs,
                                              na_restore,
                                              arma_var);
-      roll_var_online();
+      parallelFor(0, n_chunks, roll_var_prefix);
       
     } else {
       
@@ -1368,6 +3405,11 @@ SEXP roll_var(const SEXP& x, const int& width,
     result.attr("index") = xx.attr("index");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, 1);
+    }
+    
     return result;
     
   }
@@ -1378,7 +3420,8 @@ SEXP roll_var(const SEXP& x, const int& width,
 SEXP roll_sd(const SEXP& x, const int& width,
              const arma::vec& weights, const bool& center,
              const int& min_obs, const bool& complete_obs,
-             const bool& na_restore, const bool& online) {
+             const bool& na_restore, const bool& online,
+             const int& reanchor, const std::string& precision) {
   
   if (Rf_isMatrix(x)) {
     
@@ -1388,6 +3431,7 @@ SEXP roll_sd(const SEXP& x, const int& width,
     int n_cols_x = xx.ncol();
     arma::uvec arma_any_na(n_rows_x);
     arma::mat arma_sd(n_rows_x, n_cols_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -1395,12 +3439,22 @@ SEXP roll_sd(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'false',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -1410,13 +3464,68 @@ SEXP roll_sd(const SEXP& x, const int& width,
     }
     
     // compute rolling standard deviations
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSdLinearMat roll_sd_linear(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                           width, weights, center, min_obs,
+                                           arma_any_na, na_restore,
+                                           arma_sd);
+      parallelFor(0, n_cols_x * n_chunks, roll_sd_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_cols_x * n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollSdOnlineMat<roll::RollAccumCompensated> roll_sd_online(xx, n, n_rows_x, n_cols_x,
+                                                                         n_rows_chunk, width,
+                                                                         weights, center, min_obs,
+                                                                         arma_any_na, na_restore,
+                                                                         reanchor, arma_sd,
+                                                                         arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sd_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSdOnlineMat<roll::RollAccumDouble> roll_sd_online(xx, n, n_rows_x, n_cols_x,
+                                                                    n_rows_chunk, width, weights,
+                                                                    center, min_obs, arma_any_na,
+                                                                    na_restore, reanchor, arma_sd,
+                                                                    arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sd_online);
+        
+      } else {
+        
+        roll::RollSdOnlineMat<roll::RollAccumLongDouble> roll_sd_online(xx, n, n_rows_x, n_cols_x,
+                                                                        n_rows_chunk, width,
+                                                                        weights, center, min_obs,
+                                                                        arma_any_na, na_restore,
+                                                                        reanchor, arma_sd,
+                                                                        arma_reanchor);
+        parallelFor(0, n_cols_x * n_chunks, roll_sd_online);
+        
+      }
+      
+    } else if (status_eq) {
       
-      roll::RollSdOnlineMat roll_sd_online(xx, n, n_rows_x, n_cols_x, width,
-                                           weights, center, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, n_cols_x);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSdPrefixMat roll_sd_prefix(xx, n, n_rows_x, n_cols_x, n_rows_chunk,
+                                           width, weights, center, min_obs,
                                            arma_any_na, na_restore,
                                            arma_sd);
-      parallelFor(0, n_cols_x, roll_sd_online);
+      parallelFor(0, n_cols_x * n_chunks, roll_sd_prefix);
       
     } else {
       
@@ -1439,6 +3548,11 @@ SEXP roll_sd(const SEXP& x, const int& width,
     result.attr("tzone") = xx.attr("tzone");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums of each column
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, n_cols_x);
+    }
+    
     return result;
     
   } else {
@@ -1447,6 +3561,7 @@ SEXP roll_sd(const SEXP& x, const int& width,
     int n = weights.size();
     int n_rows_x = xx.size();
     arma::vec arma_sd(n_rows_x);
+    arma::vec arma_reanchor;
     
     // check 'width' argument for errors
     check_width(width);
@@ -1454,20 +3569,82 @@ SEXP roll_sd(const SEXP& x, const int& width,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_x(n_rows_x, width, weights);
-    bool status = check_lambda(weights, n_rows_x, width, online);
+    bool status = check_lambda(weights, n_rows_x, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // compute rolling standard deviations
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSdLinearVec roll_sd_linear(xx, n, n_rows_x, n_rows_chunk,
+                                           width, weights, center, min_obs,
+                                           na_restore,
+                                           arma_sd);
+      parallelFor(0, n_chunks, roll_sd_linear);
+      
+    } else if (status && online) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      arma_reanchor.zeros(n_chunks);
+      
+      if (precision_x == 1) {
+        
+        roll::RollSdOnlineVec<roll::RollAccumCompensated> roll_sd_online(xx, n, n_rows_x,
+                                                                         n_rows_chunk, width,
+                                                                         weights, center, min_obs,
+                                                                         na_restore, reanchor,
+                                                                         arma_sd, arma_reanchor);
+        parallelFor(0, n_chunks, roll_sd_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollSdOnlineVec<roll::RollAccumDouble> roll_sd_online(xx, n, n_rows_x, n_rows_chunk,
+                                                                    width, weights, center, min_obs,
+                                                                    na_restore, reanchor, arma_sd,
+                                                                    arma_reanchor);
+        parallelFor(0, n_chunks, roll_sd_online);
+        
+      } else {
+        
+        roll::RollSdOnlineVec<roll::RollAccumLongDouble> roll_sd_online(xx, n, n_rows_x,
+                                                                        n_rows_chunk, width,
+                                                                        weights, center, min_obs,
+                                                                        na_restore, reanchor,
+                                                                        arma_sd, arma_reanchor);
+        parallelFor(0, n_chunks, roll_sd_online);
+        
+      }
+      
+    } else if (status_eq) {
       
-      roll::RollSdOnlineVec roll_sd_online(xx, n, n_rows_x, width,
-                                           weights, center, min_obs,
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_x, 1);
+      int n_chunks = std::ceil((double)n_rows_x / n_rows_chunk);
+      
+      roll::RollSdPrefixVec roll_sd_prefix(xx, n, n_rows_x, n_rows_chunk,
+                                           width, weights, center, min_obs,
                                            na_restore,
                                            arma_sd);
-      roll_sd_online();
+      parallelFor(0, n_chunks, roll_sd_prefix);
       
     } else {
       
@@ -1489,6 +3666,11 @@ SEXP roll_sd(const SEXP& x, const int& width,
     result.attr("index") = xx.attr("index");
     result.attr("class") = xx.attr("class");
     
+    // maximum correction of the running sums
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, 1);
+    }
+    
     return result;
     
   }
@@ -1622,6 +3804,7 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
                 const bool& center, const bool& scale,
                 const int& min_obs, const bool& complete_obs,
                 const bool& na_restore, const bool& online,
+                const int& reanchor, const std::string& precision,
                 const bool& symmetric) {
   
   if (Rf_isMatrix(x) && Rf_isMatrix(y)) {
@@ -1634,6 +3817,7 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     int n_cols_y = yy.ncol();
     arma::uvec arma_any_na(n_rows_xy);
     arma::cube arma_cov(n_cols_x, n_cols_y, n_rows_xy);
+    arma::mat arma_reanchor;
     
     // check 'x' and 'y' arguments for errors
     check_lm(n_rows_xy, yy.nrow());
@@ -1644,12 +3828,22 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_xy(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'true',
     // otherwise check argument for errors
     if (complete_obs && symmetric) {
@@ -1661,28 +3855,118 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     }
     
     // compute rolling covariances
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovLinearMatXY roll_cov_linear(xx, yy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, symmetric, min_obs,
+                                               arma_any_na, na_restore,
+                                               arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
       
       if (symmetric) {
         
         // y is null
-        roll::RollCovOnlineMatXX roll_cov_online(xx, n, n_rows_xy, n_cols_x, width,
-                                                 weights, center, scale, min_obs,
-                                                 arma_any_na, na_restore,
-                                                 arma_cov);
-        parallelFor(0, n_cols_x, roll_cov_online);
+        arma_reanchor.zeros(n_cols_x, n_cols_y);
+        
+        if (precision_x == 1) {
+          
+          roll::RollCovOnlineMatXX<roll::RollAccumCompensated> roll_cov_online(xx, n, n_rows_xy,
+                                                                               n_cols_x, width,
+                                                                               weights, center,
+                                                                               scale, min_obs,
+                                                                               arma_any_na,
+                                                                               na_restore, reanchor,
+                                                                               arma_cov,
+                                                                               arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        } else if (precision_x == 2) {
+          
+          roll::RollCovOnlineMatXX<roll::RollAccumDouble> roll_cov_online(xx, n, n_rows_xy,
+                                                                          n_cols_x, width, weights,
+                                                                          center, scale, min_obs,
+                                                                          arma_any_na, na_restore,
+                                                                          reanchor, arma_cov,
+                                                                          arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        } else {
+          
+          roll::RollCovOnlineMatXX<roll::RollAccumLongDouble> roll_cov_online(xx, n, n_rows_xy,
+                                                                              n_cols_x, width,
+                                                                              weights, center,
+                                                                              scale, min_obs,
+                                                                              arma_any_na,
+                                                                              na_restore, reanchor,
+                                                                              arma_cov,
+                                                                              arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        }
         
       } else if (!symmetric) {
         
         // y is not null
-        roll::RollCovOnlineMatXY roll_cov_online(xx, yy, n, n_rows_xy, n_cols_x, n_cols_y, width,
-                                                 weights, center, scale, min_obs,
-                                                 arma_any_na, na_restore,
-                                                 arma_cov);
-        parallelFor(0, n_cols_x, roll_cov_online);
+        arma_reanchor.zeros(n_cols_x, n_cols_y);
+        
+        if (precision_x == 1) {
+          
+          roll::RollCovOnlineMatXY<roll::RollAccumCompensated> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                               n_cols_x, n_cols_y,
+                                                                               width, weights,
+                                                                               center, scale,
+                                                                               min_obs, arma_any_na,
+                                                                               na_restore, reanchor,
+                                                                               arma_cov,
+                                                                               arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        } else if (precision_x == 2) {
+          
+          roll::RollCovOnlineMatXY<roll::RollAccumDouble> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                          n_cols_x, n_cols_y, width,
+                                                                          weights, center, scale,
+                                                                          min_obs, arma_any_na,
+                                                                          na_restore, reanchor,
+                                                                          arma_cov, arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        } else {
+          
+          roll::RollCovOnlineMatXY<roll::RollAccumLongDouble> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                              n_cols_x, n_cols_y,
+                                                                              width, weights,
+                                                                              center, scale,
+                                                                              min_obs, arma_any_na,
+                                                                              na_restore, reanchor,
+                                                                              arma_cov,
+                                                                              arma_reanchor);
+          parallelFor(0, n_cols_x, roll_cov_online);
+          
+        }
         
       }
       
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovPrefixMatXY roll_cov_prefix(xx, yy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, symmetric, min_obs,
+                                               arma_any_na, na_restore,
+                                               arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_prefix);
+      
     } else {
       
       if (symmetric) {
@@ -1720,6 +4004,11 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
       result.attr("dimnames") = List::create(R_NilValue, dimnames_y[1]);
     }
     
+    // maximum correction of the running sums of each pair of columns
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = wrap(arma_reanchor);
+    }
+    
     return result;
     
   } else if (Rf_isMatrix(x)) {
@@ -1736,6 +4025,7 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     int n_cols_y = yyy.ncol();
     arma::uvec arma_any_na(n_rows_xy);
     arma::cube arma_cov(n_cols_x, n_cols_y, n_rows_xy);
+    arma::mat arma_reanchor;
     
     // check 'x' and 'y' arguments for errors
     check_lm(n_rows_xy, yyy.nrow());
@@ -1746,12 +4036,22 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_xy(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'true',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -1761,13 +4061,70 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     }
     
     // compute rolling covariances
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
       
-      roll::RollCovOnlineMatXY roll_cov_online(xx, yyy, n, n_rows_xy, n_cols_x, n_cols_y, width,
-                                               weights, center, scale, min_obs,
+      roll::RollCovLinearMatXY roll_cov_linear(xx, yyy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, false, min_obs,
                                                arma_any_na, na_restore,
                                                arma_cov);
-      parallelFor(0, n_cols_x, roll_cov_online);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
+      
+      arma_reanchor.zeros(n_cols_x, n_cols_y);
+      
+      if (precision_x == 1) {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumCompensated> roll_cov_online(xx, yyy, n, n_rows_xy,
+                                                                             n_cols_x, n_cols_y,
+                                                                             width, weights, center,
+                                                                             scale, min_obs,
+                                                                             arma_any_na,
+                                                                             na_restore, reanchor,
+                                                                             arma_cov,
+                                                                             arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumDouble> roll_cov_online(xx, yyy, n, n_rows_xy,
+                                                                        n_cols_x, n_cols_y, width,
+                                                                        weights, center, scale,
+                                                                        min_obs, arma_any_na,
+                                                                        na_restore, reanchor,
+                                                                        arma_cov, arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      } else {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumLongDouble> roll_cov_online(xx, yyy, n, n_rows_xy,
+                                                                            n_cols_x, n_cols_y,
+                                                                            width, weights, center,
+                                                                            scale, min_obs,
+                                                                            arma_any_na, na_restore,
+                                                                            reanchor, arma_cov,
+                                                                            arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovPrefixMatXY roll_cov_prefix(xx, yyy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, false, min_obs,
+                                               arma_any_na, na_restore,
+                                               arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_prefix);
       
     } else {
       
@@ -1792,6 +4149,11 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
       result.attr("dimnames") = List::create(R_NilValue, dimnames_y[1]);
     }
     
+    // maximum correction of the running sums of each pair of columns
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = wrap(arma_reanchor);
+    }
+    
     return result;
     
   } else if (Rf_isMatrix(y)) {
@@ -1808,6 +4170,7 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     int n_cols_y = yy.ncol();
     arma::uvec arma_any_na(n_rows_xy);
     arma::cube arma_cov(n_cols_x, n_cols_y, n_rows_xy);
+    arma::mat arma_reanchor;
     
     // check 'x' and 'y' arguments for errors
     check_lm(n_rows_xy, yy.nrow());
@@ -1818,12 +4181,22 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_xy(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // default 'complete_obs' argument is 'true',
     // otherwise check argument for errors
     if (complete_obs) {
@@ -1833,13 +4206,70 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     }
     
     // compute rolling covariances
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovLinearMatXY roll_cov_linear(xxx, yy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, false, min_obs,
+                                               arma_any_na, na_restore,
+                                               arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
+      
+      arma_reanchor.zeros(n_cols_x, n_cols_y);
+      
+      if (precision_x == 1) {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumCompensated> roll_cov_online(xxx, yy, n, n_rows_xy,
+                                                                             n_cols_x, n_cols_y,
+                                                                             width, weights, center,
+                                                                             scale, min_obs,
+                                                                             arma_any_na,
+                                                                             na_restore, reanchor,
+                                                                             arma_cov,
+                                                                             arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      } else if (precision_x == 2) {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumDouble> roll_cov_online(xxx, yy, n, n_rows_xy,
+                                                                        n_cols_x, n_cols_y, width,
+                                                                        weights, center, scale,
+                                                                        min_obs, arma_any_na,
+                                                                        na_restore, reanchor,
+                                                                        arma_cov, arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      } else {
+        
+        roll::RollCovOnlineMatXY<roll::RollAccumLongDouble> roll_cov_online(xxx, yy, n, n_rows_xy,
+                                                                            n_cols_x, n_cols_y,
+                                                                            width, weights, center,
+                                                                            scale, min_obs,
+                                                                            arma_any_na, na_restore,
+                                                                            reanchor, arma_cov,
+                                                                            arma_reanchor);
+        parallelFor(0, n_cols_x, roll_cov_online);
+        
+      }
+      
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = symmetric ? n_cols_x * (n_cols_x + 1) / 2 : n_cols_x * n_cols_y;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
       
-      roll::RollCovOnlineMatXY roll_cov_online(xxx, yy, n, n_rows_xy, n_cols_x, n_cols_y, width,
-                                               weights, center, scale, min_obs,
+      roll::RollCovPrefixMatXY roll_cov_prefix(xxx, yy, n, n_rows_xy, n_cols_x, n_cols_y, n_rows_chunk,
+                                               width, weights, center, scale, false, min_obs,
                                                arma_any_na, na_restore,
                                                arma_cov);
-      parallelFor(0, n_cols_x, roll_cov_online);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_prefix);
       
     } else {
       
@@ -1866,6 +4296,11 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
       result.attr("dimnames") = List::create(R_NilValue, dimnames_y[1]);
     }
     
+    // maximum correction of the running sums of each pair of columns
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = wrap(arma_reanchor);
+    }
+    
     return result;
     
   } else {
@@ -1875,6 +4310,7 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     int n = weights.size();
     int n_rows_xy = xx.size();
     arma::vec arma_cov(n_rows_xy);
+    arma::vec arma_reanchor;
     
     // check 'x' and 'y' arguments for errors
     check_lm(n_rows_xy, yy.size());
@@ -1885,35 +4321,123 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_xy(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_eq = all(weights == weights[0]);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
     check_min_obs(min_obs);
     
+    // default 'reanchor' argument is zero (i.e., never),
+    // otherwise check argument for errors
+    check_reanchor(reanchor, online && status_lin);
+    
+    // default 'precision' argument is "long double",
+    // otherwise check argument for errors
+    int precision_x = check_precision(precision);
+    
     // compute rolling covariances
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_xy, 1);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovLinearVecXY roll_cov_linear(xx, yy, n, n_rows_xy, n_rows_chunk,
+                                               width, weights, center, scale, min_obs,
+                                               na_restore,
+                                               arma_cov);
+      parallelFor(0, n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
       
       if (symmetric) {
         
         // y is null
-        roll::RollCovOnlineVecXX roll_cov_online(xx, n, n_rows_xy, width,
-                                                 weights, center, scale, min_obs,
-                                                 na_restore,
-                                                 arma_cov);
-        roll_cov_online();
+        arma_reanchor.zeros(1);
+        
+        if (precision_x == 1) {
+          
+          roll::RollCovOnlineVecXX<roll::RollAccumCompensated> roll_cov_online(xx, n, n_rows_xy,
+                                                                               width, weights,
+                                                                               center, scale,
+                                                                               min_obs, na_restore,
+                                                                               reanchor, arma_cov,
+                                                                               arma_reanchor);
+          roll_cov_online();
+          
+        } else if (precision_x == 2) {
+          
+          roll::RollCovOnlineVecXX<roll::RollAccumDouble> roll_cov_online(xx, n, n_rows_xy, width,
+                                                                          weights, center, scale,
+                                                                          min_obs, na_restore,
+                                                                          reanchor, arma_cov,
+                                                                          arma_reanchor);
+          roll_cov_online();
+          
+        } else {
+          
+          roll::RollCovOnlineVecXX<roll::RollAccumLongDouble> roll_cov_online(xx, n, n_rows_xy,
+                                                                              width, weights,
+                                                                              center, scale,
+                                                                              min_obs, na_restore,
+                                                                              reanchor, arma_cov,
+                                                                              arma_reanchor);
+          roll_cov_online();
+          
+        }
         
       } else if (!symmetric) {
         
         // y is not null
-        roll::RollCovOnlineVecXY roll_cov_online(xx, yy, n, n_rows_xy, width,
-                                                 weights, center, scale, min_obs,
-                                                 na_restore,
-                                                 arma_cov);
-        roll_cov_online();
+        arma_reanchor.zeros(1);
+        
+        if (precision_x == 1) {
+          
+          roll::RollCovOnlineVecXY<roll::RollAccumCompensated> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                               width, weights,
+                                                                               center, scale,
+                                                                               min_obs, na_restore,
+                                                                               reanchor, arma_cov,
+                                                                               arma_reanchor);
+          roll_cov_online();
+          
+        } else if (precision_x == 2) {
+          
+          roll::RollCovOnlineVecXY<roll::RollAccumDouble> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                          width, weights, center,
+                                                                          scale, min_obs,
+                                                                          na_restore, reanchor,
+                                                                          arma_cov, arma_reanchor);
+          roll_cov_online();
+          
+        } else {
+          
+          roll::RollCovOnlineVecXY<roll::RollAccumLongDouble> roll_cov_online(xx, yy, n, n_rows_xy,
+                                                                              width, weights,
+                                                                              center, scale,
+                                                                              min_obs, na_restore,
+                                                                              reanchor, arma_cov,
+                                                                              arma_reanchor);
+          roll_cov_online();
+          
+        }
         
       }
       
+    } else if (status_eq) {
+      
+      // chunks of rows if there are fewer columns than threads
+      int n_rows_chunk = check_chunk(width, n_rows_xy, 1);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCovPrefixVecXY roll_cov_prefix(xx, yy, n, n_rows_xy, n_rows_chunk,
+                                               width, weights, center, scale, min_obs,
+                                               na_restore,
+                                               arma_cov);
+      parallelFor(0, n_chunks, roll_cov_prefix);
+      
     } else {
       
       if (symmetric) {
@@ -1942,6 +4466,11 @@ SEXP roll_cov_z(const SEXP& x, const SEXP& y,
     NumericVector result(wrap(arma_cov));
     result.attr("dim") = R_NilValue;
     
+    // maximum correction of the running sums
+    if ((reanchor > 0) && (arma_reanchor.size() > 0)) {
+      result.attr("reanchor") = reanchor_x(arma_reanchor, 1);
+    }
+    
     return result;
     
   }
@@ -1953,17 +4482,18 @@ SEXP roll_cov(const SEXP& x, const SEXP& y,
               const int& width, const arma::vec& weights,
               const bool& center, const bool& scale,
               const int& min_obs, const bool& complete_obs,
-              const bool& na_restore, const bool& online) {
+              const bool& na_restore, const bool& online,
+              const int& reanchor, const std::string& precision) {
   
   if (Rf_isNull(y)) {
     
     return roll_cov_z(x, x, width, weights, center, scale, min_obs, complete_obs, 
-                      na_restore, online, true);
+                      na_restore, online, reanchor, precision, true);
     
   } else {
     
     return roll_cov_z(x, y, width, weights, center, scale, min_obs, complete_obs, 
-                      na_restore, online, false);
+                      na_restore, online, reanchor, precision, false);
     
   }
   
@@ -2355,7 +4885,8 @@ List roll_lm_z(const SEXP& x, const NumericVector& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_lm(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
@@ -2378,7 +4909,21 @@ List roll_lm_z(const SEXP& x, const NumericVector& y,
     }
     
     // compute rolling crossproducts
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = n_cols_x * (n_cols_x + 1) / 2;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCrossProdLinearMatXX roll_cov_linear(data, n, n_rows_xy, n_cols_x, n_rows_chunk,
+                                                     width, weights, intercept, false, min_obs,
+                                                     arma_any_na, na_restore,
+                                                     arma_n_obs, arma_sum_w, arma_mean,
+                                                     arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
       
       roll::RollCrossProdOnlineMatXX roll_cov_online(data, n, n_rows_xy, n_cols_x, width,
                                                      weights, intercept, false, min_obs,
@@ -2453,7 +4998,8 @@ List roll_lm_z(const SEXP& x, const NumericVector& y,
     // default 'weights' argument is equal-weighted,
     // otherwise check argument for errors
     check_weights_lm(n_rows_xy, width, weights);
-    bool status = check_lambda(weights, n_rows_xy, width, online);
+    bool status = check_lambda(weights, n_rows_xy, width, online, true);
+    bool status_lin = status && check_linear(weights);
     
     // default 'min_obs' argument is 'width',
     // otherwise check argument for errors
@@ -2476,7 +5022,21 @@ List roll_lm_z(const SEXP& x, const NumericVector& y,
     }
     
     // compute rolling crossproducts
-    if (status && online) {
+    if (status && online && status_lin) {
+      
+      // chunks of rows if there are fewer pairs of columns than threads
+      int n_pairs = n_cols_x * (n_cols_x + 1) / 2;
+      int n_rows_chunk = check_chunk(width, n_rows_xy, n_pairs);
+      int n_chunks = std::ceil((double)n_rows_xy / n_rows_chunk);
+      
+      roll::RollCrossProdLinearMatXX roll_cov_linear(data, n, n_rows_xy, n_cols_x, n_rows_chunk,
+                                                     width, weights, intercept, false, min_obs,
+                                                     arma_any_na, na_restore,
+                                                     arma_n_obs, arma_sum_w, arma_mean,
+                                                     arma_cov);
+      parallelFor(0, n_pairs * n_chunks, roll_cov_linear);
+      
+    } else if (status && online) {
       
       roll::RollCrossProdOnlineMatXX roll_cov_online(data, n, n_rows_xy, n_cols_x, width,
                                                      weights, intercept, false, min_obs,
@@ -3022,3 +5582,410 @@ List roll_lm(const SEXP& x, const SEXP& y,
   }
   
 }
+
+void check_state_type(const std::string& type) {
+  
+  if ((type != "sum") && (type != "mean") && (type != "var") && (type != "sd") &&
+      (type != "scale") && (type != "cov") && (type != "crossprod") && (type != "lm") &&
+      (type != "min") && (type != "max")) {
+    stop("value of 'type' must be \"sum\", \"mean\", \"var\", \"sd\", \"scale\", \"cov\", \"crossprod\", \"lm\", \"min\", or \"max\"");
+  }
+  
+}
+
+// rows of 'x' for the state, where a vector is either a column or, if there
+// are more columns in the state, one row
+arma::mat check_state_x(const SEXP& x, const int& n_cols_x, const std::string& name) {
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    
+    if (xx.ncol() != n_cols_x) {
+      stop("number of columns in '" + name + "' must equal the number of columns in 'state'");
+    }
+    
+    return arma::mat(xx.begin(), xx.nrow(), xx.ncol());
+    
+  }
+  
+  NumericVector xx(x);
+  
+  if (n_cols_x == 1) {
+    return arma::mat(xx.begin(), xx.size(), 1);
+  } else if (xx.size() != n_cols_x) {
+    stop("length of '" + name + "' must equal the number of columns in 'state'");
+  }
+  
+  return arma::mat(xx.begin(), 1, n_cols_x);
+  
+}
+
+// 'x' and 'y' (if applicable) by column, i.e., 'y' is the last column for "lm"
+arma::mat check_state_data(const roll::RollState& state, const SEXP& x, const SEXP& y) {
+  
+  bool status_lm = (state.type == "lm");
+  int n_cols_x = status_lm ? state.n_cols_x - 1 : state.n_cols_x;
+  arma::mat data = check_state_x(x, n_cols_x, "x");
+  
+  if (status_lm || !state.symmetric) {
+    
+    if (Rf_isNull(y)) {
+      stop("'y' must be supplied if it was supplied to 'roll_state_init'");
+    }
+    
+    arma::mat data_y = check_state_x(y, status_lm ? 1 : state.n_cols_y, "y");
+    
+    // check 'x' and 'y' arguments for errors
+    check_lm(data.n_rows, data_y.n_rows);
+    
+    data = arma::join_rows(data, data_y);
+    
+  } else if (!Rf_isNull(y)) {
+    stop("'y' must be NULL if it was NULL in 'roll_state_init'");
+  }
+  
+  return data;
+  
+}
+
+std::vector<std::string> names_state(const SEXP& x) {
+  
+  std::vector<std::string> result;
+  
+  if (Rf_isMatrix(x)) {
+    
+    NumericMatrix xx(x);
+    List dimnames = xx.attr("dimnames");
+    
+    if ((dimnames.size() > 1) && !Rf_isNull(dimnames[1])) {
+      result = as<std::vector<std::string> >(dimnames[1]);
+    }
+    
+  }
+  
+  return result;
+  
+}
+
+// [[Rcpp::export(.roll_state_init)]]
+SEXP roll_state_init(const SEXP& x, const SEXP& y,
+                     const std::string& type, const int& width,
+                     const arma::vec& weights, const bool& center,
+                     const bool& scale, const bool& intercept,
+                     const int& min_obs, const bool& complete_obs,
+                     const bool& na_restore) {
+  
+  // check 'type' argument for errors
+  check_state_type(type);
+  bool status_lm = (type == "lm");
+  bool status_pair = (type == "cov") || (type == "crossprod");
+  
+  // check 'width' argument for errors
+  check_width(width);
+  
+  // default 'weights' argument is equal-weighted,
+  // otherwise check argument for errors (i.e., the window is rolling)
+  check_weights_x(width, width, weights);
+  if (!check_lambda(weights, width + 1, width, false)) {
+    stop("'state' is only supported for equal or exponential decay 'weights'");
+  }
+  
+  // default 'min_obs' argument is 'width',
+  // otherwise check argument for errors
+  check_min_obs(min_obs);
+  
+  if (!Rf_isNull(y) && !status_lm && !status_pair) {
+    stop("'y' is only supported for \"cov\", \"crossprod\", or \"lm\"");
+  } else if (Rf_isNull(y) && status_lm) {
+    stop("'y' must be supplied for \"lm\"");
+  } else if (status_lm && Rf_isMatrix(y) && (NumericMatrix(y).ncol() != 1)) {
+    stop("number of columns in 'y' must equal one for \"lm\"");
+  }
+  
+  if (status_lm && !complete_obs) {
+    warning("'complete_obs = FALSE' is not supported");
+  }
+  
+  int n_cols_x = Rf_isMatrix(x) ? NumericMatrix(x).ncol() : 1;
+  int n_cols_y = (Rf_isNull(y) || status_lm) ? 0 : (Rf_isMatrix(y) ? NumericMatrix(y).ncol() : 1);
+  bool symmetric = Rf_isNull(y) || status_lm;
+  
+  // cbind x and y variables for "lm", where 'intercept' is centering
+  XPtr<roll::RollState> result(new roll::RollState(type, width, weights,
+                                                   status_lm ? intercept : center,
+                                                   status_lm ? false : scale,
+                                                   intercept, min_obs,
+                                                   status_lm ? true : complete_obs,
+                                                   na_restore, !Rf_isMatrix(x),
+                                                   symmetric,
+                                                   status_lm ? n_cols_x + 1 : n_cols_x,
+                                                   n_cols_y), true);
+  result->names_x = names_state(x);
+  result->names_y = names_state(y);
+  
+  // compute the state of the history (i.e., without the statistics)
+  arma::mat data = check_state_data(*result, x, y);
+  arma::mat arma_value;
+  arma::cube arma_cov;
+  arma::vec arma_n_obs;
+  arma::vec arma_sum_w;
+  arma::mat arma_mean;
+  
+  roll::update_state(*result, data, false, arma_value, arma_cov,
+                     arma_n_obs, arma_sum_w, arma_mean);
+  
+  result.attr("class") = "roll_state";
+  
+  return result;
+  
+}
+
+// [[Rcpp::export(.roll_update)]]
+SEXP roll_update(const SEXP& state, const SEXP& x, const SEXP& y) {
+  
+  XPtr<roll::RollState> ptr(state);
+  roll::RollState& st = *ptr.checked_get();
+  
+  bool status_lm = (st.type == "lm");
+  bool status_pair = (st.type == "cov") || (st.type == "crossprod");
+  arma::mat data = check_state_data(st, x, y);
+  int n_rows_xy = data.n_rows;
+  int n_cols_x = st.n_cols_x;
+  int n_cols_y = st.symmetric ? st.n_cols_x : st.n_cols_y;
+  arma::mat arma_value(n_rows_xy, (status_lm || status_pair) ? 0 : n_cols_x);
+  arma::cube arma_cov((status_lm || status_pair) ? n_cols_x : 0,
+                      (status_lm || status_pair) ? n_cols_y : 0, n_rows_xy);
+  arma::vec arma_n_obs(n_rows_xy);
+  arma::vec arma_sum_w(n_rows_xy);
+  arma::mat arma_mean(n_rows_xy, status_lm ? n_cols_x : 0);
+  
+  // compute the statistics of the new rows
+  roll::update_state(st, data, true, arma_value, arma_cov,
+                     arma_n_obs, arma_sum_w, arma_mean);
+  
+  // row names and xts attributes of the new rows
+  SEXP rownames = R_NilValue;
+  
+  if (Rf_isMatrix(x)) {
+    
+    List dimnames_x = Rf_getAttrib(x, R_DimNamesSymbol);
+    
+    if (dimnames_x.size() > 1) {
+      rownames = dimnames_x[0];
+    }
+    
+  }
+  
+  if (status_pair) {
+    
+    // create and return a matrix
+    NumericVector result(wrap(arma_cov));
+    result.attr("dim") = IntegerVector::create(n_cols_x, n_cols_y, n_rows_xy);
+    std::vector<std::string> names_y = st.symmetric ? st.names_x : st.names_y;
+    if ((st.names_x.size() > 0) && (names_y.size() > 0)) {
+      result.attr("dimnames") = List::create(wrap(st.names_x), wrap(names_y));
+    } else if (st.names_x.size() > 0) {
+      result.attr("dimnames") = List::create(wrap(st.names_x), R_NilValue);
+    } else if (names_y.size() > 0) {
+      result.attr("dimnames") = List::create(R_NilValue, wrap(names_y));
+    }
+    
+    return result;
+    
+  } else if (status_lm) {
+    
+    int n_cols_coef = st.intercept ? n_cols_x : n_cols_x - 1;
+    arma::vec arma_rsq(n_rows_xy);
+    arma::mat arma_coef(n_rows_xy, n_cols_coef);
+    arma::mat arma_se(n_rows_xy, n_cols_coef);
+    
+    // compute rolling linear models
+    if (st.intercept) {
+      
+      roll::RollLmMatInterceptTRUE roll_lm_slices(arma_cov, st.width, n_rows_xy, n_cols_x, st.width,
+                                                  arma_n_obs, arma_sum_w, arma_mean,
+                                                  arma_coef, arma_rsq, arma_se);
+      parallelFor(0, n_rows_xy, roll_lm_slices);
+      
+    } else {
+      
+      roll::RollLmMatInterceptFALSE roll_lm_slices(arma_cov, st.width, n_rows_xy, n_cols_x, st.width,
+                                                   arma_n_obs, arma_sum_w,
+                                                   arma_coef, arma_rsq, arma_se);
+      parallelFor(0, n_rows_xy, roll_lm_slices);
+      
+    }
+    
+    List dimnames_x;
+    if (st.names_x.size() > 0) {
+      dimnames_x = List::create(rownames, wrap(st.names_x));
+    }
+    
+    // create and return a matrix or xts object for coefficients
+    NumericVector coef(wrap(arma_coef));
+    coef.attr("dim") = IntegerVector::create(n_rows_xy, n_cols_coef);
+    coef.attr("dimnames") = dimnames_lm_x(dimnames_x, n_cols_coef, st.intercept);
+    
+    // create and return a matrix or xts object for r-squareds
+    NumericVector rsq(wrap(arma_rsq));
+    rsq.attr("dim") = IntegerVector::create(n_rows_xy, 1);
+    rsq.attr("dimnames") = List::create(rownames, "R-squared");
+    
+    // create and return a matrix or xts object for standard errors
+    NumericVector se(wrap(arma_se));
+    se.attr("dim") = IntegerVector::create(n_rows_xy, n_cols_coef);
+    se.attr("dimnames") = coef.attr("dimnames");
+    
+    if (Rf_isMatrix(x)) {
+      
+      NumericMatrix xx(x);
+      List result_ls = List::create(coef, rsq, se);
+      
+      for (int z = 0; z < 3; z++) {
+        
+        NumericVector result_z = result_ls[z];
+        result_z.attr("index") = xx.attr("index");
+        result_z.attr(".indexCLASS") = xx.attr(".indexCLASS");
+        result_z.attr(".indexTZ") = xx.attr(".indexTZ");
+        result_z.attr("tclass") = xx.attr("tclass");
+        result_z.attr("tzone") = xx.attr("tzone");
+        result_z.attr("class") = xx.attr("class");
+        
+      }
+      
+    }
+    
+    // create and return a list
+    return List::create(Named("coefficients") = coef,
+                        Named("r.squared") = rsq,
+                        Named("std.error") = se);
+    
+  } else if (st.status_vec) {
+    
+    // create and return a vector object
+    NumericVector result(wrap(arma_value));
+    result.attr("dim") = R_NilValue;
+    if (!Rf_isMatrix(x)) {
+      
+      NumericVector xx(x);
+      List names = xx.attr("names");
+      if (names.size() > 0) {
+        result.attr("names") = names;
+      }
+      result.attr("index") = xx.attr("index");
+      result.attr("class") = xx.attr("class");
+      
+    }
+    
+    return result;
+    
+  } else {
+    
+    // create and return a matrix or xts object
+    NumericMatrix result(wrap(arma_value));
+    if (st.names_x.size() > 0) {
+      result.attr("dimnames") = List::create(rownames, wrap(st.names_x));
+    } else if (!Rf_isNull(rownames)) {
+      result.attr("dimnames") = List::create(rownames, R_NilValue);
+    }
+    if (Rf_isMatrix(x)) {
+      
+      NumericMatrix xx(x);
+      result.attr("index") = xx.attr("index");
+      result.attr(".indexCLASS") = xx.attr(".indexCLASS");
+      result.attr(".indexTZ") = xx.attr(".indexTZ");
+      result.attr("tclass") = xx.attr("tclass");
+      result.attr("tzone") = xx.attr("tzone");
+      result.attr("class") = xx.attr("class");
+      
+    }
+    
+    return result;
+    
+  }
+  
+}
+
+// [[Rcpp::export(.roll_state_save)]]
+RawVector roll_state_save(const SEXP& state) {
+  
+  XPtr<roll::RollState> ptr(state);
+  std::vector<unsigned char> bytes = roll::save_state(*ptr.checked_get());
+  
+  return RawVector(bytes.begin(), bytes.end());
+  
+}
+
+// [[Rcpp::export(.roll_state_load)]]
+SEXP roll_state_load(const RawVector& x) {
+  
+  XPtr<roll::RollState> result(new roll::RollState(), true);
+  roll::load_state(*result, RAW(x), x.size());
+  
+  result.attr("class") = "roll_state";
+  
+  return result;
+  
+}
+
+// [[Rcpp::export(.roll_state_merge)]]
+SEXP roll_state_merge(const List& states) {
+  
+  int n_states = states.size();
+  
+  if (n_states < 1) {
+    stop("number of states must be greater than zero");
+  }
+  
+  std::vector<roll::RollState*> ptrs(n_states);
+  
+  for (int z = 0; z < n_states; z++) {
+    
+    XPtr<roll::RollState> ptr(states[z]);
+    ptrs[z] = ptr.checked_get();
+    
+  }
+  
+  const roll::RollState& first = *ptrs[0];
+  int n_rows = 0;
+  
+  // check states for errors, i.e., same arguments and expanding windows
+  if ((first.type != "sum") && (first.type != "mean") && (first.type != "var") &&
+      (first.type != "sd") && (first.type != "cov") && (first.type != "crossprod")) {
+    stop("value of 'type' must be \"sum\", \"mean\", \"var\", \"sd\", \"cov\", or \"crossprod\" to merge states");
+  }
+  
+  for (int z = 0; z < n_states; z++) {
+    
+    const roll::RollState& st = *ptrs[z];
+    
+    if ((st.type != first.type) || (st.width != first.width) ||
+        (st.min_obs != first.min_obs) || (st.complete_obs != first.complete_obs) ||
+        (st.na_restore != first.na_restore) || (st.center != first.center) ||
+        (st.scale != first.scale) || (st.symmetric != first.symmetric) ||
+        (st.n_cols_x != first.n_cols_x) || (st.n_cols_y != first.n_cols_y) ||
+        (st.lambda != first.lambda) || (st.w_new != first.w_new)) {
+      stop("arguments of each state must equal the arguments of the first state");
+    }
+    
+    n_rows += st.n_rows;
+    
+  }
+  
+  if (n_rows > first.width) {
+    stop("total number of rows must be less than or equal to 'width', i.e., expanding windows");
+  }
+  
+  // combine the states in order (i.e., a copy of the first state)
+  XPtr<roll::RollState> result(new roll::RollState(first), true);
+  
+  for (int z = 1; z < n_states; z++) {
+    roll::merge_state(*result, *ptrs[z]);
+  }
+  
+  result.attr("class") = "roll_state";
+  
+  return result;
+  
+}
@@ -0,0 +1,74 @@
+#include "roll.h"
+
+// kernels of the templates in 'roll_kernel.h' that are compared with
+// 'roll_sum' and 'roll_max' in the tests (i.e., not exported to users)
+
+// sum with 'remove' and 'scale' for 'roll::roll_kernel'
+struct RollSumKernel {
+  
+  long double sum_x = 0;
+  
+  void add(const double x, const long double weight) {
+    sum_x += weight * x;
+  }
+  
+  void remove(const double x, const long double weight) {
+    sum_x -= weight * x;
+  }
+  
+  void scale(const long double lambda) {
+    sum_x *= lambda;
+  }
+  
+  double value() const {
+    return sum_x;
+  }
+  
+};
+
+// maximum with 'combine' for 'roll::roll_kernel_combine', where 'weights'
+// are ignored as in 'roll_max'
+struct RollMaxKernel {
+  
+  double max_x = R_NegInf;
+  
+  void add(const double x, const long double weight) {
+    max_x = std::max(max_x, x);
+  }
+  
+  double value() const {
+    return max_x;
+  }
+  
+  static RollMaxKernel combine(const RollMaxKernel& a, const RollMaxKernel& b) {
+    
+    RollMaxKernel result;
+    result.max_x = std::max(a.max_x, b.max_x);
+    
+    return result;
+    
+  }
+  
+};
+
+// [[Rcpp::export(.roll_kernel_sum)]]
+SEXP roll_kernel_sum(const SEXP& x, const int& width,
+                     const arma::vec& weights, const int& min_obs,
+                     const bool& complete_obs, const bool& na_restore,
+                     const bool& online) {
+  
+  return roll::roll_kernel<RollSumKernel>(x, width, weights, min_obs,
+                                          complete_obs, na_restore, online);
+  
+}
+
+// [[Rcpp::export(.roll_kernel_max)]]
+SEXP roll_kernel_max(const SEXP& x, const int& width,
+                     const arma::vec& weights, const int& min_obs,
+                     const bool& complete_obs, const bool& na_restore,
+                     const bool& online) {
+  
+  return roll::roll_kernel_combine<RollMaxKernel>(x, width, weights, min_obs,
+                                                  complete_obs, na_restore, online);
+  
+}